@@ -62,6 +62,14 @@ CollectorConfig parse_collector_config(const nlohmann::json& json) {
         config.sleep_time_us =
             std::chrono::microseconds(collector.at("sleep_time_us").get<long long>());
     }
+    assign_if_present(collector, "wakeup_min_bytes", config.wakeup_min_bytes);
+    if (collector.contains("wakeup_max_wait_us")) {
+        config.wakeup_max_wait_us =
+            std::chrono::microseconds(collector.at("wakeup_max_wait_us").get<long long>());
+    }
+    assign_if_present(collector, "input", config.input);
+    assign_if_present(collector, "board_workers", config.board_workers);
+    assign_if_present(collector, "board_worker_cpus", config.board_worker_cpus);
 
     if (collector.contains("event_builder")) {
         const auto& event_builder = collector.at("event_builder");
@@ -87,11 +95,94 @@ CollectorConfig parse_collector_config(const nlohmann::json& json) {
 
     if (collector.contains("udp_receiver")) {
         const auto& udp_receiver = collector.at("udp_receiver");
+        assign_if_present(udp_receiver, "backend", config.udp_receiver.backend);
+        assign_if_present(udp_receiver, "overflow_policy", config.udp_receiver.overflow_policy);
+        assign_if_present(udp_receiver,
+                          "overflow_block_timeout_ms",
+                          config.udp_receiver.overflow_block_timeout_ms);
         assign_if_present(udp_receiver, "address", config.udp_receiver.address);
         assign_if_present(udp_receiver, "port", config.udp_receiver.port);
+        assign_if_present(udp_receiver, "ports", config.udp_receiver.ports);
+        assign_if_present(udp_receiver, "socket_count", config.udp_receiver.socket_count);
         assign_if_present(udp_receiver, "buffer_size", config.udp_receiver.buffer_size);
         assign_if_present(udp_receiver, "max_packet_size", config.udp_receiver.max_packet_size);
         assign_if_present(udp_receiver, "timeout_sec", config.udp_receiver.timeout_sec);
+        assign_if_present(udp_receiver,
+                          "socket_receive_buffer",
+                          config.udp_receiver.socket_receive_buffer);
+        assign_if_present(udp_receiver,
+                          "socket_receive_buffer_force",
+                          config.udp_receiver.socket_receive_buffer_force);
+        assign_if_present(udp_receiver,
+                          "socket_receive_buffer_autotune",
+                          config.udp_receiver.socket_receive_buffer_autotune);
+        assign_if_present(udp_receiver,
+                          "socket_receive_buffer_max",
+                          config.udp_receiver.socket_receive_buffer_max);
+        assign_if_present(udp_receiver,
+                          "arrival_timestamps",
+                          config.udp_receiver.arrival_timestamps);
+        assign_if_present(udp_receiver,
+                          "datagram_records",
+                          config.udp_receiver.datagram_records);
+        assign_if_present(udp_receiver, "recv_batch_size", config.udp_receiver.recv_batch_size);
+        assign_if_present(udp_receiver, "use_datagram_pool", config.udp_receiver.use_datagram_pool);
+        assign_if_present(udp_receiver,
+                          "datagram_pool_slots",
+                          config.udp_receiver.datagram_pool_slots);
+        assign_if_present(udp_receiver, "interface_name", config.udp_receiver.interface_name);
+        assign_if_present(udp_receiver,
+                          "af_packet_block_size",
+                          config.udp_receiver.af_packet_block_size);
+        assign_if_present(udp_receiver,
+                          "af_packet_block_count",
+                          config.udp_receiver.af_packet_block_count);
+        assign_if_present(udp_receiver,
+                          "af_packet_block_timeout_ms",
+                          config.udp_receiver.af_packet_block_timeout_ms);
+        assign_if_present(udp_receiver,
+                          "io_uring_buffer_count",
+                          config.udp_receiver.io_uring_buffer_count);
+        assign_if_present(udp_receiver, "sequence_width", config.udp_receiver.sequence_width);
+        assign_if_present(udp_receiver, "sequence_offset", config.udp_receiver.sequence_offset);
+        assign_if_present(udp_receiver, "demux", config.udp_receiver.demux);
+        assign_if_present(udp_receiver, "board_id_offset", config.udp_receiver.board_id_offset);
+        assign_if_present(udp_receiver, "board_id_width", config.udp_receiver.board_id_width);
+        assign_if_present(udp_receiver, "max_streams", config.udp_receiver.max_streams);
+        if (udp_receiver.contains("recorder")) {
+            const auto& recorder = udp_receiver.at("recorder");
+            assign_if_present(recorder, "enabled", config.udp_receiver.recorder.enabled);
+            assign_if_present(recorder, "path", config.udp_receiver.recorder.path);
+            assign_if_present(recorder, "file_size", config.udp_receiver.recorder.file_size);
+            assign_if_present(recorder, "staging_size", config.udp_receiver.recorder.staging_size);
+        }
+    }
+
+    if (collector.contains("replay")) {
+        const auto& replay = collector.at("replay");
+        assign_if_present(replay, "path", config.replay.path);
+        assign_if_present(replay, "format", config.replay.format);
+        assign_if_present(replay, "pace", config.replay.pace);
+        assign_if_present(replay, "speed", config.replay.speed);
+        assign_if_present(replay, "loops", config.replay.loops);
+        assign_if_present(replay, "port", config.replay.port);
+        assign_if_present(replay, "batch_size", config.replay.batch_size);
+    }
+
+    if (collector.contains("event_merger")) {
+        const auto& event_merger = collector.at("event_merger");
+        assign_if_present(event_merger, "enabled", config.event_merger.enabled);
+        assign_if_present(event_merger, "match_window", config.event_merger.match_window);
+        assign_if_present(event_merger, "lock_window_us", config.event_merger.lock_window_us);
+        assign_if_present(event_merger, "max_wait_us", config.event_merger.max_wait_us);
+        assign_if_present(event_merger,
+                          "max_pending_events",
+                          config.event_merger.max_pending_events);
+        assign_if_present(event_merger, "offset_gain", config.event_merger.offset_gain);
+        assign_if_present(event_merger, "drift_gain", config.event_merger.drift_gain);
+        assign_if_present(event_merger, "max_drift_ppm", config.event_merger.max_drift_ppm);
+        assign_if_present(event_merger, "max_misses", config.event_merger.max_misses);
+        assign_if_present(event_merger, "channel_stride", config.event_merger.channel_stride);
     }
 
     if (collector.contains("packet_parser")) {
@@ -109,6 +200,17 @@ CollectorConfig parse_collector_config(const nlohmann::json& json) {
         assign_if_present(packet_parser,
                           "check_packet_integrity",
                           config.packet_parser.check_packet_integrity);
+        assign_if_present(packet_parser, "decoder", config.packet_parser.decoder);
+        assign_if_present(packet_parser, "parse_threads", config.packet_parser.parse_threads);
+        assign_if_present(packet_parser,
+                          "parallel_min_bytes",
+                          config.packet_parser.parallel_min_bytes);
+        assign_if_present(packet_parser,
+                          "datagram_aligned",
+                          config.packet_parser.datagram_aligned);
+        assign_if_present(packet_parser,
+                          "resync_confirm_packets",
+                          config.packet_parser.resync_confirm_packets);
         assign_if_present(packet_parser,
                           "constructed_packet_header",
                           config.packet_parser.constructed_packet_header);
@@ -255,7 +357,7 @@ int main(int argc, char** argv) {
         return 0;
     }
 
-    collector.get_receiver().start();
+    collector.get_input_source().start();
 
     for (int i = 0; i < app_config.manual_cycles; ++i) {
         std::this_thread::sleep_for(std::chrono::milliseconds(app_config.manual_sleep_ms));
@@ -282,6 +384,6 @@ int main(int argc, char** argv) {
         collector.clear_events();
     }
 
-    collector.get_receiver().stop();
+    collector.get_input_source().stop();
     return 0;
 }
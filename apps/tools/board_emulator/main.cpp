@@ -0,0 +1,324 @@
+#include <getopt.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nalu_event_collector/emulator/board_emulator.h"
+#include "nalu_event_collector/logging/logging.h"
+
+using nalu_event_collector::BoardEmulator;
+using nalu_event_collector::BoardEmulatorConfig;
+using nalu_event_collector::BoardEmulatorStats;
+using nalu_event_collector::logging::configure;
+
+namespace {
+
+std::atomic<bool> interrupted{false};
+
+void handle_signal(int) {
+    interrupted = true;
+}
+
+void print_help() {
+    std::cout
+        << "Usage: board_emulator [options]\n"
+        << "\nSends synthetic Nalu board traffic over UDP.\n"
+        << "\nDestination:\n"
+        << "  --address ADDR            Destination IPv4 address (default 127.0.0.1)\n"
+        << "  --port PORT               Destination UDP port (default 9000)\n"
+        << "  --boards N                Emulated boards, one thread and socket each (default 1)\n"
+        << "  --board-id ID             Board ID of the first board (default 0)\n"
+        << "\nTraffic:\n"
+        << "  --mode MODE               Trigger mode: ext, imm, self (default ext)\n"
+        << "  --channels LIST           Channel count N (channels 0..N-1) or list like 0,1,5\n"
+        << "  --windows N               Windows per channel and trigger (default 4)\n"
+        << "  --rate HZ                 Triggers per second per board (default 1000)\n"
+        << "  --unpaced                 Send as fast as possible instead of at --rate\n"
+        << "  --count N                 Triggers per board, 0 for unlimited (default 0)\n"
+        << "  --duration S              Stop after S seconds, 0 for unlimited (default 0)\n"
+        << "  --occupancy P             Channel probability per self trigger (default 0.25)\n"
+        << "  --jitter TICKS            Largest per-channel self-trigger offset (default 100)\n"
+        << "  --packets-per-datagram N  Packets per datagram (default 13)\n"
+        << "  --batch N                 Datagrams per sendmmsg call (default 32)\n"
+        << "\nClock and header:\n"
+        << "  --clock-frequency HZ      Board clock (default 23843000)\n"
+        << "  --max-trigger-time T      Trigger-time modulus (default 16777216)\n"
+        << "  --start-trigger-time T    First trigger time, to exercise wraparound (default 0)\n"
+        << "  --sequence-width W        Sequence counter bytes, 0 to omit (default 2)\n"
+        << "  --sequence-offset O       Sequence counter offset (default 2)\n"
+        << "  --board-id-width W        Board ID bytes, 0 to omit (default 1)\n"
+        << "  --board-id-offset O       Board ID offset (default 4)\n"
+        << "\nFaults:\n"
+        << "  --loss P                  Datagram loss probability\n"
+        << "  --reorder P               Datagram reorder probability\n"
+        << "  --reorder-distance N      Datagrams that overtake a reordered one (default 1)\n"
+        << "  --corrupt P               Per-packet start/stop marker corruption probability\n"
+        << "  --seed N                  Random seed of the first board (default 1)\n"
+        << "\n  --log-level LEVEL         Logging level (default info)\n"
+        << "  --help                    Show this help message\n";
+}
+
+std::vector<int> parse_channels(const std::string& text) {
+    std::vector<int> channels;
+    if (text.find(',') == std::string::npos) {
+        const int count = std::stoi(text);
+        for (int channel = 0; channel < count; ++channel) {
+            channels.push_back(channel);
+        }
+        return channels;
+    }
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        channels.push_back(std::stoi(item));
+    }
+    return channels;
+}
+
+void print_stats(uint32_t board_id, const BoardEmulatorStats& stats) {
+    const double elapsed = stats.elapsed_s > 0.0 ? stats.elapsed_s : 1.0;
+    std::cout << "Board " << board_id << ": " << stats.traffic.triggers << " triggers, "
+              << stats.traffic.packets << " packets, " << stats.sent_datagrams
+              << " datagrams sent (" << std::fixed << std::setprecision(1)
+              << stats.sent_datagrams / elapsed << " dgram/s, "
+              << stats.sent_bytes * 8.0 / elapsed / 1e6 << " Mbit/s)\n"
+              << "  faults: " << stats.traffic.lost_datagrams << " lost, "
+              << stats.traffic.reordered_datagrams << " reordered, "
+              << stats.traffic.corrupted_markers << " corrupted markers, "
+              << stats.traffic.trigger_time_wraps << " trigger-time wraps, "
+              << stats.send_errors << " send errors\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    BoardEmulatorConfig config;
+    size_t boards = 1;
+    double duration_s = 0.0;
+    std::string logging_level = "info";
+
+    enum Option {
+        kAddress = 256,
+        kPort,
+        kBoards,
+        kBoardId,
+        kMode,
+        kChannels,
+        kWindows,
+        kRate,
+        kUnpaced,
+        kCount,
+        kDuration,
+        kOccupancy,
+        kJitter,
+        kPacketsPerDatagram,
+        kBatch,
+        kClockFrequency,
+        kMaxTriggerTime,
+        kStartTriggerTime,
+        kSequenceWidth,
+        kSequenceOffset,
+        kBoardIdWidth,
+        kBoardIdOffset,
+        kLoss,
+        kReorder,
+        kReorderDistance,
+        kCorrupt,
+        kSeed,
+        kLogLevel,
+    };
+
+    try {
+        while (true) {
+            static option long_options[] = {
+                {"address", required_argument, nullptr, kAddress},
+                {"port", required_argument, nullptr, kPort},
+                {"boards", required_argument, nullptr, kBoards},
+                {"board-id", required_argument, nullptr, kBoardId},
+                {"mode", required_argument, nullptr, kMode},
+                {"channels", required_argument, nullptr, kChannels},
+                {"windows", required_argument, nullptr, kWindows},
+                {"rate", required_argument, nullptr, kRate},
+                {"unpaced", no_argument, nullptr, kUnpaced},
+                {"count", required_argument, nullptr, kCount},
+                {"duration", required_argument, nullptr, kDuration},
+                {"occupancy", required_argument, nullptr, kOccupancy},
+                {"jitter", required_argument, nullptr, kJitter},
+                {"packets-per-datagram", required_argument, nullptr, kPacketsPerDatagram},
+                {"batch", required_argument, nullptr, kBatch},
+                {"clock-frequency", required_argument, nullptr, kClockFrequency},
+                {"max-trigger-time", required_argument, nullptr, kMaxTriggerTime},
+                {"start-trigger-time", required_argument, nullptr, kStartTriggerTime},
+                {"sequence-width", required_argument, nullptr, kSequenceWidth},
+                {"sequence-offset", required_argument, nullptr, kSequenceOffset},
+                {"board-id-width", required_argument, nullptr, kBoardIdWidth},
+                {"board-id-offset", required_argument, nullptr, kBoardIdOffset},
+                {"loss", required_argument, nullptr, kLoss},
+                {"reorder", required_argument, nullptr, kReorder},
+                {"reorder-distance", required_argument, nullptr, kReorderDistance},
+                {"corrupt", required_argument, nullptr, kCorrupt},
+                {"seed", required_argument, nullptr, kSeed},
+                {"log-level", required_argument, nullptr, kLogLevel},
+                {"help", no_argument, nullptr, 'h'},
+                {nullptr, 0, nullptr, 0}};
+            const int option = getopt_long(argc, argv, "h", long_options, nullptr);
+            if (option == -1) {
+                break;
+            }
+
+            switch (option) {
+                case kAddress:
+                    config.address = optarg;
+                    break;
+                case kPort:
+                    config.port = static_cast<uint16_t>(std::stoul(optarg));
+                    break;
+                case kBoards:
+                    boards = std::stoul(optarg);
+                    break;
+                case kBoardId:
+                    config.board_id = static_cast<uint32_t>(std::stoul(optarg));
+                    break;
+                case kMode:
+                    config.trigger_mode = optarg;
+                    break;
+                case kChannels:
+                    config.channels = parse_channels(optarg);
+                    break;
+                case kWindows:
+                    config.windows = std::stoi(optarg);
+                    break;
+                case kRate:
+                    config.event_rate = std::stod(optarg);
+                    break;
+                case kUnpaced:
+                    config.paced = false;
+                    break;
+                case kCount:
+                    config.event_count = std::stoull(optarg);
+                    break;
+                case kDuration:
+                    duration_s = std::stod(optarg);
+                    break;
+                case kOccupancy:
+                    config.self_trigger_occupancy = std::stod(optarg);
+                    break;
+                case kJitter:
+                    config.self_trigger_jitter = static_cast<uint32_t>(std::stoul(optarg));
+                    break;
+                case kPacketsPerDatagram:
+                    config.packets_per_datagram = std::stoul(optarg);
+                    break;
+                case kBatch:
+                    config.send_batch_size = std::stoul(optarg);
+                    break;
+                case kClockFrequency:
+                    config.clock_frequency = static_cast<uint32_t>(std::stoul(optarg));
+                    break;
+                case kMaxTriggerTime:
+                    config.max_trigger_time = static_cast<uint32_t>(std::stoul(optarg));
+                    break;
+                case kStartTriggerTime:
+                    config.start_trigger_time = static_cast<uint32_t>(std::stoul(optarg));
+                    break;
+                case kSequenceWidth:
+                    config.sequence_width = std::stoul(optarg);
+                    break;
+                case kSequenceOffset:
+                    config.sequence_offset = std::stoul(optarg);
+                    break;
+                case kBoardIdWidth:
+                    config.board_id_width = std::stoul(optarg);
+                    break;
+                case kBoardIdOffset:
+                    config.board_id_offset = std::stoul(optarg);
+                    break;
+                case kLoss:
+                    config.loss_rate = std::stod(optarg);
+                    break;
+                case kReorder:
+                    config.reorder_rate = std::stod(optarg);
+                    break;
+                case kReorderDistance:
+                    config.reorder_distance = std::stoul(optarg);
+                    break;
+                case kCorrupt:
+                    config.corrupt_marker_rate = std::stod(optarg);
+                    break;
+                case kSeed:
+                    config.seed = std::stoull(optarg);
+                    break;
+                case kLogLevel:
+                    logging_level = optarg;
+                    break;
+                case 'h':
+                    print_help();
+                    return 0;
+                default:
+                    print_help();
+                    return 1;
+            }
+        }
+    } catch (const std::exception& error) {
+        std::cerr << "Invalid option value: " << error.what() << "\n";
+        return 1;
+    }
+
+    configure(logging_level);
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    std::vector<std::unique_ptr<BoardEmulator>> emulators;
+    std::vector<uint32_t> board_ids;
+    try {
+        for (size_t i = 0; i < boards; ++i) {
+            BoardEmulatorConfig board_config = config;
+            board_config.board_id = config.board_id + static_cast<uint32_t>(i);
+            board_config.seed = config.seed + i;
+            emulators.push_back(std::make_unique<BoardEmulator>(board_config));
+            board_ids.push_back(board_config.board_id);
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
+
+    std::atomic<size_t> finished{0};
+    std::vector<std::thread> threads;
+    for (auto& emulator : emulators) {
+        threads.emplace_back([&emulator, &finished] {
+            emulator->run();
+            ++finished;
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    while (!interrupted && finished < emulators.size()) {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (duration_s > 0.0 && elapsed.count() >= duration_s) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    for (auto& emulator : emulators) {
+        emulator->stop();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < emulators.size(); ++i) {
+        print_stats(board_ids[i], emulators[i]->stats());
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+#!/bin/bash
+
+set -euo pipefail
+
+SCRIPT_DIR=$(dirname "$(realpath "$0")")
+APP_DIR=$(realpath "$SCRIPT_DIR/..")
+EXECUTABLE="$APP_DIR/build/bin/board_emulator"
+DEBUG=false
+APP_ARGS=()
+
+print_help() {
+    cat <<EOT
+Usage: ./apps/tools/board_emulator/scripts/run.sh [options] [board_emulator options]
+
+Run the board_emulator tool. Every option other than the ones below is
+passed through; see ./apps/tools/board_emulator/scripts/run.sh --usage.
+
+Options:
+  --debug           Run under gdb
+  --usage           Show the board_emulator options
+  -h, --help        Show this help message
+
+Build first with:
+  ./apps/tools/board_emulator/scripts/build.sh
+EOT
+}
+
+while [[ "$#" -gt 0 ]]; do
+    case $1 in
+        --debug) DEBUG=true; shift ;;
+        --usage) APP_ARGS+=("--help"); shift ;;
+        -h|--help) print_help; exit 0 ;;
+        *) APP_ARGS+=("$1"); shift ;;
+    esac
+done
+
+if [ ! -f "$EXECUTABLE" ]; then
+    echo "Executable not found: $EXECUTABLE" >&2
+    echo "Build it with ./apps/tools/board_emulator/scripts/build.sh." >&2
+    exit 1
+fi
+
+if [ "$DEBUG" = true ]; then
+    exec gdb --args "$EXECUTABLE" "${APP_ARGS[@]}"
+else
+    exec "$EXECUTABLE" "${APP_ARGS[@]}"
+fi
@@ -0,0 +1,509 @@
+/**
+ * @file loopback_throughput.cpp
+ * @brief End-to-end saturation benchmark: emulated boards feeding a Collector over loopback.
+ *
+ * Every rate step starts a fresh Collector, drives it with one BoardEmulator
+ * per board at a fixed trigger rate, and consumes the built events like a
+ * host application would. The step reports sustained throughput, event rate,
+ * CPU time per stage, and datagram loss; the first step whose loss exceeds
+ * the threshold marks the saturation point.
+ */
+
+#include <getopt.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nalu_event_collector/collector/collector.h"
+#include "nalu_event_collector/emulator/board_emulator.h"
+#include "nalu_event_collector/logging/logging.h"
+
+using nalu_event_collector::BoardEmulator;
+using nalu_event_collector::BoardEmulatorConfig;
+using nalu_event_collector::Collector;
+using nalu_event_collector::CollectorConfig;
+using nalu_event_collector::CollectorTimingData;
+using nalu_event_collector::Event;
+using nalu_event_collector::UdpShardStats;
+using nalu_event_collector::kTransportHeaderSize;
+using nalu_event_collector::kWirePacketSize;
+using nalu_event_collector::logging::configure;
+
+namespace {
+
+struct Options {
+    uint16_t port = 9100;
+    std::vector<double> rates = {500, 1000, 2000, 5000, 10000, 20000, 50000, 100000};
+    double step_duration_s = 5.0;
+    int drain_ms = 500;
+    size_t boards = 1;
+    int channels = 32;
+    int windows = 4;
+    size_t packets_per_datagram = 13;
+    double loss_threshold = 0.001;
+    size_t lossy_steps = 2;
+    std::string backend = "socket";
+    size_t socket_count = 1;
+    bool use_datagram_pool = false;
+    size_t socket_receive_buffer = 0;
+    size_t buffer_size = 4 * 1024 * 1024;
+    bool board_workers = false;
+    std::string output;
+    std::string logging_level = "warn";
+};
+
+struct StepResult {
+    double rate = 0.0;
+    double elapsed_s = 0.0;
+    uint64_t sent_datagrams = 0;
+    uint64_t received_datagrams = 0;
+    uint64_t lost_datagrams = 0;
+    double loss_fraction = 0.0;
+    double offered_mb_s = 0.0;
+    double processed_mb_s = 0.0;
+    double packets_s = 0.0;
+    double events_s = 0.0;
+    double receive_cpu_s = 0.0;
+    double drain_cpu_s = 0.0;
+    double parse_cpu_s = 0.0;
+    double build_cpu_s = 0.0;
+    double consumer_cpu_s = 0.0;
+    double sender_cpu_s = 0.0;
+};
+
+void print_help() {
+    std::cout
+        << "Usage: loopback_throughput [options]\n"
+        << "\nDrives a Collector over loopback at stepped trigger rates and reports the\n"
+        << "saturation curve.\n"
+        << "\nOptions:\n"
+        << "  --rates LIST            Triggers/s per board, comma separated\n"
+        << "                          (default 500,1000,2000,5000,10000,20000,50000,100000)\n"
+        << "  --step-duration S       Sending time per step (default 5)\n"
+        << "  --drain-ms MS           Collection time after sending stops (default 500)\n"
+        << "  --boards N              Emulated boards; >1 demultiplexes by board ID (default 1)\n"
+        << "  --channels N            Channels per board (default 32)\n"
+        << "  --windows N             Windows per channel (default 4)\n"
+        << "  --packets-per-datagram N  Packets per datagram (default 13)\n"
+        << "  --loss-threshold F      Loss fraction that counts as saturated (default 0.001)\n"
+        << "  --lossy-steps N         Stop after N saturated steps, 0 runs all (default 2)\n"
+        << "  --port PORT             Loopback UDP port (default 9100)\n"
+        << "  --backend NAME          Receive backend (default socket)\n"
+        << "  --sockets N             Receive sockets / shards (default 1)\n"
+        << "  --pool                  Use the datagram pool\n"
+        << "  --rcvbuf BYTES          Socket receive buffer request (default: system)\n"
+        << "  --buffer-size BYTES     Receive ring per shard or board (default 4 MiB)\n"
+        << "  --board-workers         One collection thread per board\n"
+        << "  --output PATH           Write the results as JSON\n"
+        << "  --log-level LEVEL       Logging level (default warn)\n"
+        << "  --help                  Show this help message\n";
+}
+
+std::vector<double> parse_rates(const std::string& text) {
+    std::vector<double> rates;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        rates.push_back(std::stod(item));
+    }
+    return rates;
+}
+
+double process_cpu_s() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+double thread_cpu_s() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+std::vector<int> channel_list(const Options& options) {
+    std::vector<int> channels;
+    for (int channel = 0; channel < options.channels; ++channel) {
+        channels.push_back(channel);
+    }
+    return channels;
+}
+
+CollectorConfig make_collector_config(const Options& options, double rate) {
+    CollectorConfig config;
+    config.udp_receiver.backend = options.backend;
+    config.udp_receiver.port = options.port;
+    config.udp_receiver.socket_count = options.socket_count;
+    config.udp_receiver.use_datagram_pool = options.use_datagram_pool;
+    config.udp_receiver.socket_receive_buffer = options.socket_receive_buffer;
+    // Every Event reserves room for 65535 packets, so a large backlog drained
+    // in one cycle costs gigabytes; a small ring keeps overload steps bounded.
+    config.udp_receiver.buffer_size = options.buffer_size;
+    config.udp_receiver.timeout_sec = 1;
+    config.udp_receiver.max_packet_size =
+        kTransportHeaderSize + options.packets_per_datagram * kWirePacketSize;
+    config.udp_receiver.sequence_width = 2;
+    if (options.boards > 1) {
+        config.udp_receiver.demux = "board_id";
+        config.board_workers = options.board_workers;
+    }
+    config.event_builder.channels = channel_list(options);
+    config.event_builder.windows = options.windows;
+    config.event_builder.trigger_type = "ext";
+    // Consecutive triggers must stay further apart than the matching window.
+    const double trigger_spacing = config.event_builder.clock_frequency / rate;
+    config.event_builder.time_threshold = static_cast<uint32_t>(
+        std::min<double>(config.event_builder.time_threshold, trigger_spacing / 2));
+    return config;
+}
+
+size_t consume(Collector& collector) {
+    const size_t events = collector.get_data().second.size();
+    collector.clear_events();
+    return events;
+}
+
+StepResult run_step(const Options& options, double rate) {
+    Collector collector(make_collector_config(options, rate));
+    collector.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::vector<std::unique_ptr<BoardEmulator>> emulators;
+    for (size_t board = 0; board < options.boards; ++board) {
+        BoardEmulatorConfig config;
+        config.port = options.port;
+        config.board_id = static_cast<uint32_t>(board);
+        config.seed = board + 1;
+        config.channels = channel_list(options);
+        config.windows = options.windows;
+        config.packets_per_datagram = options.packets_per_datagram;
+        config.event_rate = rate;
+        config.event_count = static_cast<uint64_t>(rate * options.step_duration_s);
+        emulators.push_back(std::make_unique<BoardEmulator>(config));
+    }
+
+    const CollectorTimingData timing_before = collector.get_timing_data();
+    const double process_before = process_cpu_s();
+    const double consumer_before = thread_cpu_s();
+    const auto start = std::chrono::steady_clock::now();
+
+    std::atomic<size_t> finished{0};
+    std::vector<double> sender_cpu(emulators.size(), 0.0);
+    std::vector<std::thread> senders;
+    for (size_t board = 0; board < emulators.size(); ++board) {
+        senders.emplace_back([&, board] {
+            const double cpu_before = thread_cpu_s();
+            emulators[board]->run();
+            sender_cpu[board] = thread_cpu_s() - cpu_before;
+            ++finished;
+        });
+    }
+
+    size_t events = 0;
+    while (finished < emulators.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        events += consume(collector);
+    }
+    const auto sent = std::chrono::steady_clock::now();
+    for (auto& sender : senders) {
+        sender.join();
+    }
+    while (std::chrono::steady_clock::now() - sent < std::chrono::milliseconds(options.drain_ms)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        events += consume(collector);
+    }
+
+    const double consumer_cpu = thread_cpu_s() - consumer_before;
+    const double process_cpu = process_cpu_s() - process_before;
+    const CollectorTimingData timing = collector.get_timing_data();
+    collector.stop();
+    events += consume(collector);
+
+    StepResult result;
+    result.rate = rate;
+    result.elapsed_s = std::chrono::duration<double>(sent - start).count();
+    for (const auto& emulator : emulators) {
+        result.sent_datagrams += emulator->stats().sent_datagrams;
+        result.offered_mb_s += emulator->stats().sent_bytes;
+    }
+    uint64_t dropped = 0;
+    for (const UdpShardStats& shard : collector.get_shard_stats()) {
+        result.received_datagrams += shard.datagrams;
+        dropped += shard.dropped_datagrams;
+    }
+    const uint64_t received = std::min(result.sent_datagrams, result.received_datagrams);
+    result.lost_datagrams = result.sent_datagrams - received + dropped;
+    result.loss_fraction = result.sent_datagrams == 0
+                               ? 0.0
+                               : static_cast<double>(result.lost_datagrams) / result.sent_datagrams;
+
+    const double processed = static_cast<double>(timing.cumulative_data_processed -
+                                                 timing_before.cumulative_data_processed);
+    result.offered_mb_s /= result.elapsed_s * 1e6;
+    result.processed_mb_s = processed / result.elapsed_s / 1e6;
+    result.packets_s = processed / kWirePacketSize / result.elapsed_s;
+    result.events_s = events / result.elapsed_s;
+
+    result.drain_cpu_s = timing.cumulative_udp_time - timing_before.cumulative_udp_time;
+    result.parse_cpu_s = timing.cumulative_parse_time - timing_before.cumulative_parse_time;
+    result.build_cpu_s = timing.cumulative_event_time - timing_before.cumulative_event_time;
+    result.consumer_cpu_s = consumer_cpu;
+    for (double cpu : sender_cpu) {
+        result.sender_cpu_s += cpu;
+    }
+    // Whatever the process spent outside the senders, the consumer, and the
+    // timed collection stages went to the receive threads.
+    result.receive_cpu_s = std::max(0.0,
+                                    process_cpu - result.sender_cpu_s - consumer_cpu -
+                                        result.drain_cpu_s - result.parse_cpu_s -
+                                        result.build_cpu_s);
+    return result;
+}
+
+void print_header() {
+    std::cout << std::setw(10) << "trig/s" << std::setw(10) << "MB/s in" << std::setw(10)
+              << "MB/s out" << std::setw(12) << "packets/s" << std::setw(10) << "events/s"
+              << std::setw(9) << "loss %" << "   cpu % recv/drain/parse/build/consumer/send\n";
+}
+
+void print_step(const StepResult& step) {
+    const auto percent = [&](double cpu) { return 100.0 * cpu / step.elapsed_s; };
+    std::cout << std::fixed << std::setprecision(1) << std::setw(10) << step.rate << std::setw(10)
+              << step.offered_mb_s << std::setw(10) << step.processed_mb_s << std::setw(12)
+              << std::setprecision(0) << step.packets_s << std::setw(10) << step.events_s
+              << std::setw(9) << std::setprecision(3) << 100.0 * step.loss_fraction << "   "
+              << std::setprecision(0) << percent(step.receive_cpu_s) << "/"
+              << percent(step.drain_cpu_s) << "/" << percent(step.parse_cpu_s) << "/"
+              << percent(step.build_cpu_s) << "/" << percent(step.consumer_cpu_s) << "/"
+              << percent(step.sender_cpu_s) << std::endl;
+}
+
+void write_json(const std::string& path,
+                const Options& options,
+                const std::vector<StepResult>& steps,
+                const StepResult* saturation) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+
+    out << std::setprecision(6) << "{\n"
+        << "  \"host\": \"" << host << "\",\n"
+        << "  \"cpus\": " << std::thread::hardware_concurrency() << ",\n"
+        << "  \"boards\": " << options.boards << ",\n"
+        << "  \"channels\": " << options.channels << ",\n"
+        << "  \"windows\": " << options.windows << ",\n"
+        << "  \"packets_per_datagram\": " << options.packets_per_datagram << ",\n"
+        << "  \"backend\": \"" << options.backend << "\",\n"
+        << "  \"sockets\": " << options.socket_count << ",\n"
+        << "  \"datagram_pool\": " << (options.use_datagram_pool ? "true" : "false") << ",\n"
+        << "  \"buffer_size\": " << options.buffer_size << ",\n"
+        << "  \"step_duration_s\": " << options.step_duration_s << ",\n"
+        << "  \"loss_threshold\": " << options.loss_threshold << ",\n"
+        << "  \"saturation_rate\": ";
+    if (saturation != nullptr) {
+        out << saturation->rate;
+    } else {
+        out << "null";
+    }
+    out << ",\n  \"steps\": [\n";
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const StepResult& step = steps[i];
+        out << "    {\"rate\": " << step.rate << ", \"elapsed_s\": " << step.elapsed_s
+            << ", \"sent_datagrams\": " << step.sent_datagrams
+            << ", \"received_datagrams\": " << step.received_datagrams
+            << ", \"lost_datagrams\": " << step.lost_datagrams
+            << ", \"loss_fraction\": " << step.loss_fraction
+            << ", \"offered_mb_s\": " << step.offered_mb_s
+            << ", \"processed_mb_s\": " << step.processed_mb_s
+            << ", \"packets_s\": " << step.packets_s << ", \"events_s\": " << step.events_s
+            << ", \"cpu_s\": {\"receive\": " << step.receive_cpu_s
+            << ", \"drain\": " << step.drain_cpu_s << ", \"parse\": " << step.parse_cpu_s
+            << ", \"build\": " << step.build_cpu_s << ", \"consumer\": " << step.consumer_cpu_s
+            << ", \"sender\": " << step.sender_cpu_s << "}}"
+            << (i + 1 < steps.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+
+    enum Option {
+        kRates = 256,
+        kStepDuration,
+        kDrainMs,
+        kBoards,
+        kChannels,
+        kWindows,
+        kPacketsPerDatagram,
+        kLossThreshold,
+        kLossySteps,
+        kPort,
+        kBackend,
+        kSockets,
+        kPool,
+        kRcvbuf,
+        kBufferSize,
+        kBoardWorkers,
+        kOutput,
+        kLogLevel,
+    };
+
+    try {
+        while (true) {
+            static option long_options[] = {
+                {"rates", required_argument, nullptr, kRates},
+                {"step-duration", required_argument, nullptr, kStepDuration},
+                {"drain-ms", required_argument, nullptr, kDrainMs},
+                {"boards", required_argument, nullptr, kBoards},
+                {"channels", required_argument, nullptr, kChannels},
+                {"windows", required_argument, nullptr, kWindows},
+                {"packets-per-datagram", required_argument, nullptr, kPacketsPerDatagram},
+                {"loss-threshold", required_argument, nullptr, kLossThreshold},
+                {"lossy-steps", required_argument, nullptr, kLossySteps},
+                {"port", required_argument, nullptr, kPort},
+                {"backend", required_argument, nullptr, kBackend},
+                {"sockets", required_argument, nullptr, kSockets},
+                {"pool", no_argument, nullptr, kPool},
+                {"rcvbuf", required_argument, nullptr, kRcvbuf},
+                {"buffer-size", required_argument, nullptr, kBufferSize},
+                {"board-workers", no_argument, nullptr, kBoardWorkers},
+                {"output", required_argument, nullptr, kOutput},
+                {"log-level", required_argument, nullptr, kLogLevel},
+                {"help", no_argument, nullptr, 'h'},
+                {nullptr, 0, nullptr, 0}};
+            const int option = getopt_long(argc, argv, "h", long_options, nullptr);
+            if (option == -1) {
+                break;
+            }
+
+            switch (option) {
+                case kRates:
+                    options.rates = parse_rates(optarg);
+                    break;
+                case kStepDuration:
+                    options.step_duration_s = std::stod(optarg);
+                    break;
+                case kDrainMs:
+                    options.drain_ms = std::stoi(optarg);
+                    break;
+                case kBoards:
+                    options.boards = std::stoul(optarg);
+                    break;
+                case kChannels:
+                    options.channels = std::stoi(optarg);
+                    break;
+                case kWindows:
+                    options.windows = std::stoi(optarg);
+                    break;
+                case kPacketsPerDatagram:
+                    options.packets_per_datagram = std::stoul(optarg);
+                    break;
+                case kLossThreshold:
+                    options.loss_threshold = std::stod(optarg);
+                    break;
+                case kLossySteps:
+                    options.lossy_steps = std::stoul(optarg);
+                    break;
+                case kPort:
+                    options.port = static_cast<uint16_t>(std::stoul(optarg));
+                    break;
+                case kBackend:
+                    options.backend = optarg;
+                    break;
+                case kSockets:
+                    options.socket_count = std::stoul(optarg);
+                    break;
+                case kPool:
+                    options.use_datagram_pool = true;
+                    break;
+                case kRcvbuf:
+                    options.socket_receive_buffer = std::stoul(optarg);
+                    break;
+                case kBufferSize:
+                    options.buffer_size = std::stoul(optarg);
+                    break;
+                case kBoardWorkers:
+                    options.board_workers = true;
+                    break;
+                case kOutput:
+                    options.output = optarg;
+                    break;
+                case kLogLevel:
+                    options.logging_level = optarg;
+                    break;
+                case 'h':
+                    print_help();
+                    return 0;
+                default:
+                    print_help();
+                    return 1;
+            }
+        }
+    } catch (const std::exception& error) {
+        std::cerr << "Invalid option value: " << error.what() << "\n";
+        return 1;
+    }
+
+    configure(options.logging_level);
+
+    std::vector<StepResult> steps;
+    const StepResult* saturation = nullptr;
+    size_t lossy = 0;
+    try {
+        print_header();
+        for (double rate : options.rates) {
+            steps.push_back(run_step(options, rate));
+            print_step(steps.back());
+            if (steps.back().loss_fraction > options.loss_threshold) {
+                ++lossy;
+                if (options.lossy_steps != 0 && lossy >= options.lossy_steps) {
+                    break;
+                }
+            }
+        }
+        for (const StepResult& step : steps) {
+            if (step.loss_fraction > options.loss_threshold) {
+                saturation = &step;
+                break;
+            }
+        }
+
+        if (saturation != nullptr) {
+            std::cout << "Datagrams start being lost at " << std::setprecision(0)
+                      << saturation->rate << " triggers/s per board ("
+                      << std::setprecision(1) << saturation->offered_mb_s << " MB/s offered)\n";
+        } else {
+            std::cout << "No step lost more than " << std::setprecision(3)
+                      << 100.0 * options.loss_threshold << " % of its datagrams\n";
+        }
+        if (!options.output.empty()) {
+            write_json(options.output, options, steps, saturation);
+            std::cout << "Results written to " << options.output << "\n";
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file benchmark_data.h
+ * @brief Synthetic inputs shared by the microbenchmarks.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "nalu_event_collector/data/packet.h"
+#include "nalu_event_collector/emulator/traffic_generator.h"
+#include "nalu_event_collector/parsing/packet_parser.h"
+
+namespace nalu_event_collector::benchmarks {
+
+/** @brief Channels per trigger in the generated traffic (the collector default). */
+constexpr int kBenchmarkChannels = 32;
+
+/** @brief Windows per channel in the generated traffic. */
+constexpr int kBenchmarkWindows = 4;
+
+/** @brief Emulator settings for @p triggers external triggers at 1 kHz. */
+inline BoardEmulatorConfig benchmark_traffic(size_t triggers, double corrupt_marker_rate = 0.0) {
+    BoardEmulatorConfig config;
+    config.channels.clear();
+    for (int channel = 0; channel < kBenchmarkChannels; ++channel) {
+        config.channels.push_back(channel);
+    }
+    config.windows = kBenchmarkWindows;
+    config.event_count = triggers;
+    config.corrupt_marker_rate = corrupt_marker_rate;
+    return config;
+}
+
+/**
+ * @brief Concatenated datagram payloads (transport headers removed) of @p triggers triggers.
+ *
+ * When @p marks is given, the end offset of every datagram is appended to it.
+ */
+inline std::vector<uint8_t> make_payload_stream(size_t triggers,
+                                                double corrupt_marker_rate = 0.0,
+                                                std::vector<ArrivalMark>* marks = nullptr) {
+    TrafficGenerator generator(benchmark_traffic(triggers, corrupt_marker_rate));
+    std::vector<std::vector<uint8_t>> datagrams;
+    std::vector<uint8_t> stream;
+    for (size_t trigger = 0; trigger < triggers; ++trigger) {
+        const size_t count = generator.next_trigger(datagrams);
+        for (size_t i = 0; i < count; ++i) {
+            stream.insert(stream.end(),
+                          datagrams[i].begin() + kTransportHeaderSize,
+                          datagrams[i].end());
+            if (marks != nullptr) {
+                marks->push_back({stream.size(), 0});
+            }
+        }
+    }
+    return stream;
+}
+
+/**
+ * @brief Decoded packets of @p triggers triggers.
+ *
+ * With @p interleave > 1 the packets of each group of @p interleave
+ * consecutive triggers arrive round-robin, so matching a packet to its event
+ * has to look past the newest one.
+ */
+inline std::vector<Packet> make_packets(size_t triggers, size_t interleave = 1) {
+    const std::vector<uint8_t> stream = make_payload_stream(triggers);
+    std::vector<Packet> ordered;
+    PacketParser().process_stream(stream.data(), stream.size(), ordered);
+    if (interleave <= 1) {
+        return ordered;
+    }
+
+    const size_t per_trigger = static_cast<size_t>(kBenchmarkChannels * kBenchmarkWindows);
+    std::vector<Packet> packets;
+    packets.reserve(ordered.size());
+    for (size_t group = 0; group < triggers; group += interleave) {
+        const size_t group_size = std::min(interleave, triggers - group);
+        for (size_t k = 0; k < per_trigger; ++k) {
+            for (size_t t = 0; t < group_size; ++t) {
+                packets.push_back(ordered[(group + t) * per_trigger + k]);
+            }
+        }
+    }
+    return packets;
+}
+
+}  // namespace nalu_event_collector::benchmarks
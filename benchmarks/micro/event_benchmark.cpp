@@ -0,0 +1,70 @@
+/**
+ * @file event_benchmark.cpp
+ * @brief Microbenchmarks of Event construction and serialization.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "benchmark_data.h"
+#include "nalu_event_collector/config/event_builder_config.h"
+#include "nalu_event_collector/data/event.h"
+
+namespace nalu_event_collector::benchmarks {
+
+namespace {
+
+constexpr uint16_t kPacketsPerTrigger = kBenchmarkChannels * kBenchmarkWindows;
+
+std::unique_ptr<Event> make_event(uint16_t max_packets) {
+    const EventBuilderConfig config;
+    return std::make_unique<Event>(config.event_header,
+                                   0x10,
+                                   0,
+                                   0,
+                                   config.time_threshold,
+                                   config.clock_frequency,
+                                   config.event_completion_time_us,
+                                   0,
+                                   0,
+                                   config.event_trailer,
+                                   max_packets,
+                                   0xFFFFFFFFull,
+                                   static_cast<uint8_t>(kBenchmarkWindows),
+                                   false,
+                                   kPacketsPerTrigger,
+                                   false);
+}
+
+// Arg: packet capacity; EventBuffer creates every event with 65535.
+void BM_EventConstruct(benchmark::State& state) {
+    const uint16_t max_packets = static_cast<uint16_t>(state.range(0));
+    for (auto _ : state) {
+        std::unique_ptr<Event> event = make_event(max_packets);
+        benchmark::DoNotOptimize(event.get());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_EventConstruct)->ArgName("max_packets")->Arg(kPacketsPerTrigger)->Arg(65535);
+
+void BM_EventSerialize(benchmark::State& state) {
+    const std::vector<Packet> packets = make_packets(1);
+    std::unique_ptr<Event> event = make_event(kPacketsPerTrigger);
+    for (const Packet& packet : packets) {
+        event->add_packet(packet);
+    }
+    std::vector<char> buffer(event->get_size());
+    for (auto _ : state) {
+        event->serialize_to_buffer(buffer.data());
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+BENCHMARK(BM_EventSerialize);
+
+}  // namespace
+
+}  // namespace nalu_event_collector::benchmarks
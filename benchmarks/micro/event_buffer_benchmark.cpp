@@ -0,0 +1,78 @@
+/**
+ * @file event_buffer_benchmark.cpp
+ * @brief Microbenchmarks of EventBuffer::add_packet at different lookback depths.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "benchmark_data.h"
+#include "nalu_event_collector/collector/event_buffer.h"
+#include "nalu_event_collector/config/event_builder_config.h"
+#include "nalu_event_collector/timing/time_difference_calculator.h"
+
+namespace nalu_event_collector::benchmarks {
+
+namespace {
+
+// Every Event reserves room for 65535 packets, so batches stay small.
+constexpr size_t kTriggers = 16;
+
+// Args: max_lookback, interleave (consecutive triggers whose packets arrive round-robin).
+void BM_EventBufferAddPacket(benchmark::State& state) {
+    const size_t max_lookback = static_cast<size_t>(state.range(0));
+    const std::vector<Packet> packets =
+        make_packets(kTriggers, static_cast<size_t>(state.range(1)));
+
+    const EventBuilderConfig config = [] {
+        EventBuilderConfig defaults;
+        defaults.channels = benchmark_traffic(0).channels;
+        defaults.windows = kBenchmarkWindows;
+        return defaults;
+    }();
+    TimeDifferenceCalculator time_diff(config.max_trigger_time, config.time_threshold);
+    EventBuffer buffer(config.max_events_in_buffer,
+                       time_diff,
+                       max_lookback,
+                       config.channels,
+                       static_cast<uint8_t>(config.windows),
+                       config.event_header,
+                       config.event_trailer,
+                       config.trigger_type,
+                       config.wlc_mode,
+                       config.time_threshold,
+                       config.clock_frequency,
+                       config.event_completion_time_us);
+
+    size_t events = 0;
+    for (auto _ : state) {
+        bool in_safety_buffer_zone = true;
+        uint32_t event_index = 0;
+        for (const Packet& packet : packets) {
+            buffer.add_packet(packet, in_safety_buffer_zone, event_index);
+        }
+        events += event_index;
+
+        state.PauseTiming();
+        buffer.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * packets.size()));
+    state.counters["events_per_trigger"] =
+        static_cast<double>(events) / (state.iterations() * kTriggers);
+}
+// Interleaving deeper than the lookback would open one event per packet.
+BENCHMARK(BM_EventBufferAddPacket)
+    ->ArgNames({"lookback", "interleave"})
+    ->Args({1, 1})
+    ->Args({2, 1})
+    ->Args({2, 2})
+    ->Args({8, 1})
+    ->Args({8, 8})
+    ->Args({32, 1})
+    ->Args({32, 8});
+
+}  // namespace
+
+}  // namespace nalu_event_collector::benchmarks
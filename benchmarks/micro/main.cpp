@@ -0,0 +1,21 @@
+/**
+ * @file main.cpp
+ * @brief Entry point of the microbenchmarks; silences library logging.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "nalu_event_collector/logging/logging.h"
+
+int main(int argc, char** argv) {
+    // Corrupted streams would otherwise benchmark the warning sink.
+    nalu_event_collector::logging::configure("critical");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
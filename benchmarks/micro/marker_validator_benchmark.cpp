@@ -0,0 +1,44 @@
+/**
+ * @file marker_validator_benchmark.cpp
+ * @brief Microbenchmarks of the MarkerValidator kernels.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "benchmark_data.h"
+#include "nalu_event_collector/parsing/marker_validator.h"
+
+namespace nalu_event_collector::benchmarks {
+
+namespace {
+
+constexpr size_t kTriggers = 64;
+
+// Arg: kernel cap (0 scalar, 1 SSE2); skipped when the CPU lacks it.
+void BM_MarkerValidate(benchmark::State& state) {
+    static const std::vector<uint8_t> stream = make_payload_stream(kTriggers);
+    const auto isa = static_cast<MarkerValidator::Isa>(state.range(0));
+    const MarkerValidator validator(kWirePacketSize, {0x0E}, {0xFA, 0x5A}, isa);
+    if (validator.isa() != isa) {
+        state.SkipWithError("Kernel not supported on this CPU");
+        return;
+    }
+    state.SetLabel(MarkerValidator::isa_name(isa));
+
+    const size_t slots = stream.size() / kWirePacketSize;
+    for (auto _ : state) {
+        uint64_t good = 0;
+        for (size_t k = 0; k < slots; k += MarkerValidator::kMaxSlots) {
+            good += validator.validate(stream.data() + k * kWirePacketSize, slots - k);
+        }
+        benchmark::DoNotOptimize(good);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * slots));
+}
+BENCHMARK(BM_MarkerValidate)->ArgName("isa")->Arg(0)->Arg(1);
+
+}  // namespace
+
+}  // namespace nalu_event_collector::benchmarks
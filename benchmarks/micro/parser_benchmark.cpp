@@ -0,0 +1,124 @@
+/**
+ * @file parser_benchmark.cpp
+ * @brief Microbenchmarks of PacketParser::process_stream and process_datagrams.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "benchmark_data.h"
+
+namespace nalu_event_collector::benchmarks {
+
+namespace {
+
+constexpr size_t kTriggers = 64;
+
+// Receive chunks that end mid-packet, so every call carries leftovers over.
+constexpr size_t kChunkSize = 1000;
+
+// A backlog large enough to split across parse threads (about 19 MB).
+constexpr size_t kBacklogTriggers = 2048;
+
+PacketParserConfig parser_config(bool check_packet_integrity,
+                                 const char* decoder,
+                                 size_t parse_threads) {
+    PacketParserConfig config;
+    config.check_packet_integrity = check_packet_integrity;
+    config.decoder = decoder;
+    config.parse_threads = parse_threads;
+    return config;
+}
+
+void parse(benchmark::State& state,
+           const std::vector<uint8_t>& stream,
+           bool check_packet_integrity,
+           size_t chunk_size,
+           const char* decoder = "auto",
+           size_t parse_threads = 1) {
+    PacketParser parser(parser_config(check_packet_integrity, decoder, parse_threads));
+    std::vector<Packet> packets;
+    packets.reserve(stream.size() / kWirePacketSize + 1);
+    for (auto _ : state) {
+        packets.clear();
+        for (size_t offset = 0; offset < stream.size(); offset += chunk_size) {
+            parser.process_stream(
+                stream.data() + offset, std::min(chunk_size, stream.size() - offset), packets);
+        }
+        benchmark::DoNotOptimize(packets.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * stream.size()));
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * (stream.size() / kWirePacketSize)));
+}
+
+// Args: check_packet_integrity, leftovers (chunked input).
+void BM_ProcessStream(benchmark::State& state) {
+    static const std::vector<uint8_t> stream = make_payload_stream(kTriggers);
+    const bool leftovers = state.range(1) != 0;
+    parse(state, stream, state.range(0) != 0, leftovers ? kChunkSize : stream.size());
+}
+BENCHMARK(BM_ProcessStream)
+    ->ArgNames({"integrity", "leftovers"})
+    ->Args({0, 0})
+    ->Args({0, 1})
+    ->Args({1, 0})
+    ->Args({1, 1});
+
+// Arg: check_packet_integrity; the runtime-parameter decoder for comparison.
+void BM_ProcessStreamGenericDecoder(benchmark::State& state) {
+    static const std::vector<uint8_t> stream = make_payload_stream(kTriggers);
+    parse(state, stream, state.range(0) != 0, stream.size(), "generic");
+}
+BENCHMARK(BM_ProcessStreamGenericDecoder)->ArgName("integrity")->Arg(0)->Arg(1);
+
+// Args: check_packet_integrity, parse_threads; one backlog parsed in a single call.
+void BM_ProcessBacklog(benchmark::State& state) {
+    static const std::vector<uint8_t> stream = make_payload_stream(kBacklogTriggers);
+    parse(state,
+          stream,
+          state.range(0) != 0,
+          stream.size(),
+          "auto",
+          static_cast<size_t>(state.range(1)));
+}
+BENCHMARK(BM_ProcessBacklog)
+    ->ArgNames({"integrity", "threads"})
+    ->ArgsProduct({{0, 1}, {1, 2, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Arg: check_packet_integrity; every datagram parsed on its own from its length record.
+void BM_ProcessDatagrams(benchmark::State& state) {
+    static std::vector<ArrivalMark> marks;
+    static const std::vector<uint8_t> stream = make_payload_stream(kTriggers, 0.0, &marks);
+    PacketParser parser(parser_config(state.range(0) != 0, "auto", 1));
+    std::vector<Packet> packets;
+    packets.reserve(stream.size() / kWirePacketSize + 1);
+    for (auto _ : state) {
+        packets.clear();
+        parser.process_datagrams(
+            stream.data(), stream.size(), nullptr, 0, marks.data(), marks.size(), packets);
+        benchmark::DoNotOptimize(packets.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * stream.size()));
+    state.SetItemsProcessed(
+        static_cast<int64_t>(state.iterations() * (stream.size() / kWirePacketSize)));
+}
+BENCHMARK(BM_ProcessDatagrams)->ArgName("integrity")->Arg(0)->Arg(1);
+
+// Arg: corrupted markers per 10000 packets, parsed with integrity checks.
+void BM_ProcessCorruptedStream(benchmark::State& state) {
+    const std::vector<uint8_t> stream =
+        make_payload_stream(kTriggers, static_cast<double>(state.range(0)) / 10000.0);
+    parse(state, stream, true, stream.size());
+}
+BENCHMARK(BM_ProcessCorruptedStream)->ArgName("corrupt_per_10k")->Arg(10)->Arg(100)->Arg(1000);
+
+}  // namespace
+
+}  // namespace nalu_event_collector::benchmarks
@@ -0,0 +1,65 @@
+/**
+ * @file time_difference_benchmark.cpp
+ * @brief Microbenchmarks of TimeDifferenceCalculator.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "nalu_event_collector/config/event_builder_config.h"
+#include "nalu_event_collector/timing/time_difference_calculator.h"
+
+namespace nalu_event_collector::benchmarks {
+
+namespace {
+
+constexpr size_t kPairs = 4096;
+
+// Trigger-time pairs spread over the whole counter, so about half wrap around.
+std::vector<std::pair<uint32_t, uint32_t>> make_pairs(uint32_t max_trigger_time) {
+    std::mt19937 random(1);
+    std::uniform_int_distribution<uint32_t> time(0, max_trigger_time - 1);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(kPairs);
+    for (auto& pair : pairs) {
+        pair = {time(random), time(random)};
+    }
+    return pairs;
+}
+
+void BM_ComputeTimeDiff(benchmark::State& state) {
+    const EventBuilderConfig config;
+    const TimeDifferenceCalculator calculator(config.max_trigger_time, config.time_threshold);
+    const auto pairs = make_pairs(config.max_trigger_time);
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (const auto& pair : pairs) {
+            sum += calculator.compute_time_diff(pair.first, pair.second);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kPairs));
+}
+BENCHMARK(BM_ComputeTimeDiff);
+
+void BM_IsWithinThreshold(benchmark::State& state) {
+    const EventBuilderConfig config;
+    const TimeDifferenceCalculator calculator(config.max_trigger_time, config.time_threshold);
+    const auto pairs = make_pairs(config.max_trigger_time);
+    for (auto _ : state) {
+        size_t matches = 0;
+        for (const auto& pair : pairs) {
+            matches += calculator.is_within_threshold(pair.first, pair.second) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kPairs));
+}
+BENCHMARK(BM_IsWithinThreshold);
+
+}  // namespace
+
+}  // namespace nalu_event_collector::benchmarks
@@ -0,0 +1,75 @@
+/**
+ * @file udp_data_buffer_benchmark.cpp
+ * @brief Microbenchmarks of UdpDataBuffer appends and bulk reads.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "nalu_event_collector/network/udp_data_buffer.h"
+
+namespace nalu_event_collector::benchmarks {
+
+namespace {
+
+constexpr size_t kBufferSize = 16 * 1024 * 1024;
+
+// Arg: bytes per append (one packet, one 13-packet datagram, one jumbo datagram).
+void BM_UdpDataBufferAppend(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(state.range(0));
+    const std::vector<uint8_t> datagram(size, 0x5A);
+    UdpDataBuffer buffer(kBufferSize);
+    for (auto _ : state) {
+        if (buffer.size() + size > buffer.capacity()) {
+            // Hand everything back without copying, as the collector does.
+            buffer.acquireRead();
+            buffer.releaseRead();
+        }
+        buffer.append(datagram.data(), datagram.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_UdpDataBufferAppend)->ArgName("bytes")->Arg(74)->Arg(978)->Arg(8976);
+
+// Arg: datagrams per batch of 978-byte datagrams, published together.
+void BM_UdpDataBufferAppendBatch(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const std::vector<uint8_t> datagram(978, 0x5A);
+    const std::vector<UdpDataBuffer::Segment> segments(
+        count, UdpDataBuffer::Segment{datagram.data(), datagram.size()});
+    UdpDataBuffer buffer(kBufferSize);
+    for (auto _ : state) {
+        if (buffer.size() + count * datagram.size() > buffer.capacity()) {
+            buffer.acquireRead();
+            buffer.releaseRead();
+        }
+        buffer.appendBatch(segments.data(), segments.size());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * count * datagram.size()));
+}
+BENCHMARK(BM_UdpDataBufferAppendBatch)->ArgName("datagrams")->Arg(1)->Arg(32);
+
+// Arg: buffered bytes copied out per call.
+void BM_UdpDataBufferGetAllBytes(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(state.range(0));
+    const std::vector<uint8_t> data(size, 0x5A);
+    UdpDataBuffer buffer(kBufferSize);
+    for (auto _ : state) {
+        state.PauseTiming();
+        buffer.append(data.data(), data.size());
+        state.ResumeTiming();
+        std::vector<uint8_t> bytes = buffer.getAllBytes();
+        benchmark::DoNotOptimize(bytes.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_UdpDataBufferGetAllBytes)
+    ->ArgName("bytes")
+    ->Arg(64 * 1024)
+    ->Arg(1024 * 1024)
+    ->Arg(8 * 1024 * 1024);
+
+}  // namespace
+
+}  // namespace nalu_event_collector::benchmarks
@@ -0,0 +1,52 @@
+/**
+ * @file waveform_unpacker_benchmark.cpp
+ * @brief Microbenchmarks of the WaveformUnpacker kernels.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "benchmark_data.h"
+#include "nalu_event_collector/data/waveform_unpacker.h"
+
+namespace nalu_event_collector::benchmarks {
+
+namespace {
+
+constexpr size_t kTriggers = 64;
+
+// Samples of the Nalu ASICs are 12 bits wide.
+constexpr uint8_t kSampleBits = 12;
+
+template <typename Sample>
+void unpack(benchmark::State& state) {
+    static const std::vector<Packet> packets = make_packets(kTriggers);
+    const auto isa = static_cast<WaveformUnpacker::Isa>(state.range(0));
+    const WaveformUnpacker unpacker(kSampleBits, state.range(1) != 0, isa);
+    if (unpacker.isa() != isa) {
+        state.SkipWithError("Kernel not supported on this CPU");
+        return;
+    }
+    state.SetLabel(WaveformUnpacker::isa_name(isa));
+
+    std::vector<Sample> samples(packets.size() * WaveformUnpacker::kSamplesPerPacket);
+    for (auto _ : state) {
+        unpacker.unpack(packets.data(), packets.size(), samples.data());
+        benchmark::DoNotOptimize(samples.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * samples.size()));
+}
+
+// Args: kernel cap (0 scalar, 1 SSE4.1, 2 AVX2), byte swap; skipped when the CPU lacks it.
+void BM_UnpackInt16(benchmark::State& state) { unpack<int16_t>(state); }
+BENCHMARK(BM_UnpackInt16)->ArgNames({"isa", "swap"})->ArgsProduct({{0, 1, 2}, {0, 1}});
+
+// Args: kernel cap (0 scalar, 1 SSE4.1, 2 AVX2), byte swap; skipped when the CPU lacks it.
+void BM_UnpackFloat(benchmark::State& state) { unpack<float>(state); }
+BENCHMARK(BM_UnpackFloat)->ArgNames({"isa", "swap"})->ArgsProduct({{0, 1, 2}, {0, 1}});
+
+}  // namespace
+
+}  // namespace nalu_event_collector::benchmarks
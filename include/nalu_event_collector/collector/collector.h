@@ -7,31 +7,62 @@
 
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include "nalu_event_collector/collector/event_builder.h"
+#include "nalu_event_collector/collector/event_merger.h"
 #include "nalu_event_collector/config/collector_config.h"
 #include "nalu_event_collector/data/collector_timing_data.h"
+#include "nalu_event_collector/input/input_source.h"
+#include "nalu_event_collector/input/replay_source.h"
 #include "nalu_event_collector/network/udp_receiver.h"
 #include "nalu_event_collector/parsing/packet_parser.h"
+#include "nalu_event_collector/timing/latency_histogram.h"
 
 namespace nalu_event_collector {
 
 /**
  * @brief Orchestrates UDP reception, packet parsing, and event building.
  *
- * A `Collector` owns the full online collection pipeline. It can be driven
+ * A `Collector` owns the full online collection pipeline. Datagrams come from
+ * an InputSource: the live UdpReceiver by default, a ReplaySource for
+ * recorded captures, or any source handed to the constructor. It can be driven
  * either manually with repeated calls to collect() or continuously through an
- * internal worker thread started with start().
+ * internal worker thread started with start(). The worker either polls with a
+ * fixed sleep or, when `wakeup_min_bytes` is set, sleeps until enough data is
+ * buffered or the maximum wait elapses.
+ *
+ * With receiver arrival timestamps enabled, every packet carries its kernel
+ * arrival time through parsing into its event, and the collector keeps
+ * arrival-to-parse, arrival-to-build, and arrival-to-delivery latency
+ * percentiles in the timing data.
+ *
+ * When the receiver demultiplexes senders, every stream becomes a board
+ * pipeline with its own parser state and event builder, created as soon as
+ * the stream appears. Board pipelines run inline in collect() or, with
+ * `board_workers`, on one worker thread each, optionally pinned to a core.
+ * With the event merger enabled, the boards' complete events pass through an
+ * EventMerger and are returned in global trigger-time order, either grouped
+ * by get_merged_events() or flattened by get_data().
  */
 class Collector {
   public:
-    /** @brief Construct a collector from a complete configuration object. */
+    /** @brief Construct a collector reading from the input source selected by `config.input`. */
     explicit Collector(const CollectorConfig& config);
 
+    /**
+     * @brief Construct a collector reading from @p source.
+     *
+     * The receiver and replay settings of @p config are ignored; the source
+     * decides shards, streams, and arrival timestamps.
+     */
+    Collector(const CollectorConfig& config, std::unique_ptr<InputSource> source);
+
     /** @brief Stop any running background work and release owned resources. */
     ~Collector();
 
@@ -56,25 +87,117 @@ class Collector {
     /** @brief Return timing data and newly available complete events together. */
     std::pair<CollectorTimingData, std::vector<Event*>> get_data();
 
+    /**
+     * @brief Return the merged events that became ready since the last call.
+     *
+     * @throws std::logic_error if the event merger is not enabled.
+     */
+    std::vector<MergedEvent> get_merged_events();
+
+    /** @brief Return per-board alignment state of the event merger (empty when disabled). */
+    std::vector<BoardAlignment> get_board_alignment();
+
     /** @brief Remove events that have already been returned to the caller. */
     void clear_events();
 
-    /** @brief Access the owned UDP receiver. */
-    UdpReceiver& get_receiver() { return receiver_; }
+    /** @brief Access the owned input source. */
+    InputSource& get_input_source() { return *source_; }
+
+    /**
+     * @brief Access the owned UDP receiver.
+     *
+     * @throws std::logic_error if the input source is not a UdpReceiver.
+     */
+    UdpReceiver& get_receiver();
+
+    /** @brief Return per-shard receive counters. */
+    std::vector<UdpShardStats> get_shard_stats() const;
 
-    /** @brief Access the owned packet parser. */
-    PacketParser& get_parser() { return parser_; }
+    /** @brief Return transport-header sequence counters summed over all sources. */
+    SequenceStats get_sequence_stats() const { return source_->getSequenceStats(); }
 
-    /** @brief Access the owned event builder. */
+    /** @brief Forget the arrival latency samples gathered so far. */
+    void reset_latency_stats();
+
+    /** @brief Access the packet parser of the first receive shard. */
+    PacketParser& get_parser() { return parsers_.front(); }
+
+    /** @brief Access the packet parser of receive shard @p shard. */
+    PacketParser& get_parser(size_t shard) { return parsers_.at(shard); }
+
+    /** @brief Access the owned event builder (unused while the receiver demultiplexes). */
     EventBuilder& get_event_builder() { return event_builder_; }
 
+    /** @brief Return the number of board pipelines created for demultiplexed streams. */
+    size_t get_board_count();
+
+    /** @brief Return the stream label (`address:port` or `board N`) of board @p board. */
+    std::string get_board_label(size_t board);
+
+    /** @brief Access the event builder of board @p board. */
+    EventBuilder& get_board_event_builder(size_t board);
+
   private:
+    // Per-pipeline buffers reused every cycle, so steady-state parsing does not allocate.
+    struct DrainScratch {
+        std::vector<DatagramRef> ready_datagrams;
+        std::vector<ArrivalMark> arrival_marks;
+        std::vector<Packet> packets;
+        std::vector<uint64_t> arrivals;
+    };
+
+    struct BoardPipeline {
+        BoardPipeline(size_t board_shard,
+                      UdpDataBuffer& board_buffer,
+                      std::string board_label,
+                      const PacketParser& board_parser,
+                      const EventBuilderConfig& builder_config)
+            : shard(board_shard),
+              data_buffer(board_buffer),
+              label(std::move(board_label)),
+              parser(board_parser),
+              event_builder(builder_config) {}
+
+        size_t shard;
+        UdpDataBuffer& data_buffer;
+        std::string label;
+        PacketParser parser;
+        EventBuilder event_builder;
+        DrainScratch scratch;
+        size_t last_event_index = 0;
+        std::atomic<uint64_t> packets{0};
+        int cpu = -1;
+        std::thread worker;
+    };
+
     void collectionLoop();
+    void boardLoop(BoardPipeline& board);
+    size_t drain(UdpDataBuffer& data_buffer,
+                 DatagramPool* pool,
+                 PacketParser& parser,
+                 DrainScratch& scratch,
+                 std::vector<Packet>& packets,
+                 std::vector<uint64_t>& arrivals,
+                 double& udp_time,
+                 double& parse_time);
+    void collect_board(BoardPipeline& board);
+    void refresh_boards();
+    void start_board_worker(BoardPipeline& board, size_t index);
+    void record_cycle(std::chrono::steady_clock::time_point start_time,
+                      size_t data_size,
+                      double udp_time,
+                      double parse_time,
+                      double event_time,
+                      const std::vector<uint64_t>& arrivals,
+                      uint64_t built_ns);
+    std::vector<Event*> take_complete_events(EventBuilder& event_builder, size_t& last_event_index);
+    void merge_board_events(std::vector<MergedEvent>& merged);
+    void record_delivery(const std::vector<Event*>& events);
     void log_skipped_incomplete_events(const std::vector<Event*>& new_events,
                                        size_t complete_event_count) const;
 
-    UdpReceiver receiver_;
-    PacketParser parser_;
+    std::unique_ptr<InputSource> source_;
+    std::vector<PacketParser> parsers_;
     EventBuilder event_builder_;
     std::atomic<bool> running_;
     size_t last_event_index_;
@@ -85,10 +208,28 @@ class Collector {
     double avg_total_time_ = 0.0;
     double avg_data_processed_ = 0.0;
     double avg_udp_time_ = 0.0;
+    DrainScratch scratch_;
     std::thread collector_thread_;
     std::mutex data_mutex_;
     CollectorTimingData timing_data_;
     std::chrono::microseconds sleep_time_us_;
+    size_t wakeup_min_bytes_;
+    std::chrono::microseconds wakeup_max_wait_us_;
+    WakeupReason wakeup_reason_ = WakeupReason::Polled;
+    bool track_arrivals_;
+    bool datagram_aligned_;
+    // Unused template for board parsers; copying it shares the shard parsers'
+    // worker pool, so boards add no parse threads of their own.
+    PacketParser board_parser_;
+    EventBuilderConfig event_builder_config_;
+    bool board_workers_;
+    std::vector<int> board_worker_cpus_;
+    std::vector<std::unique_ptr<BoardPipeline>> boards_;
+    std::vector<size_t> board_stream_counts_;
+    std::unique_ptr<EventMerger> merger_;
+    LatencyHistogram parse_latency_;
+    LatencyHistogram build_latency_;
+    LatencyHistogram delivery_latency_;
 };
 
 }  // namespace nalu_event_collector
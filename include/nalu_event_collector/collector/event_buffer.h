@@ -80,8 +80,15 @@ class EventBuffer {
     /** @brief Remove all events before @p index and return the removal count. */
     size_t remove_events_before_index_exclusive(size_t index);
 
-    /** @brief Route a packet into an existing event or create a new event. */
-    void add_packet(const Packet& packet, bool& in_safety_buffer_zone, uint32_t& event_index);
+    /**
+     * @brief Route a packet into an existing event or create a new event.
+     *
+     * A nonzero @p arrival_ns extends the receiving event's arrival range.
+     */
+    void add_packet(const Packet& packet,
+                    bool& in_safety_buffer_zone,
+                    uint32_t& event_index,
+                    uint64_t arrival_ns = 0);
 
     /** @brief Clear all buffered events. */
     void clear();
@@ -47,6 +47,9 @@ class EventBuilder {
     /** @brief Process a parsed packet batch and update event state. */
     void collect_events(const std::vector<Packet>& packets);
 
+    /** @brief Process a parsed packet batch whose arrival times are given index for index in @p arrivals. */
+    void collect_events(const std::vector<Packet>& packets, const std::vector<uint64_t>& arrivals);
+
     /** @brief Access the owned event buffer. */
     EventBuffer& get_event_buffer() { return event_buffer_; }
 
@@ -0,0 +1,169 @@
+/**
+ * @file event_merger.h
+ * @brief Streaming trigger-time merge of per-board events into global events.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nalu_event_collector/config/event_merger_config.h"
+#include "nalu_event_collector/data/event.h"
+#include "nalu_event_collector/data/merged_event.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Alignment state and counters of one board in the merge.
+ */
+struct BoardAlignment {
+    /** @brief Board label as given to EventMerger::add_board(). */
+    std::string label;
+
+    /** @brief True for the board whose trigger clock defines the global timeline. */
+    bool reference = false;
+
+    /** @brief True while the board's trigger times are mapped onto the global timeline. */
+    bool locked = false;
+
+    /** @brief Board trigger time minus global time at the last alignment, in ticks. */
+    int64_t offset_ticks = 0;
+
+    /** @brief Offset expressed in microseconds of the configured clock. */
+    double offset_us = 0.0;
+
+    /** @brief Estimated board clock rate error against the reference in parts per million. */
+    double drift_ppm = 0.0;
+
+    /** @brief Events received from the board. */
+    uint64_t events = 0;
+
+    /** @brief Events merged together with a reference-board event. */
+    uint64_t matched = 0;
+
+    /** @brief Events emitted without the reference board. */
+    uint64_t unmatched = 0;
+
+    /** @brief Events emitted before the board could be aligned. */
+    uint64_t unaligned = 0;
+
+    /** @brief Times the board (re)acquired its alignment. */
+    uint64_t locks = 0;
+
+    /** @brief Events queued in the merge and not yet emitted. */
+    size_t pending = 0;
+};
+
+/**
+ * @brief Aligns per-board event streams by trigger time and merges them.
+ *
+ * Each board counts triggers with its own wrapping counter. The merger
+ * unwraps every board's counter, takes the first board that produces an event
+ * as the reference timeline, and locks every other board onto it. The coarse
+ * lock considers the reference events within `lock_window_us` in host time
+ * (kernel arrival time when recorded, event creation time otherwise) and
+ * picks the one whose offset lines up the most queued board events. After
+ * that, each merged reference match corrects the board's offset and drift in
+ * a small tracking loop. A board that keeps missing the reference relocks.
+ *
+ * Merging is a streaming k-way merge over bounded per-board queues keyed by
+ * global trigger time. The earliest queued event is emitted together with
+ * every other board head inside the match window once no board can still
+ * deliver an earlier event, once it has waited `max_wait_us`, or when a board
+ * queue is full.
+ *
+ * The merger is not synchronized; callers serialize access.
+ */
+class EventMerger {
+  public:
+    /** @brief Construct a merger for counters wrapping at @p max_trigger_time and ticking at @p clock_frequency. */
+    EventMerger(const EventMergerConfig& config,
+                uint32_t max_trigger_time,
+                uint32_t clock_frequency);
+
+    /** @brief Register a board and return its index. */
+    size_t add_board(std::string label);
+
+    /** @brief Return the number of registered boards. */
+    size_t get_board_count() const { return boards_.size(); }
+
+    /** @brief Queue the newly completed events of @p board, in the order it built them. */
+    void push(size_t board, const std::vector<Event*>& events);
+
+    /**
+     * @brief Append every merged event that is ready to @p merged and return how many were added.
+     *
+     * With @p flush set, everything queued is emitted regardless of the other
+     * boards.
+     */
+    size_t pop(std::vector<MergedEvent>& merged, bool flush = false);
+
+    /** @brief Return the number of events of @p board still queued in the merge. */
+    size_t pending(size_t board) const { return boards_.at(board).queue.size(); }
+
+    /** @brief Return alignment state and counters for every board. */
+    std::vector<BoardAlignment> get_alignment() const;
+
+  private:
+    struct PendingEvent {
+        Event* event;
+        int64_t local_time;
+        int64_t global_time;
+        uint64_t arrival_ns;
+        int64_t created_ns;
+    };
+
+    struct ReferenceMark {
+        int64_t global_time;
+        uint64_t arrival_ns;
+        int64_t created_ns;
+    };
+
+    struct Board {
+        std::string label;
+        std::deque<PendingEvent> queue;
+        bool started = false;
+        uint32_t last_trigger_time = 0;
+        int64_t local_time = 0;
+        bool locked = false;
+        double anchor_local = 0.0;
+        double anchor_global = 0.0;
+        double rate = 1.0;
+        size_t misses = 0;
+        BoardAlignment stats;
+    };
+
+    using HeapEntry = std::pair<int64_t, size_t>;
+
+    int64_t unwrap(Board& board, uint32_t trigger_time);
+    int64_t to_global(const Board& board, int64_t local_time) const;
+    bool try_lock(size_t index, bool force);
+    void realign(size_t index, int64_t reference_time, int64_t board_time);
+    void remember_reference(const PendingEvent& pending);
+    void rebuild_heap();
+    bool ready(int64_t time, int64_t now_ns, bool flush) const;
+    void emit_group(std::vector<MergedEvent>& merged);
+    void emit_unaligned(size_t index, std::vector<MergedEvent>& merged);
+    void add_channels(MergedEvent& merged, size_t board, uint64_t channel_mask) const;
+
+    EventMergerConfig config_;
+    uint32_t max_trigger_time_;
+    uint32_t clock_frequency_;
+    int64_t wait_ns_;
+    int64_t lock_window_ns_;
+    std::vector<Board> boards_;
+    size_t reference_ = SIZE_MAX;
+    std::vector<ReferenceMark> reference_marks_;
+    size_t reference_mark_next_ = 0;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap_;
+    uint64_t next_index_ = 0;
+};
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,105 @@
+/**
+ * @file board_emulator_config.h
+ * @brief Configuration for the synthetic Nalu board emulator.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "nalu_event_collector/config/event_builder_config.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Traffic, trigger, and fault-injection settings for BoardEmulator.
+ *
+ * Packet layout and clock settings mirror PacketParserConfig and
+ * EventBuilderConfig defaults, so a collector with default settings decodes
+ * the emulated traffic.
+ */
+struct BoardEmulatorConfig {
+    /** @brief Destination IPv4 address. */
+    std::string address = "127.0.0.1";
+
+    /** @brief Destination UDP port. */
+    uint16_t port = 9000;
+
+    /** @brief Board ID written into the transport header. */
+    uint32_t board_id = 0;
+
+    /** @brief Byte offset of the big-endian board ID inside the 16-byte transport header. */
+    size_t board_id_offset = 4;
+
+    /** @brief Width in bytes (0 to 8) of the board ID; 0 leaves the field out. */
+    size_t board_id_width = 1;
+
+    /** @brief Byte offset of the big-endian datagram sequence counter inside the transport header. */
+    size_t sequence_offset = 2;
+
+    /** @brief Width in bytes (0, 1, 2, 4, or 8) of the sequence counter; 0 leaves it out. */
+    size_t sequence_width = 2;
+
+    /** @brief Channels that report on every trigger (`ext`, `imm`) or may self-trigger (`self`). */
+    std::vector<int> channels = default_channels();
+
+    /** @brief Windows (packets) read out per channel and trigger. */
+    int windows = 4;
+
+    /**
+     * @brief Trigger mode: `ext` or `imm` (periodic triggers read out on every
+     * channel), or `self` (random trigger times, each channel firing with
+     * `self_trigger_occupancy` and up to `self_trigger_jitter` ticks late).
+     */
+    std::string trigger_mode = "ext";
+
+    /** @brief Triggers per second of board time; sets the trigger-time spacing. */
+    double event_rate = 1000.0;
+
+    /** @brief Send each trigger at its wall-clock time; false sends as fast as the socket accepts. */
+    bool paced = true;
+
+    /** @brief Triggers to emit before stopping; 0 runs until stopped. */
+    uint64_t event_count = 0;
+
+    /** @brief Probability that a channel takes part in a `self` trigger. */
+    double self_trigger_occupancy = 0.25;
+
+    /** @brief Largest per-channel trigger-time offset in ticks for `self` triggers. */
+    uint32_t self_trigger_jitter = 100;
+
+    /** @brief Board clock frequency in Hz used to advance trigger times. */
+    uint32_t clock_frequency = 23843000;
+
+    /** @brief Trigger-time counter modulus; the counter wraps here. */
+    uint32_t max_trigger_time = 16777216;
+
+    /** @brief Trigger time of the first event; set near `max_trigger_time` to exercise wraparound. */
+    uint32_t start_trigger_time = 0;
+
+    /** @brief 74-byte packets per datagram. */
+    size_t packets_per_datagram = 13;
+
+    /** @brief Datagrams handed to `sendmmsg` at once. */
+    size_t send_batch_size = 32;
+
+    /** @brief Probability that a datagram is not sent (its sequence number is still used). */
+    double loss_rate = 0.0;
+
+    /** @brief Probability that a datagram is held back and sent after later ones. */
+    double reorder_rate = 0.0;
+
+    /** @brief Datagrams that overtake a held-back datagram. */
+    size_t reorder_distance = 1;
+
+    /** @brief Probability that a packet's start or stop marker is corrupted. */
+    double corrupt_marker_rate = 0.0;
+
+    /** @brief Seed of the fault and trigger random generator. */
+    uint64_t seed = 1;
+};
+
+}  // namespace nalu_event_collector
@@ -6,9 +6,13 @@
 #pragma once
 
 #include <chrono>
+#include <string>
+#include <vector>
 
 #include "nalu_event_collector/config/event_builder_config.h"
+#include "nalu_event_collector/config/event_merger_config.h"
 #include "nalu_event_collector/config/packet_parser_config.h"
+#include "nalu_event_collector/config/replay_source_config.h"
 #include "nalu_event_collector/config/udp_receiver_config.h"
 
 namespace nalu_event_collector {
@@ -20,14 +24,41 @@ struct CollectorConfig {
     /** @brief Event grouping and buffer settings. */
     EventBuilderConfig event_builder;
 
-    /** @brief UDP socket and byte-buffer settings. */
+    /** @brief Input source: `udp` (live UdpReceiver) or `replay` (ReplaySource over a capture). */
+    std::string input = "udp";
+
+    /** @brief UDP socket and byte-buffer settings; buffer, demux, and sequence ones also apply to replay. */
     UdpReceiverConfig udp_receiver;
 
+    /** @brief Capture and pacing settings used when `input` is `replay`. */
+    ReplaySourceConfig replay;
+
     /** @brief Packet decoding settings. */
     PacketParserConfig packet_parser;
 
     /** @brief Optional sleep inserted between background collection cycles. */
     std::chrono::microseconds sleep_time_us = std::chrono::microseconds(-1);
+
+    /**
+     * @brief Buffered bytes that wake the background loop early.
+     *
+     * When non-zero the loop waits for data instead of sleeping `sleep_time_us`:
+     * it collects as soon as this many bytes are buffered across all shards or
+     * `wakeup_max_wait_us` has passed.
+     */
+    size_t wakeup_min_bytes = 0;
+
+    /** @brief Longest the background loop waits for `wakeup_min_bytes` before collecting anyway. */
+    std::chrono::microseconds wakeup_max_wait_us = std::chrono::microseconds(10000);
+
+    /** @brief With receiver demux, run every board's parse and build pipeline on its own thread. */
+    bool board_workers = false;
+
+    /** @brief CPU cores for board workers, assigned round-robin; empty leaves them unpinned. */
+    std::vector<int> board_worker_cpus;
+
+    /** @brief Trigger-time merge of the demultiplexed boards' events into global events. */
+    EventMergerConfig event_merger;
 };
 
 }  // namespace nalu_event_collector
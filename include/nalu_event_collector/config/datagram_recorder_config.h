@@ -0,0 +1,33 @@
+/**
+ * @file datagram_recorder_config.h
+ * @brief Configuration for recording received datagrams into a file ring.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace nalu_event_collector {
+
+/**
+ * @brief File ring and staging configuration for DatagramRecorder.
+ */
+struct DatagramRecorderConfig {
+    /** @brief Record every received datagram into the file ring. */
+    bool enabled = false;
+
+    /** @brief Path of the ring file; it is created (or truncated) and preallocated on startup. */
+    std::string path = "nalu_datagrams.ring";
+
+    /**
+     * @brief Bytes of record space in the ring file, at least two 64 KiB datagrams;
+     * the oldest records are overwritten when full.
+     */
+    size_t file_size = 1024ULL * 1024 * 1024;
+
+    /** @brief In-memory staging ring per receive shard; datagrams that do not fit are not recorded. */
+    size_t staging_size = 8 * 1024 * 1024;
+};
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,51 @@
+/**
+ * @file event_merger_config.h
+ * @brief Configuration for merging per-board events into global events.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Configuration for constructing an EventMerger.
+ *
+ * Trigger-time range and clock frequency are taken from the event builder
+ * configuration, since every board counts in the same nominal clock.
+ */
+struct EventMergerConfig {
+    /** @brief Merge the events of demultiplexed boards by trigger time. */
+    bool enabled = false;
+
+    /** @brief Largest trigger-time difference, in reference-board ticks, within one merged event. */
+    uint32_t match_window = 5000;
+
+    /** @brief Host-clock window in microseconds for the coarse lock of a board onto the reference. */
+    uint32_t lock_window_us = 2000;
+
+    /** @brief Longest time in microseconds an event waits for the other boards before it is emitted. */
+    uint32_t max_wait_us = 20000;
+
+    /** @brief Events queued per board before the oldest merged event is forced out. */
+    size_t max_pending_events = 256;
+
+    /** @brief Fraction of each measured offset error applied to a board's alignment. */
+    double offset_gain = 0.25;
+
+    /** @brief Fraction of each measured rate error applied to a board's drift estimate. */
+    double drift_gain = 0.05;
+
+    /** @brief Largest drift in parts per million a board may be estimated to have. */
+    double max_drift_ppm = 500.0;
+
+    /** @brief Consecutive events of a locked board without a reference match before it relocks. */
+    size_t max_misses = 8;
+
+    /** @brief Global channel numbers reserved per board in the combined channel mask. */
+    size_t channel_stride = 64;
+};
+
+}  // namespace nalu_event_collector
@@ -48,6 +48,36 @@ struct PacketParserConfig {
     /** @brief Enable explicit marker validation while parsing. */
     bool check_packet_integrity = false;
 
+    /**
+     * @brief Following packets whose stop markers must also match before a
+     * resynchronization candidate is accepted (only those already buffered).
+     */
+    size_t resync_confirm_packets = 1;
+
+    /**
+     * @brief Packet decoder: `auto` uses a compile-time specialization when the
+     * parameters match a built-in firmware layout, `generic` never does.
+     */
+    std::string decoder = "auto";
+
+    /**
+     * @brief Threads that decode one large batch in parallel, the calling
+     * thread included; 1 parses on the calling thread only.
+     *
+     * A collector's shard and board parsers share one pool of
+     * `parse_threads - 1` workers, and their large batches take turns on it.
+     */
+    size_t parse_threads = 1;
+
+    /** @brief Smallest batch, in bytes, that is split across `parse_threads`. */
+    size_t parallel_min_bytes = 4 * 1024 * 1024;
+
+    /**
+     * @brief Parse every datagram on its own, using the receiver's datagram length
+     * records, instead of stitching partial packets across one flattened stream.
+     */
+    bool datagram_aligned = false;
+
     /** @brief Synthetic packet header written into parsed Packet objects. */
     uint16_t constructed_packet_header = 0xAAAA;
 
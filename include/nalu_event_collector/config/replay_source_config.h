@@ -0,0 +1,44 @@
+/**
+ * @file replay_source_config.h
+ * @brief Configuration for replaying recorded datagram captures.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Capture and pacing configuration for ReplaySource.
+ *
+ * Buffer sizes, demultiplexing, sequence tracking, and arrival timestamps are
+ * taken from the UDP receiver configuration, so a replay feeds the pipeline
+ * exactly as the live receiver would.
+ */
+struct ReplaySourceConfig {
+    /** @brief Path of the capture to replay. */
+    std::string path;
+
+    /** @brief Capture format: `raw` (recorder output), `pcap`, or `auto` to detect it. */
+    std::string format = "auto";
+
+    /** @brief Replay pacing: `fast` (as fast as the pipeline drains) or `original` (capture timing). */
+    std::string pace = "fast";
+
+    /** @brief Speed factor applied to the capture timing in `original` pace (2.0 replays twice as fast). */
+    double speed = 1.0;
+
+    /** @brief Number of passes over the capture; 0 repeats until stopped. */
+    size_t loops = 1;
+
+    /** @brief Replay only pcap datagrams sent to this UDP port; 0 replays every UDP datagram. */
+    uint16_t port = 0;
+
+    /** @brief Datagrams published into the buffers at once. */
+    size_t batch_size = 32;
+};
+
+}  // namespace nalu_event_collector
@@ -8,6 +8,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
+
+#include "nalu_event_collector/config/datagram_recorder_config.h"
 
 namespace nalu_event_collector {
 
@@ -15,13 +18,25 @@ namespace nalu_event_collector {
  * @brief Socket and buffer configuration for UdpReceiver.
  */
 struct UdpReceiverConfig {
+    /**
+     * @brief Receive backend: `socket` (recvfrom/recvmmsg), `af_packet` (TPACKET_V3 ring),
+     * or `io_uring` (multishot recvmsg; falls back to `socket` when unsupported).
+     */
+    std::string backend = "socket";
+
     /** @brief Local bind address. */
     std::string address = "127.0.0.1";
 
     /** @brief Local bind port. */
     uint16_t port = 9000;
 
-    /** @brief Capacity of the raw byte buffer used after UDP header stripping. */
+    /** @brief Bind one receive shard per listed port instead of `port` when non-empty. */
+    std::vector<uint16_t> ports;
+
+    /** @brief Sockets opened per port with `SO_REUSEPORT`, each with its own thread and buffer. */
+    size_t socket_count = 1;
+
+    /** @brief Capacity of each shard's raw byte buffer used after UDP header stripping. */
     size_t buffer_size = 1024 * 1024 * 100;
 
     /** @brief Maximum UDP datagram size expected from the sender. */
@@ -29,6 +44,81 @@ struct UdpReceiverConfig {
 
     /** @brief Receive timeout in seconds. */
     int timeout_sec = 10;
+
+    /** @brief Requested kernel receive buffer (`SO_RCVBUF`) per socket in bytes; 0 keeps the system default. */
+    size_t socket_receive_buffer = 0;
+
+    /** @brief Set the receive buffer with `SO_RCVBUFFORCE` to exceed `net.core.rmem_max` (needs CAP_NET_ADMIN). */
+    bool socket_receive_buffer_force = false;
+
+    /** @brief Double the socket receive buffer whenever the kernel reports dropped datagrams. */
+    bool socket_receive_buffer_autotune = false;
+
+    /** @brief Upper bound in bytes for receive-buffer autotuning. */
+    size_t socket_receive_buffer_max = 64 * 1024 * 1024;
+
+    /** @brief Record kernel arrival times (`SO_TIMESTAMPNS`) to report arrival-to-delivery latency. */
+    bool arrival_timestamps = false;
+
+    /**
+     * @brief Queue the length of every datagram with its bytes so the collector can
+     * parse datagrams one by one (always on with `arrival_timestamps`).
+     */
+    bool datagram_records = false;
+
+    /** @brief Overflow handling when a shard buffer or pool is full: `drop_newest`, `drop_oldest`, or `block`. */
+    std::string overflow_policy = "drop_newest";
+
+    /** @brief Longest time the `block` policy waits for free space before dropping the newest data. */
+    int overflow_block_timeout_ms = 100;
+
+    /** @brief Maximum datagrams pulled per `recvmmsg` call; 1 uses plain `recvmsg`. */
+    size_t recv_batch_size = 32;
+
+    /** @brief Receive straight into pooled datagram slots that the parser reads in place. */
+    bool use_datagram_pool = false;
+
+    /** @brief Number of pool slots; 0 derives it from `buffer_size / max_packet_size`. */
+    size_t datagram_pool_slots = 0;
+
+    /** @brief Capture interface for `af_packet`; empty resolves it from `address`. */
+    std::string interface_name;
+
+    /** @brief TPACKET_V3 block size in bytes for `af_packet`. */
+    size_t af_packet_block_size = 1 << 22;
+
+    /** @brief Number of TPACKET_V3 blocks per shard ring for `af_packet`. */
+    size_t af_packet_block_count = 64;
+
+    /** @brief Milliseconds before the kernel retires a partially filled `af_packet` block. */
+    int af_packet_block_timeout_ms = 10;
+
+    /** @brief Provided receive buffers per shard for `io_uring` (power of two, at most 32768). */
+    size_t io_uring_buffer_count = 1024;
+
+    /** @brief Width in bytes (1, 2, 4, or 8) of the transport-header sequence counter; 0 disables tracking. */
+    size_t sequence_width = 0;
+
+    /** @brief Byte offset of the big-endian sequence counter inside the 16-byte transport header. */
+    size_t sequence_offset = 2;
+
+    /**
+     * @brief Split each shard's traffic into per-sender streams: `none`, `source` (IPv4
+     * address and port), or `board_id` (transport-header field). Requires the byte ring.
+     */
+    std::string demux = "none";
+
+    /** @brief Byte offset of the big-endian board ID inside the 16-byte transport header. */
+    size_t board_id_offset = 4;
+
+    /** @brief Width in bytes (1, 2, or 4) of the transport-header board ID. */
+    size_t board_id_width = 1;
+
+    /** @brief Most demultiplexed streams per shard, each with a `buffer_size` ring; further senders are dropped. */
+    size_t max_streams = 16;
+
+    /** @brief Always-on recording of every received datagram into a memory-mapped file ring. */
+    DatagramRecorderConfig recorder;
 };
 
 }  // namespace nalu_event_collector
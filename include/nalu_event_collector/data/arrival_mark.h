@@ -0,0 +1,28 @@
+/**
+ * @file arrival_mark.h
+ * @brief Kernel arrival time of a byte range inside a parsed chunk.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Marks where one datagram's payload ends inside a chunk handed to the parser.
+ *
+ * A chunk is described by marks in increasing `end_offset` order; every byte
+ * before a mark's end offset (and after the previous mark) arrived at that
+ * mark's time.
+ */
+struct ArrivalMark {
+    /** @brief Offset just past the datagram's last payload byte within the chunk. */
+    size_t end_offset = 0;
+
+    /** @brief Kernel arrival time in nanoseconds since the Unix epoch (0 when unknown). */
+    uint64_t arrival_ns = 0;
+};
+
+}  // namespace nalu_event_collector
@@ -10,6 +10,38 @@
 
 namespace nalu_event_collector {
 
+/**
+ * @brief Why the background collection loop ran a cycle.
+ */
+enum class WakeupReason : int {
+    /** @brief Fixed-interval polling or a manual collect() call. */
+    Polled = 0,
+    /** @brief The buffered byte threshold was reached. */
+    Threshold = 1,
+    /** @brief The maximum wait elapsed before the threshold was reached. */
+    Timeout = 2,
+};
+
+/**
+ * @brief Percentiles of one latency distribution, in microseconds.
+ */
+struct LatencyPercentiles {
+    /** @brief Samples recorded so far. */
+    size_t samples = 0;
+
+    /** @brief Median latency. */
+    double p50_us = 0.0;
+
+    /** @brief 90th-percentile latency. */
+    double p90_us = 0.0;
+
+    /** @brief 99th-percentile latency. */
+    double p99_us = 0.0;
+
+    /** @brief Largest latency seen. */
+    double max_us = 0.0;
+};
+
 /**
  * @brief Timing and throughput summary for a single collection cycle.
  */
@@ -38,6 +70,72 @@ struct CollectorTimingData {
     /** @brief Effective data rate during the cycle, in MiB/s. */
     double data_rate = 0.0;
 
+    /** @brief Time spent draining UDP byte buffers over all cycles so far, in seconds. */
+    double cumulative_udp_time = 0.0;
+
+    /** @brief Time spent parsing packets over all cycles so far, in seconds. */
+    double cumulative_parse_time = 0.0;
+
+    /** @brief Time spent grouping packets into events over all cycles so far, in seconds. */
+    double cumulative_event_time = 0.0;
+
+    /** @brief Payload bytes processed over all cycles so far. */
+    size_t cumulative_data_processed = 0;
+
+    /** @brief Why this cycle ran. */
+    WakeupReason wakeup_reason = WakeupReason::Polled;
+
+    /** @brief Background cycles woken by the byte threshold so far. */
+    size_t threshold_wakeups = 0;
+
+    /** @brief Background cycles woken by the maximum wait so far. */
+    size_t timeout_wakeups = 0;
+
+    /** @brief Datagram pool slots in use after the cycle (pooled reception only). */
+    size_t pool_slots_in_use = 0;
+
+    /** @brief Highest datagram pool occupancy observed so far (pooled reception only). */
+    size_t pool_peak_slots_in_use = 0;
+
+    /** @brief Total datagram pool slots recycled after decoding (pooled reception only). */
+    size_t pool_recycled_slots = 0;
+
+    /** @brief Total datagrams discarded by the receiver overflow policy. */
+    size_t dropped_datagrams = 0;
+
+    /** @brief Total payload bytes discarded by the receiver overflow policy. */
+    size_t dropped_bytes = 0;
+
+    /** @brief Total datagrams the kernel dropped on full socket receive queues (`SO_RXQ_OVFL`). */
+    size_t socket_drops = 0;
+
+    /** @brief Total sequence gaps seen in transport headers (sequence tracking only). */
+    size_t sequence_gaps = 0;
+
+    /** @brief Sequence numbers currently counted as lost (sequence tracking only). */
+    size_t sequence_missing = 0;
+
+    /** @brief Total duplicated datagrams (sequence tracking only). */
+    size_t sequence_duplicates = 0;
+
+    /** @brief Total datagrams that arrived out of order (sequence tracking only). */
+    size_t sequence_reordered = 0;
+
+    /** @brief Total times a parser lost packet alignment and resynchronized. */
+    size_t resync_events = 0;
+
+    /** @brief Total bytes parsers skipped while resynchronizing. */
+    size_t resync_skipped_bytes = 0;
+
+    /** @brief Kernel arrival to end of parsing, per packet, since start (arrival timestamps only). */
+    LatencyPercentiles arrival_to_parse;
+
+    /** @brief Kernel arrival to insertion into an event, per packet, since start (arrival timestamps only). */
+    LatencyPercentiles arrival_to_build;
+
+    /** @brief Arrival of an event's last packet to its return from get_data() (arrival timestamps only). */
+    LatencyPercentiles arrival_to_delivery;
+
     /** @brief Serialize the structure verbatim into @p buffer. */
     void serialize_to_buffer(char* buffer) const {
         if (buffer == nullptr) {
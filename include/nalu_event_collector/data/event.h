@@ -74,6 +74,12 @@ class Event {
     /** @brief Creation timestamp used for timeout-based completion logic. */
     std::chrono::steady_clock::time_point creation_timestamp;
 
+    /** @brief Kernel arrival time of the earliest packet in ns since the Unix epoch (0 when not recorded). */
+    uint64_t first_arrival_ns = 0;
+
+    /** @brief Kernel arrival time of the latest packet in ns since the Unix epoch (0 when not recorded). */
+    uint64_t last_arrival_ns = 0;
+
     /** @brief Construct an empty event shell. */
     Event();
 
@@ -113,6 +119,9 @@ class Event {
     /** @brief Append one packet to the event. */
     void add_packet(const Packet& packet);
 
+    /** @brief Append one packet that arrived at @p arrival_ns and widen the arrival range. */
+    void add_packet(const Packet& packet, uint64_t arrival_ns);
+
     /** @brief Determine completeness using embedded event metadata. */
     bool is_event_complete() const;
 
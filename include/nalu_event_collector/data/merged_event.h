@@ -0,0 +1,59 @@
+/**
+ * @file merged_event.h
+ * @brief Global event assembled from the per-board events of one trigger.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nalu_event_collector/data/event.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief One board's contribution to a merged event.
+ */
+struct MergedEventPart {
+    /** @brief Index of the board the event was built by. */
+    size_t board = 0;
+
+    /** @brief The board's event; owned by that board's event buffer. */
+    Event* event = nullptr;
+
+    /** @brief Trigger time of the event on the global timeline, in reference-board ticks. */
+    int64_t global_time = 0;
+};
+
+/**
+ * @brief Events of several boards that fired on the same trigger.
+ *
+ * The parts point into the event buffers of the boards and stay valid until
+ * the collector clears the events that were returned.
+ */
+struct MergedEvent {
+    /** @brief Running index of the merged event. */
+    uint64_t index = 0;
+
+    /** @brief Unwrapped trigger time in reference-board ticks (earliest part when aligned). */
+    int64_t global_time = 0;
+
+    /** @brief False when the only part came from a board not yet aligned to the reference. */
+    bool aligned = true;
+
+    /** @brief Channel mask over all boards in 64-bit words; board `b` channel `c` is bit `b * stride + c`. */
+    std::vector<uint64_t> channel_mask;
+
+    /** @brief Board events in the merged event, ordered by board index. */
+    std::vector<MergedEventPart> parts;
+
+    /** @brief Return true when global channel @p channel is present. */
+    bool has_channel(size_t channel) const {
+        const size_t word = channel / 64;
+        return word < channel_mask.size() && ((channel_mask[word] >> (channel % 64)) & 1) != 0;
+    }
+};
+
+}  // namespace nalu_event_collector
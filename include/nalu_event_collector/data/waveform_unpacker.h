@@ -0,0 +1,87 @@
+/**
+ * @file waveform_unpacker.h
+ * @brief Vectorized unpacking of raw packet samples into contiguous sample arrays.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nalu_event_collector/data/event.h"
+#include "nalu_event_collector/data/packet.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Decodes Packet::raw_samples into int16 or float samples, many packets at a time.
+ *
+ * The 64 raw bytes of a packet hold kSamplesPerPacket 16-bit sample words,
+ * read little-endian unless byte swapping is on. Every word is masked to its
+ * low `sample_bits` bits and stored at `packet * kSamplesPerPacket + sample`
+ * of the output, so a batch or an event becomes one contiguous waveform array.
+ *
+ * The kernel is picked once at construction: AVX2 unpacks a packet in two
+ * 32-byte steps, SSE4.1 in four 16-byte steps, and the scalar kernel one
+ * word at a time.
+ */
+class WaveformUnpacker {
+  public:
+    /** @brief Instruction sets a kernel can be built for. */
+    enum class Isa { Scalar, Sse41, Avx2 };
+
+    /** @brief Samples carried by one packet. */
+    static constexpr size_t kSamplesPerPacket = sizeof(Packet::raw_samples) / sizeof(uint16_t);
+
+    /**
+     * @brief Prepare an unpacker for samples of @p sample_bits bits (1 to 16).
+     *
+     * With @p swap_bytes the sample words are read big-endian. @p max_isa caps
+     * the kernel, e.g. to compare kernels in benchmarks.
+     *
+     * @throws std::invalid_argument if @p sample_bits is out of range.
+     */
+    explicit WaveformUnpacker(uint8_t sample_bits = 16,
+                              bool swap_bytes = false,
+                              Isa max_isa = Isa::Avx2);
+
+    /**
+     * @brief Unpack @p count packets into `count * kSamplesPerPacket` int16 samples.
+     *
+     * With 16-bit samples, words above INT16_MAX keep their bit pattern.
+     */
+    void unpack(const Packet* packets, size_t count, int16_t* samples) const;
+
+    /** @brief Unpack @p count packets into `count * kSamplesPerPacket` float samples. */
+    void unpack(const Packet* packets, size_t count, float* samples) const;
+
+    /** @brief Replace @p samples with the unpacked samples of every packet in @p event. */
+    void unpack(const Event& event, std::vector<int16_t>& samples) const;
+
+    /** @brief Replace @p samples with the unpacked samples of every packet in @p event. */
+    void unpack(const Event& event, std::vector<float>& samples) const;
+
+    /** @brief Return the sample width in bits. */
+    uint8_t sample_bits() const { return sample_bits_; }
+
+    /** @brief Return true when sample words are read big-endian. */
+    bool swap_bytes() const { return swap_bytes_; }
+
+    /** @brief Return the kernel in use. */
+    Isa isa() const { return isa_; }
+
+    /** @brief Return the best instruction set the running CPU supports. */
+    static Isa detect_isa();
+
+    /** @brief Return a printable name for @p isa. */
+    static const char* isa_name(Isa isa);
+
+  private:
+    uint8_t sample_bits_;
+    bool swap_bytes_;
+    uint16_t mask_ = 0;
+    Isa isa_;
+};
+
+}  // namespace nalu_event_collector
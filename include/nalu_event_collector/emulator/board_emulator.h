@@ -0,0 +1,90 @@
+/**
+ * @file board_emulator.h
+ * @brief UDP sender that emulates one Nalu board with TrafficGenerator traffic.
+ */
+
+#pragma once
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nalu_event_collector/config/board_emulator_config.h"
+#include "nalu_event_collector/emulator/traffic_generator.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Counters of a BoardEmulator.
+ */
+struct BoardEmulatorStats {
+    /** @brief Generator counters, including injected faults. */
+    TrafficGeneratorStats traffic;
+
+    /** @brief Datagrams handed to the kernel. */
+    uint64_t sent_datagrams = 0;
+
+    /** @brief Bytes (transport headers included) handed to the kernel. */
+    uint64_t sent_bytes = 0;
+
+    /** @brief Datagrams the kernel refused to send. */
+    uint64_t send_errors = 0;
+
+    /** @brief Wall-clock seconds spent in run(). */
+    double elapsed_s = 0.0;
+};
+
+/**
+ * @brief Sends the traffic of one emulated board to a UDP destination.
+ *
+ * run() generates triggers with a TrafficGenerator and sends their datagrams
+ * with `sendmmsg`. When paced, every trigger is sent at the wall-clock time
+ * matching its board time, scaled by `event_rate`; otherwise datagrams are
+ * batched `send_batch_size` at a time and sent as fast as the socket accepts.
+ */
+class BoardEmulator {
+  public:
+    /**
+     * @brief Validate @p config and open the sending socket.
+     *
+     * @throws std::invalid_argument for an invalid address or traffic settings.
+     * @throws std::runtime_error when the socket cannot be created.
+     */
+    explicit BoardEmulator(const BoardEmulatorConfig& config);
+
+    /** @brief Close the sending socket. */
+    ~BoardEmulator();
+
+    BoardEmulator(const BoardEmulator&) = delete;
+    BoardEmulator& operator=(const BoardEmulator&) = delete;
+
+    /** @brief Send until `event_count` triggers are sent or stop() is called. */
+    void run();
+
+    /** @brief Ask run() to return after the current trigger; safe from any thread. */
+    void stop() { running_.store(false, std::memory_order_relaxed); }
+
+    /** @brief Return counters; call after run() has returned. */
+    const BoardEmulatorStats& stats() const { return stats_; }
+
+  private:
+    void send(size_t count);
+
+    BoardEmulatorConfig config_;
+    TrafficGenerator generator_;
+    sockaddr_in destination_{};
+    int socket_fd_ = -1;
+    std::atomic<bool> running_{true};
+    std::vector<std::vector<uint8_t>> datagrams_;
+    std::vector<mmsghdr> messages_;
+    std::vector<iovec> iovecs_;
+    BoardEmulatorStats stats_;
+    bool send_error_logged_ = false;
+};
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,28 @@
+/**
+ * @file packet_encoder.h
+ * @brief Serialization of Packet objects into the 74-byte board wire format.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "nalu_event_collector/data/packet.h"
+
+namespace nalu_event_collector {
+
+/** @brief Size of one packet on the wire with the default PacketParserConfig layout. */
+constexpr size_t kWirePacketSize = 74;
+
+/**
+ * @brief Write @p packet into @p out in the layout PacketParser::process_packet decodes.
+ *
+ * The layout is the default one: start marker `0E`, channel, 24-bit trigger
+ * time split 12/12 over two big-endian words, 8-bit logical and 6-bit
+ * physical window, 64 sample bytes, and stop marker `FA 5A`. @p out must hold
+ * kWirePacketSize bytes.
+ */
+void encode_packet(const Packet& packet, uint8_t* out);
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,123 @@
+/**
+ * @file traffic_generator.h
+ * @brief Synthetic board traffic: triggers, packets, datagrams, and injected faults.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nalu_event_collector/config/board_emulator_config.h"
+#include "nalu_event_collector/data/packet.h"
+#include "nalu_event_collector/emulator/packet_encoder.h"
+#include "nalu_event_collector/network/transport_header.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Counters of a TrafficGenerator.
+ */
+struct TrafficGeneratorStats {
+    /** @brief Triggers generated. */
+    uint64_t triggers = 0;
+
+    /** @brief 74-byte packets generated, including those in lost datagrams. */
+    uint64_t packets = 0;
+
+    /** @brief Datagrams framed, including lost ones. */
+    uint64_t datagrams = 0;
+
+    /** @brief Datagrams withheld to emulate loss. */
+    uint64_t lost_datagrams = 0;
+
+    /** @brief Datagrams emitted after later ones. */
+    uint64_t reordered_datagrams = 0;
+
+    /** @brief Packets with a corrupted start or stop marker. */
+    uint64_t corrupted_markers = 0;
+
+    /** @brief Times the trigger-time counter wrapped past `max_trigger_time`. */
+    uint64_t trigger_time_wraps = 0;
+};
+
+/**
+ * @brief Builds the datagrams a board would send, without any I/O.
+ *
+ * Every trigger yields `windows` packets per participating channel, framed
+ * into datagrams of at most `packets_per_datagram` packets behind a 16-byte
+ * transport header carrying the payload length, a sequence counter, and the
+ * board ID. A trigger never shares a datagram with the next one. Faults are
+ * applied to the framed datagrams: a lost datagram still consumes its
+ * sequence number, and a reordered one is held back until
+ * `reorder_distance` later datagrams have been emitted.
+ */
+class TrafficGenerator {
+  public:
+    /**
+     * @brief Validate @p config and prepare the generator.
+     *
+     * @throws std::invalid_argument for unknown trigger modes, out-of-range
+     * channels, windows, header fields, rates, or probabilities.
+     */
+    explicit TrafficGenerator(const BoardEmulatorConfig& config);
+
+    /**
+     * @brief Generate the next trigger and return the datagrams now ready to send.
+     *
+     * The datagrams are written to @p datagrams from entry @p used on, reusing
+     * the storage of existing entries, and the new number of used entries is
+     * returned. Nothing is added when every datagram of the trigger was lost
+     * or held back.
+     */
+    size_t next_trigger(std::vector<std::vector<uint8_t>>& datagrams, size_t used = 0);
+
+    /** @brief Emit every held-back datagram, in the same way as next_trigger(). */
+    size_t flush(std::vector<std::vector<uint8_t>>& datagrams, size_t used = 0);
+
+    /** @brief Return the board time in seconds of the most recent trigger since the first one. */
+    double board_time() const;
+
+    /** @brief Return generator counters. */
+    const TrafficGeneratorStats& stats() const { return stats_; }
+
+  private:
+    enum class TriggerMode {
+        Periodic,
+        Self,
+    };
+
+    static TriggerMode parse_trigger_mode(const std::string& trigger_mode);
+
+    void build_packets();
+    void frame_datagrams(std::vector<std::vector<uint8_t>>& datagrams, size_t& used);
+    void emit(const std::vector<uint8_t>& datagram,
+              std::vector<std::vector<uint8_t>>& datagrams,
+              size_t& used);
+    void release_held(std::vector<std::vector<uint8_t>>& datagrams, size_t& used, bool all);
+    static void push(const std::vector<uint8_t>& datagram,
+                     std::vector<std::vector<uint8_t>>& datagrams,
+                     size_t& used);
+
+    BoardEmulatorConfig config_;
+    TriggerMode trigger_mode_;
+    double ticks_per_trigger_;
+    std::mt19937_64 random_;
+    std::uniform_real_distribution<double> uniform_{0.0, 1.0};
+
+    double board_ticks_ = 0.0;
+    uint32_t last_trigger_time_ = 0;
+    uint8_t next_window_ = 0;
+    uint64_t sequence_ = 0;
+    std::vector<Packet> packets_;
+    std::vector<uint8_t> framing_;
+    std::deque<std::pair<size_t, std::vector<uint8_t>>> held_;
+    TrafficGeneratorStats stats_;
+};
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,101 @@
+/**
+ * @file capture_format.h
+ * @brief On-disk layout of raw datagram captures.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nalu_event_collector {
+
+/** @brief Magic bytes at the start of a raw capture file. */
+constexpr char kCaptureMagic[8] = {'N', 'A', 'L', 'U', 'C', 'A', 'P', '1'};
+
+/** @brief Raw capture format version written and understood by this library. */
+constexpr uint32_t kCaptureVersion = 1;
+
+/** @brief CaptureFileHeader flag: the file is a ring described by a CaptureRingHeader. */
+constexpr uint32_t kCaptureFlagRing = 1;
+
+/** @brief Record length that marks padding up to the end of a ring's record space. */
+constexpr uint16_t kCapturePadLength = 0xffff;
+
+/**
+ * @brief File header of a raw capture.
+ *
+ * A raw capture is this header followed by records, each a
+ * CaptureRecordHeader and the complete datagram (transport header included)
+ * it describes. All fields are in host byte order.
+ *
+ * With kCaptureFlagRing set, a CaptureRingHeader follows and the records
+ * live in a fixed-size record space that wraps around. Records never straddle
+ * the end of that space: a record with length kCapturePadLength, or fewer than
+ * sizeof(CaptureRecordHeader) bytes left, means the next record starts at the
+ * beginning again.
+ */
+struct CaptureFileHeader {
+    /** @brief kCaptureMagic. */
+    char magic[8];
+
+    /** @brief kCaptureVersion. */
+    uint32_t version;
+
+    /** @brief Format flags (kCaptureFlagRing); zero for a linear capture. */
+    uint32_t flags;
+};
+
+/**
+ * @brief Ring description following the CaptureFileHeader of a ring capture.
+ *
+ * Positions are logical byte offsets that only grow; the record at position
+ * `p` starts at `data_offset + p % data_size`. The writer moves `head` past
+ * records before overwriting them and `tail` after a record is complete, so
+ * the range [head, tail) always holds whole records.
+ */
+struct CaptureRingHeader {
+    /** @brief File offset of the record space. */
+    uint64_t data_offset;
+
+    /** @brief Size of the record space in bytes. */
+    uint64_t data_size;
+
+    /** @brief Logical position of the oldest record. */
+    uint64_t head;
+
+    /** @brief Logical position one past the newest record. */
+    uint64_t tail;
+
+    /** @brief Records written since the ring was created. */
+    uint64_t records;
+
+    /** @brief Records overwritten to make room for newer ones. */
+    uint64_t overwritten;
+
+    /** @brief Datagrams the recorder could not stage and never wrote. */
+    uint64_t dropped;
+};
+
+/**
+ * @brief Record header in front of every datagram of a raw capture.
+ */
+struct CaptureRecordHeader {
+    /** @brief Arrival time in nanoseconds since the Unix epoch (0 when not recorded). */
+    uint64_t timestamp_ns;
+
+    /** @brief Sender IPv4 address in host byte order. */
+    uint32_t source_address;
+
+    /** @brief Sender UDP port. */
+    uint16_t source_port;
+
+    /** @brief Datagram length in bytes, including the transport header. */
+    uint16_t length;
+};
+
+static_assert(sizeof(CaptureFileHeader) == 16, "CaptureFileHeader must stay 16 bytes");
+static_assert(sizeof(CaptureRecordHeader) == 16, "CaptureRecordHeader must stay 16 bytes");
+static_assert(sizeof(CaptureRingHeader) == 56, "CaptureRingHeader must stay 56 bytes");
+
+}  // namespace nalu_event_collector
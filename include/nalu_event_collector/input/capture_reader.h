@@ -0,0 +1,122 @@
+/**
+ * @file capture_reader.h
+ * @brief Sequential reader for raw and pcap datagram captures.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "nalu_event_collector/input/capture_format.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief One datagram read from a capture.
+ */
+struct CapturedDatagram {
+    /** @brief First byte of the transport header; points into the mapped capture file. */
+    const uint8_t* data = nullptr;
+
+    /** @brief Datagram length in bytes, including the transport header. */
+    size_t size = 0;
+
+    /** @brief Capture time in nanoseconds since the Unix epoch. */
+    uint64_t timestamp_ns = 0;
+
+    /** @brief Sender IPv4 address in host byte order. */
+    uint32_t source_address = 0;
+
+    /** @brief Sender UDP port. */
+    uint16_t source_port = 0;
+
+    /** @brief Destination UDP port (0 for raw captures, which do not record it). */
+    uint16_t destination_port = 0;
+};
+
+/**
+ * @brief Reads the UDP datagrams of a capture file in recorded order.
+ *
+ * Raw captures use the layout of capture_format.h, either linear or as the
+ * file ring written by DatagramRecorder (read from its oldest record to its
+ * newest). Classic libpcap files
+ * (microsecond or nanosecond timestamps, either byte order) are read with
+ * Ethernet, VLAN-tagged Ethernet, Linux cooked (v1 and v2), BSD loopback, and
+ * raw IP link types; only unfragmented IPv4 UDP datagrams are returned and
+ * everything else is skipped and counted. The file is memory-mapped, so
+ * returned datagrams point straight into it and stay valid for the lifetime
+ * of the reader.
+ */
+class CaptureReader {
+  public:
+    /** @brief Capture file formats. */
+    enum class Format {
+        Raw,
+        Pcap,
+    };
+
+    /**
+     * @brief Map the capture at @p path.
+     *
+     * @p format is `raw`, `pcap`, or `auto` to detect it from the file header.
+     * When @p port is non-zero, pcap datagrams to other destination ports are
+     * skipped.
+     *
+     * @throws std::invalid_argument for an unknown format name.
+     * @throws std::runtime_error when the file cannot be mapped or is not a capture.
+     */
+    CaptureReader(const std::string& path, const std::string& format = "auto", uint16_t port = 0);
+
+    /** @brief Unmap the capture. */
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    /** @brief Read the next datagram into @p datagram; returns false at the end of the capture. */
+    bool next(CapturedDatagram& datagram);
+
+    /** @brief Restart reading from the first record. */
+    void rewind();
+
+    /** @brief Return the detected capture format. */
+    Format format() const { return format_; }
+
+    /** @brief Return the capture path. */
+    const std::string& path() const { return path_; }
+
+    /** @brief Return records skipped since construction (not UDP, filtered, truncated, or fragmented). */
+    uint64_t skipped() const { return skipped_; }
+
+  private:
+    static Format parseFormat(const std::string& format);
+
+    void readPcapHeader();
+    bool nextRaw(CapturedDatagram& datagram);
+    bool nextRing(CapturedDatagram& datagram);
+    bool nextPcap(CapturedDatagram& datagram);
+    bool decodeFrame(const uint8_t* frame, size_t size, CapturedDatagram& datagram) const;
+    uint32_t pcapField(const uint8_t* field) const;
+
+    std::string path_;
+    Format format_;
+    uint16_t port_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t first_record_ = 0;
+    size_t offset_ = 0;
+    bool ring_ = false;
+    const uint8_t* ring_data_ = nullptr;
+    uint64_t ring_size_ = 0;
+    uint64_t ring_head_ = 0;
+    uint64_t ring_tail_ = 0;
+    uint64_t ring_position_ = 0;
+    bool swapped_ = false;
+    bool nanosecond_ = false;
+    uint32_t link_type_ = 0;
+    uint64_t skipped_ = 0;
+};
+
+}  // namespace nalu_event_collector
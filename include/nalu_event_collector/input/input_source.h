@@ -0,0 +1,154 @@
+/**
+ * @file input_source.h
+ * @brief Abstract datagram source that feeds the collection pipeline.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "nalu_event_collector/network/datagram_pool.h"
+#include "nalu_event_collector/network/sequence_tracker.h"
+#include "nalu_event_collector/network/udp_data_buffer.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Traffic counters for one receive shard.
+ */
+struct UdpShardStats {
+    /** @brief Local port the shard socket is bound to. */
+    uint16_t port = 0;
+
+    /** @brief Valid datagrams accepted by the shard. */
+    uint64_t datagrams = 0;
+
+    /** @brief Payload bytes accepted by the shard. */
+    uint64_t bytes = 0;
+
+    /** @brief Datagrams rejected by transport-header validation. */
+    uint64_t malformed_datagrams = 0;
+
+    /** @brief Frames dropped by the kernel because the `af_packet` ring was full. */
+    uint64_t ring_drops = 0;
+
+    /** @brief Datagrams dropped by the kernel because the socket receive queue was full. */
+    uint64_t socket_drops = 0;
+
+    /** @brief Kernel receive buffer size of the shard socket as reported by `SO_RCVBUF`. */
+    size_t socket_receive_buffer = 0;
+
+    /** @brief Valid datagrams discarded by the overflow policy. */
+    uint64_t dropped_datagrams = 0;
+
+    /** @brief Payload bytes discarded by the overflow policy. */
+    uint64_t dropped_bytes = 0;
+};
+
+/**
+ * @brief Traffic counters for one demultiplexed sender stream.
+ */
+struct UdpStreamStats {
+    /** @brief Index of the receive shard the stream belongs to. */
+    size_t shard = 0;
+
+    /** @brief Human-readable sender (`address:port` or `board N`). */
+    std::string label;
+
+    /** @brief Demultiplexing key: packed address and port, or the board ID. */
+    uint64_t key = 0;
+
+    /** @brief Valid datagrams routed to the stream. */
+    uint64_t datagrams = 0;
+
+    /** @brief Payload bytes routed to the stream. */
+    uint64_t bytes = 0;
+
+    /** @brief Datagrams discarded by the overflow policy of the stream buffer. */
+    uint64_t dropped_datagrams = 0;
+
+    /** @brief Payload bytes discarded by the overflow policy of the stream buffer. */
+    uint64_t dropped_bytes = 0;
+};
+
+/**
+ * @brief Source of transport-framed datagrams for the Collector.
+ *
+ * An input source validates and strips the transport header of every
+ * datagram and publishes the payload into per-shard byte buffers (or datagram
+ * pools), optionally split into per-sender streams. The Collector only talks
+ * to this interface, so the live UdpReceiver and offline sources such as
+ * ReplaySource are interchangeable.
+ */
+class InputSource {
+  public:
+    virtual ~InputSource() = default;
+
+    /** @brief Start delivering datagrams. */
+    virtual void start() = 0;
+
+    /** @brief Stop delivering datagrams and join any delivery threads. */
+    virtual void stop() = 0;
+
+    /** @brief Return the number of shards, each with its own buffer. */
+    virtual size_t getShardCount() const = 0;
+
+    /** @brief Access the raw byte buffer of shard @p shard. */
+    virtual UdpDataBuffer& getDataBuffer(size_t shard) = 0;
+
+    /** @brief Return the datagram pool of @p shard, or nullptr when the byte buffer is used. */
+    virtual DatagramPool* getDatagramPool(size_t shard = 0) {
+        (void)shard;
+        return nullptr;
+    }
+
+    /** @brief Return pool occupancy and recycle counters summed over all shards. */
+    virtual DatagramPoolStats getDatagramPoolStats() const { return {}; }
+
+    /** @brief Return traffic counters for every shard. */
+    virtual std::vector<UdpShardStats> getShardStats() const = 0;
+
+    /** @brief Return payload bytes delivered by all shards and not yet drained. */
+    virtual size_t getBufferedBytes() const = 0;
+
+    /**
+     * @brief Block until at least @p min_bytes are buffered across all shards.
+     *
+     * Returns true when the threshold was reached and false when @p max_wait
+     * elapsed first or the source was stopped.
+     */
+    virtual bool waitForData(size_t min_bytes, std::chrono::microseconds max_wait) = 0;
+
+    /** @brief Return true when datagrams carry arrival times into the buffers. */
+    virtual bool isArrivalTimestampingEnabled() const = 0;
+
+    /** @brief Return true when datagrams are split into per-sender streams. */
+    virtual bool isDemuxEnabled() const = 0;
+
+    /** @brief Return the number of streams shard @p shard has created so far. */
+    virtual size_t getStreamCount(size_t shard) const = 0;
+
+    /** @brief Access the byte buffer of stream @p stream in shard @p shard. */
+    virtual UdpDataBuffer& getStreamBuffer(size_t shard, size_t stream) = 0;
+
+    /** @brief Return the label (`address:port` or `board N`) of stream @p stream in shard @p shard. */
+    virtual const std::string& getStreamLabel(size_t shard, size_t stream) const = 0;
+
+    /** @brief Return traffic counters for every stream of every shard. */
+    virtual std::vector<UdpStreamStats> getStreamStats() const = 0;
+
+    /** @brief Return true when transport-header sequence tracking is enabled. */
+    virtual bool isSequenceTrackingEnabled() const = 0;
+
+    /** @brief Return sequence-continuity counters summed over all shards and sources. */
+    virtual SequenceStats getSequenceStats() const = 0;
+
+    /** @brief Return true once a finite source has delivered all of its datagrams. */
+    virtual bool isExhausted() const { return false; }
+};
+
+}  // namespace nalu_event_collector
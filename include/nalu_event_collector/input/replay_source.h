@@ -0,0 +1,193 @@
+/**
+ * @file replay_source.h
+ * @brief Input source that replays recorded datagram captures.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "nalu_event_collector/config/replay_source_config.h"
+#include "nalu_event_collector/config/udp_receiver_config.h"
+#include "nalu_event_collector/input/capture_reader.h"
+#include "nalu_event_collector/input/input_source.h"
+#include "nalu_event_collector/network/datagram_view.h"
+#include "nalu_event_collector/network/sequence_tracker.h"
+#include "nalu_event_collector/network/transport_header.h"
+#include "nalu_event_collector/network/udp_data_buffer.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Feeds the datagrams of a raw or pcap capture into the collection pipeline.
+ *
+ * A single replay thread reads the memory-mapped capture and delivers its
+ * datagrams through the same transport-header validation, sequence tracking,
+ * and optional per-sender demultiplexing as UdpReceiver, into one shard
+ * buffer (or one buffer per stream). Buffer size, demux, sequence, and arrival
+ * settings come from the UDP receiver configuration.
+ *
+ * In `fast` pace the capture is delivered as quickly as the collector drains
+ * it; in `original` pace each datagram is held back until its capture time,
+ * scaled by `speed`, has elapsed since the start of the pass. Either way the
+ * replay never drops data: a full buffer stalls the replay thread and the
+ * stall time is reported. With arrival timestamps enabled, datagrams are
+ * stamped with the wall-clock time at which they were delivered, so latency
+ * figures describe the collector rather than the original capture.
+ */
+class ReplaySource : public InputSource {
+  public:
+    /**
+     * @brief Open the capture of @p config and size buffers from @p receiver_config.
+     *
+     * @throws std::invalid_argument for invalid pacing or demux settings.
+     * @throws std::runtime_error when the capture cannot be read.
+     */
+    ReplaySource(const ReplaySourceConfig& config, const UdpReceiverConfig& receiver_config);
+
+    /** @brief Stop the replay thread. */
+    ~ReplaySource() override;
+
+    /** @brief Start replaying from the first record. */
+    void start() override;
+
+    /** @brief Stop replaying and join the replay thread. */
+    void stop() override;
+
+    /** @brief Return 1; a replay delivers into a single shard. */
+    size_t getShardCount() const override { return 1; }
+
+    /** @brief Access the byte buffer of the shard. */
+    UdpDataBuffer& getDataBuffer(size_t shard) override;
+
+    /** @brief Return replay counters as shard stats (`port` is the pcap port filter). */
+    std::vector<UdpShardStats> getShardStats() const override;
+
+    /** @brief Return payload bytes delivered and not yet drained. */
+    size_t getBufferedBytes() const override;
+
+    /** @brief Block until at least @p min_bytes are buffered or @p max_wait elapses. */
+    bool waitForData(size_t min_bytes, std::chrono::microseconds max_wait) override;
+
+    /** @brief Return true when datagrams are stamped with their delivery time. */
+    bool isArrivalTimestampingEnabled() const override { return arrival_timestamps_; }
+
+    /** @brief Return true when datagrams are split into per-sender streams. */
+    bool isDemuxEnabled() const override { return demux_ != Demux::None; }
+
+    /** @brief Return the number of streams created so far. */
+    size_t getStreamCount(size_t shard) const override;
+
+    /** @brief Access the byte buffer of stream @p stream. */
+    UdpDataBuffer& getStreamBuffer(size_t shard, size_t stream) override;
+
+    /** @brief Return the label (`address:port` or `board N`) of stream @p stream. */
+    const std::string& getStreamLabel(size_t shard, size_t stream) const override;
+
+    /** @brief Return traffic counters for every stream. */
+    std::vector<UdpStreamStats> getStreamStats() const override;
+
+    /** @brief Return true when transport-header sequence tracking is enabled. */
+    bool isSequenceTrackingEnabled() const override { return sequence_tracker_ != nullptr; }
+
+    /** @brief Return sequence-continuity counters over all replayed sources. */
+    SequenceStats getSequenceStats() const override;
+
+    /** @brief Return true once every pass over the capture has been delivered. */
+    bool isExhausted() const override { return exhausted_.load(std::memory_order_acquire); }
+
+    /** @brief Return the number of completed passes over the capture. */
+    size_t getCompletedLoops() const { return completed_loops_.load(std::memory_order_relaxed); }
+
+  private:
+    enum class Pace {
+        Fast,
+        Original,
+    };
+
+    enum class Demux {
+        None,
+        Source,
+        BoardId,
+    };
+
+    struct Stream {
+        Stream(uint64_t stream_key, std::string stream_label, size_t buffer_size)
+            : key(stream_key), label(std::move(stream_label)), data_buffer(buffer_size) {}
+
+        uint64_t key;
+        std::string label;
+        UdpDataBuffer data_buffer;
+        std::vector<UdpDataBuffer::Segment> segments;
+        uint64_t batch_bytes = 0;
+        std::atomic<uint64_t> datagrams{0};
+        std::atomic<uint64_t> bytes{0};
+    };
+
+    static Pace parsePace(const std::string& pace);
+    static Demux parseDemux(const std::string& demux);
+
+    void replayLoop();
+    void deliverBatch();
+    void deliverStreams();
+    Stream* findStream(const DatagramView& datagram);
+    void waitForSpace(UdpDataBuffer& buffer, size_t bytes);
+    void notifyData();
+
+    CaptureReader reader_;
+    Pace pace_;
+    double speed_;
+    size_t loops_;
+    uint16_t port_;
+    size_t batch_size_;
+    bool arrival_timestamps_;
+    bool datagram_records_;
+    Demux demux_;
+    size_t board_id_offset_;
+    size_t board_id_width_;
+    size_t max_streams_;
+    size_t buffer_size_;
+    std::chrono::milliseconds overflow_block_timeout_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> exhausted_{false};
+    std::thread thread_;
+    UdpDataBuffer data_buffer_;
+    std::unique_ptr<SequenceTracker> sequence_tracker_;
+    std::vector<DatagramView> batch_;
+    std::vector<DatagramView> accepted_;
+    std::vector<UdpDataBuffer::Segment> segments_;
+    std::atomic<uint64_t> datagrams_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> malformed_{0};
+    std::atomic<uint64_t> unrouted_datagrams_{0};
+    std::atomic<uint64_t> unrouted_bytes_{0};
+    std::atomic<size_t> completed_loops_{0};
+    std::chrono::nanoseconds stall_time_{0};
+
+    // Streams are only added by the replay thread; readers see the first
+    // stream_count_ entries, which are never moved or removed.
+    std::unique_ptr<std::unique_ptr<Stream>[]> streams_;
+    std::atomic<size_t> stream_count_{0};
+    std::unordered_map<uint64_t, Stream*> stream_index_;
+    std::vector<Stream*> touched_streams_;
+    bool stream_limit_logged_ = false;
+
+    std::atomic<int> data_waiters_{0};
+    std::atomic<size_t> data_threshold_{0};
+    std::mutex data_mutex_;
+    std::condition_variable data_cv_;
+};
+
+}  // namespace nalu_event_collector
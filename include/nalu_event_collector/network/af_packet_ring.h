@@ -0,0 +1,99 @@
+/**
+ * @file af_packet_ring.h
+ * @brief AF_PACKET TPACKET_V3 memory-mapped receive ring filtered to one UDP port.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "nalu_event_collector/network/datagram_view.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Memory-mapped TPACKET_V3 ring that yields UDP datagrams without socket copies.
+ *
+ * The kernel writes matching IPv4/UDP frames straight into a ring shared with
+ * user space; a classic BPF filter restricts the ring to one destination port
+ * (and address). IP and UDP headers are decoded in user space and the
+ * resulting DatagramView objects point directly into the ring block, which
+ * stays owned by user space until release_block() hands it back.
+ *
+ * Opening the ring requires `CAP_NET_RAW`.
+ */
+class AfPacketRing {
+  public:
+    /**
+     * @brief Ring and filter parameters.
+     */
+    struct Options {
+        /** @brief Interface to capture on; empty resolves it from @ref address. */
+        std::string interface_name;
+
+        /** @brief Destination IPv4 address to accept; `0.0.0.0` accepts any. */
+        std::string address = "0.0.0.0";
+
+        /** @brief Destination UDP port to accept. */
+        uint16_t port = 0;
+
+        /** @brief Size of one ring block in bytes (multiple of the page size). */
+        size_t block_size = 1 << 22;
+
+        /** @brief Number of ring blocks. */
+        size_t block_count = 64;
+
+        /** @brief Time after which the kernel retires a partially filled block. */
+        int block_timeout_ms = 10;
+
+        /** @brief PACKET_FANOUT group shared by rings on the same port; negative disables it. */
+        int fanout_group = -1;
+    };
+
+    /** @brief Create a closed ring with the given options. */
+    explicit AfPacketRing(Options options);
+
+    /** @brief Unmap the ring and close the packet socket. */
+    ~AfPacketRing();
+
+    AfPacketRing(const AfPacketRing&) = delete;
+    AfPacketRing& operator=(const AfPacketRing&) = delete;
+
+    /** @brief Create the packet socket, attach the filter, and map the ring. */
+    void open();
+
+    /** @brief Unmap the ring and close the packet socket. */
+    void close();
+
+    /**
+     * @brief Wait up to @p timeout_ms for the next filled block.
+     *
+     * On success every UDP datagram of the block is appended to @p datagrams
+     * and true is returned; the caller must call release_block() once it no
+     * longer needs the views.
+     */
+    bool next_block(std::vector<DatagramView>& datagrams, int timeout_ms);
+
+    /** @brief Hand the block returned by next_block() back to the kernel. */
+    void release_block();
+
+    /** @brief Return frames the kernel dropped because the ring was full. */
+    uint64_t kernel_drops();
+
+  private:
+    int resolve_interface_index() const;
+    void attach_filter();
+
+    Options options_;
+    int socket_fd_ = -1;
+    uint8_t* ring_ = nullptr;
+    size_t ring_size_ = 0;
+    size_t current_block_ = 0;
+    bool block_held_ = false;
+    uint64_t kernel_drops_ = 0;
+};
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,154 @@
+/**
+ * @file datagram_pool.h
+ * @brief Fixed-size datagram slot pool shared between the receiver and the parser.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Handle to one received datagram that still lives in its pool slot.
+ */
+struct DatagramRef {
+    /** @brief Pool slot holding the datagram. */
+    uint32_t slot = 0;
+
+    /** @brief Offset of the payload inside the slot (after the transport header). */
+    uint32_t payload_offset = 0;
+
+    /** @brief Payload length in bytes. */
+    uint32_t payload_size = 0;
+
+    /** @brief Kernel arrival time in nanoseconds since the Unix epoch (0 when not recorded). */
+    uint64_t arrival_ns = 0;
+};
+
+/**
+ * @brief Occupancy and recycling counters for a DatagramPool.
+ */
+struct DatagramPoolStats {
+    /** @brief Total number of slots in the pool. */
+    size_t slot_count = 0;
+
+    /** @brief Usable bytes per slot. */
+    size_t slot_size = 0;
+
+    /** @brief Slots currently held by the receiver, queued, or being decoded. */
+    size_t slots_in_use = 0;
+
+    /** @brief Highest slots_in_use observed since construction. */
+    size_t peak_slots_in_use = 0;
+
+    /** @brief Datagrams published to the consumer. */
+    uint64_t published = 0;
+
+    /** @brief Slots returned to the free list after decoding. */
+    uint64_t recycled = 0;
+
+    /** @brief Times the receiver found no free slot and had to back off. */
+    uint64_t exhausted = 0;
+};
+
+/**
+ * @brief Slab allocator of fixed-size datagram slots.
+ *
+ * The receiver acquires free slots in bulk, lets `recvmmsg` write straight
+ * into them, and publishes filled slots through a single-producer /
+ * single-consumer ready queue. The collector drains the queue, parses the
+ * payloads in place, and recycles the slots in bulk. The bulk free-list
+ * operations take a lock; the ready queue is single-producer/single-consumer
+ * and its consumer side only takes an uncontended lock so the producer can
+ * reclaim the oldest entries on overflow.
+ */
+class DatagramPool {
+  public:
+    /** @brief Allocate @p slot_count slots of at least @p slot_size bytes each. */
+    DatagramPool(size_t slot_count, size_t slot_size);
+
+    /** @brief Return the writable storage of @p slot. */
+    uint8_t* slot_data(uint32_t slot) { return storage_.get() + slot * slot_stride_; }
+
+    /** @brief Return the storage of @p slot. */
+    const uint8_t* slot_data(uint32_t slot) const {
+        return storage_.get() + slot * slot_stride_;
+    }
+
+    /** @brief Return the payload bytes referenced by @p ref. */
+    const uint8_t* payload(const DatagramRef& ref) const {
+        return slot_data(ref.slot) + ref.payload_offset;
+    }
+
+    /** @brief Return the usable bytes per slot. */
+    size_t slot_size() const { return slot_size_; }
+
+    /** @brief Return the total number of slots. */
+    size_t slot_count() const { return slot_count_; }
+
+    /** @brief Take up to @p max_count free slots and return how many were taken. */
+    size_t acquire(uint32_t* slots, size_t max_count);
+
+    /** @brief Return slots to the free list. */
+    void recycle(const uint32_t* slots, size_t count);
+
+    /** @brief Return decoded datagrams to the free list. */
+    void recycle(const std::vector<DatagramRef>& refs);
+
+    /** @brief Hand filled slots to the consumer (producer thread only). */
+    void publish(const DatagramRef* refs, size_t count);
+
+    /** @brief Append every published datagram to @p out (consumer thread only). */
+    size_t drain(std::vector<DatagramRef>& out);
+
+    /**
+     * @brief Take back up to @p max_count of the oldest published, undrained datagrams.
+     *
+     * Used by the producer to make room under the drop-oldest overflow policy;
+     * the returned slots are still held and can be refilled directly.
+     */
+    size_t reclaim_oldest(DatagramRef* refs, size_t max_count);
+
+    /** @brief Return payload bytes published but not yet drained or reclaimed. */
+    size_t pending_bytes() const {
+        const size_t consumed = consumed_bytes_.load(std::memory_order_acquire);
+        const size_t published = published_bytes_.load(std::memory_order_acquire);
+        return published > consumed ? published - consumed : 0;
+    }
+
+    /** @brief Record that the producer had to wait for a free slot. */
+    void note_exhausted() { exhausted_.fetch_add(1, std::memory_order_relaxed); }
+
+    /** @brief Return a snapshot of the pool counters. */
+    DatagramPoolStats stats() const;
+
+  private:
+    size_t slot_count_;
+    size_t slot_size_;
+    size_t slot_stride_;
+    std::unique_ptr<uint8_t[]> storage_;
+
+    mutable std::mutex free_mutex_;
+    std::vector<uint32_t> free_slots_;
+    size_t peak_in_use_ = 0;
+    uint64_t recycled_ = 0;
+
+    // Ready queue; it can never hold more than slot_count_ entries.
+    std::unique_ptr<DatagramRef[]> ready_;
+    std::mutex ready_mutex_;
+    alignas(64) std::atomic<size_t> ready_head_{0};
+    alignas(64) std::atomic<size_t> ready_tail_{0};
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<size_t> published_bytes_{0};
+    std::atomic<size_t> consumed_bytes_{0};
+    std::atomic<uint64_t> exhausted_{0};
+};
+
+}  // namespace nalu_event_collector
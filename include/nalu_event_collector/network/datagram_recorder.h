@@ -0,0 +1,130 @@
+/**
+ * @file datagram_recorder.h
+ * @brief Always-on recording of received datagrams into a memory-mapped file ring.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nalu_event_collector/config/datagram_recorder_config.h"
+#include "nalu_event_collector/input/capture_format.h"
+#include "nalu_event_collector/network/datagram_view.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Counters of a DatagramRecorder.
+ */
+struct DatagramRecorderStats {
+    /** @brief Datagrams written to the file ring. */
+    uint64_t recorded_datagrams = 0;
+
+    /** @brief Datagram bytes (transport header included) written to the file ring. */
+    uint64_t recorded_bytes = 0;
+
+    /** @brief Datagrams not recorded because a staging ring was full. */
+    uint64_t dropped_datagrams = 0;
+
+    /** @brief Datagram bytes not recorded because a staging ring was full. */
+    uint64_t dropped_bytes = 0;
+
+    /** @brief Older records overwritten by the file ring. */
+    uint64_t overwritten_datagrams = 0;
+
+    /** @brief Bytes of the file ring currently holding records. */
+    uint64_t bytes_in_use = 0;
+};
+
+/**
+ * @brief Records complete datagrams into a preallocated, memory-mapped file ring.
+ *
+ * Each receive shard copies its datagrams, with a length and timestamp
+ * record in front, into its own lock-free staging ring; record() never
+ * waits, takes no lock, and makes no system call, and datagrams that do not
+ * fit are counted and skipped. A writer thread moves the staged records into
+ * the file ring, so page faults and writeback on a slow disk only ever stall
+ * that thread. The file ring overwrites its oldest records when full and
+ * always describes whole records in its header, so the file can be replayed
+ * with ReplaySource (format `raw`) even after the process died.
+ */
+class DatagramRecorder {
+  public:
+    /**
+     * @brief Create and preallocate the ring file and one staging ring per shard.
+     *
+     * @throws std::invalid_argument for a zero file or staging size.
+     * @throws std::runtime_error when the file cannot be created or mapped.
+     */
+    DatagramRecorder(const DatagramRecorderConfig& config, size_t shard_count);
+
+    /** @brief Stop the writer thread and unmap the ring file. */
+    ~DatagramRecorder();
+
+    DatagramRecorder(const DatagramRecorder&) = delete;
+    DatagramRecorder& operator=(const DatagramRecorder&) = delete;
+
+    /** @brief Start the writer thread. */
+    void start();
+
+    /** @brief Write out everything staged, then stop the writer thread. */
+    void stop();
+
+    /**
+     * @brief Stage @p count datagrams received by shard @p shard.
+     *
+     * Only the receive thread of @p shard may call this. Datagrams without an
+     * arrival time are stamped with the current wall-clock time.
+     */
+    void record(size_t shard, const DatagramView* datagrams, size_t count);
+
+    /** @brief Return recorder counters. */
+    DatagramRecorderStats stats() const;
+
+    /** @brief Return the ring file path. */
+    const std::string& path() const { return path_; }
+
+  private:
+    struct Staging {
+        explicit Staging(size_t size) : storage(new uint8_t[size]), capacity(size) {}
+
+        std::unique_ptr<uint8_t[]> storage;
+        size_t capacity;
+        alignas(64) std::atomic<size_t> write_index{0};
+        size_t cached_read_index = 0;
+        std::atomic<uint64_t> dropped_datagrams{0};
+        std::atomic<uint64_t> dropped_bytes{0};
+        alignas(64) std::atomic<size_t> read_index{0};
+    };
+
+    void writerLoop();
+    bool drain(Staging& staging);
+    void append(const CaptureRecordHeader& record, const Staging& staging, size_t index);
+    void advanceHead();
+    void publishHeader();
+
+    std::string path_;
+    std::vector<std::unique_ptr<Staging>> staging_;
+    uint8_t* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    CaptureRingHeader* ring_ = nullptr;
+    uint8_t* data_ = nullptr;
+    size_t data_size_ = 0;
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+    std::atomic<uint64_t> recorded_datagrams_{0};
+    std::atomic<uint64_t> recorded_bytes_{0};
+    std::atomic<uint64_t> overwritten_{0};
+    std::atomic<uint64_t> bytes_in_use_{0};
+    uint64_t reported_drops_ = 0;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+}  // namespace nalu_event_collector
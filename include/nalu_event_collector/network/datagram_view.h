@@ -0,0 +1,37 @@
+/**
+ * @file datagram_view.h
+ * @brief Non-owning view of one received UDP datagram.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Points at one complete datagram (transport header plus payload).
+ *
+ * Receive backends fill views that point into their own storage (a socket
+ * batch buffer, a memory-mapped ring block, ...); the view is only valid until
+ * the backend reuses that storage.
+ */
+struct DatagramView {
+    /** @brief First byte of the 16-byte transport header. */
+    const uint8_t* data = nullptr;
+
+    /** @brief Datagram length in bytes, including the transport header. */
+    size_t size = 0;
+
+    /** @brief Sender IPv4 address in host byte order (0 when the backend cannot tell). */
+    uint32_t source_address = 0;
+
+    /** @brief Sender UDP port. */
+    uint16_t source_port = 0;
+
+    /** @brief Kernel arrival time in nanoseconds since the Unix epoch (0 when not recorded). */
+    uint64_t arrival_ns = 0;
+};
+
+}  // namespace nalu_event_collector
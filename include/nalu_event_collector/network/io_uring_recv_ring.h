@@ -0,0 +1,133 @@
+/**
+ * @file io_uring_recv_ring.h
+ * @brief io_uring multishot `recvmsg` reader backed by a provided buffer ring.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "nalu_event_collector/network/datagram_view.h"
+
+struct io_uring_sqe;
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Receives datagrams from one UDP socket through io_uring.
+ *
+ * A single multishot `recvmsg` request stays armed on the socket. The kernel
+ * picks a buffer from a registered buffer ring for every datagram and posts a
+ * completion, so the receive thread only reaps completions and hands buffers
+ * back in bulk. The ring is driven through raw system calls; no liburing is
+ * required.
+ *
+ * open() throws std::system_error when the running kernel lacks io_uring,
+ * provided buffer rings, or the extended wait argument. next_batch() throws
+ * std::system_error when the kernel rejects multishot `recvmsg`. Callers treat
+ * both as "unsupported" and fall back to the socket API.
+ */
+class IoUringRecvRing {
+  public:
+    /**
+     * @brief Buffer ring parameters.
+     */
+    struct Options {
+        /** @brief Number of provided receive buffers (rounded up to a power of two). */
+        size_t buffer_count = 1024;
+
+        /** @brief Largest datagram that fits in a buffer without truncation. */
+        size_t max_datagram_size = 1040;
+
+        /** @brief Reserve room for the `SO_RXQ_OVFL` control message and track the socket drop counter. */
+        bool receive_drop_counter = false;
+
+        /** @brief Reserve room for the `SO_TIMESTAMPNS` control message and fill arrival times. */
+        bool receive_timestamps = false;
+    };
+
+    /** @brief Create a closed ring with the given options. */
+    explicit IoUringRecvRing(Options options);
+
+    /** @brief Cancel the receive request and release the ring. */
+    ~IoUringRecvRing();
+
+    IoUringRecvRing(const IoUringRecvRing&) = delete;
+    IoUringRecvRing& operator=(const IoUringRecvRing&) = delete;
+
+    /** @brief Set up the ring, register the buffers, and arm multishot `recvmsg` on @p socket_fd. */
+    void open(int socket_fd);
+
+    /** @brief Unregister the buffers and tear the ring down. */
+    void close();
+
+    /**
+     * @brief Wait up to @p timeout_ms for completions and append every received datagram.
+     *
+     * Returns true when at least one datagram was appended. The views point
+     * into provided buffers that stay owned by the caller until
+     * release_batch() returns them to the kernel.
+     */
+    bool next_batch(std::vector<DatagramView>& datagrams, int timeout_ms);
+
+    /** @brief Return the buffers behind the last next_batch() to the kernel. */
+    void release_batch();
+
+    /** @brief Return how often the kernel ran out of provided buffers. */
+    uint64_t buffer_stalls() const { return buffer_stalls_; }
+
+    /** @brief Return the latest cumulative `SO_RXQ_OVFL` drop counter reported by the kernel. */
+    uint32_t socket_drop_counter() const { return socket_drop_counter_; }
+
+  private:
+    void register_buffers();
+    void arm_receive();
+    void cancel_receive();
+    size_t control_size() const;
+    void read_control(uint8_t* control, size_t size, DatagramView& datagram);
+    void submit(const io_uring_sqe& entry);
+    int enter(unsigned int to_submit, unsigned int min_complete, int timeout_ms);
+
+    Options options_;
+    int ring_fd_ = -1;
+    int socket_fd_ = -1;
+    bool armed_ = false;
+
+    // Submission and completion queues shared with the kernel.
+    uint8_t* sq_ring_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    uint8_t* cq_ring_ = nullptr;
+    size_t cq_ring_size_ = 0;
+    void* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+    unsigned int* sq_head_ = nullptr;
+    unsigned int* sq_tail_ = nullptr;
+    unsigned int* sq_mask_ = nullptr;
+    unsigned int* sq_array_ = nullptr;
+    unsigned int* cq_head_ = nullptr;
+    unsigned int* cq_tail_ = nullptr;
+    unsigned int* cq_mask_ = nullptr;
+    void* cqes_ = nullptr;
+
+    // Provided buffer ring and the buffers it hands out.
+    void* buffer_ring_ = nullptr;
+    size_t buffer_ring_size_ = 0;
+    uint8_t* buffers_ = nullptr;
+    size_t buffers_size_ = 0;
+    size_t buffer_size_ = 0;
+    size_t buffer_count_ = 0;
+    uint16_t buffer_tail_ = 0;
+    bool buffers_registered_ = false;
+    std::vector<uint16_t> held_buffers_;
+
+    msghdr message_{};
+    uint64_t buffer_stalls_ = 0;
+    uint32_t socket_drop_counter_ = 0;
+};
+
+}  // namespace nalu_event_collector
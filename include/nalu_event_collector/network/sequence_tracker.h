@@ -0,0 +1,112 @@
+/**
+ * @file sequence_tracker.h
+ * @brief Per-source datagram sequence tracking and loss accounting.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "nalu_event_collector/network/datagram_view.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Sequence-continuity counters, either for one source or summed over sources.
+ */
+struct SequenceStats {
+    /** @brief Number of distinct sources observed. */
+    size_t sources = 0;
+
+    /** @brief Datagrams whose sequence number was inspected. */
+    uint64_t received = 0;
+
+    /** @brief Forward jumps that skipped at least one sequence number. */
+    uint64_t gaps = 0;
+
+    /** @brief Sequence numbers skipped by gaps and not (yet) filled by late arrivals. */
+    uint64_t missing = 0;
+
+    /** @brief Datagrams whose sequence number was already seen. */
+    uint64_t duplicates = 0;
+
+    /** @brief Datagrams that arrived after a higher sequence number and filled a gap. */
+    uint64_t reordered = 0;
+
+    /** @brief Backward jumps too large for reordering, treated as a sender restart. */
+    uint64_t restarts = 0;
+};
+
+/**
+ * @brief Sequence state and counters of one source address.
+ */
+struct SourceSequenceStats {
+    /** @brief Source IPv4 address in host byte order. */
+    uint32_t address = 0;
+
+    /** @brief Source UDP port. */
+    uint16_t port = 0;
+
+    /** @brief Sequence number expected next from this source. */
+    uint64_t expected_next = 0;
+
+    /** @brief Counters for this source; `sources` is always 1. */
+    SequenceStats stats;
+};
+
+/**
+ * @brief Decodes a sequence counter from the transport header and tracks continuity.
+ *
+ * Each source keeps the highest sequence number seen plus a 64-entry history
+ * window, so a datagram that arrives late inside the window is recognised as
+ * reordered (and no longer counted missing) and a repeated one as a duplicate.
+ * Counters wrap at the configured field width.
+ *
+ * observe() is called by one receive thread; the stats accessors may be called
+ * from any thread.
+ */
+class SequenceTracker {
+  public:
+    /**
+     * @brief Track the big-endian counter of @p field_width bytes at @p field_offset.
+     *
+     * @throws std::invalid_argument if the width is not 1, 2, 4, or 8 bytes or
+     * the field does not fit in the transport header.
+     */
+    SequenceTracker(size_t field_offset, size_t field_width);
+
+    /** @brief Account for a batch of validated datagrams. */
+    void observe(const DatagramView* datagrams, size_t count);
+
+    /** @brief Return counters summed over every source. */
+    SequenceStats stats() const;
+
+    /** @brief Return the state and counters of every source. */
+    std::vector<SourceSequenceStats> source_stats() const;
+
+    /** @brief Forget every source and reset all counters. */
+    void reset();
+
+  private:
+    struct SourceState {
+        uint64_t highest = 0;
+        uint64_t window = 0;
+        SequenceStats stats;
+    };
+
+    uint64_t read_sequence(const uint8_t* header) const;
+    void observe_one(SourceState& state, uint64_t sequence);
+
+    size_t field_offset_;
+    size_t field_width_;
+    uint64_t sequence_mask_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, SourceState> sources_;
+};
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,31 @@
+/**
+ * @file transport_header.h
+ * @brief Helpers for the fixed 16-byte transport header in front of every datagram.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nalu_event_collector {
+
+/** @brief Size of the transport header that precedes the payload of every datagram. */
+constexpr size_t kTransportHeaderSize = 16;
+
+/**
+ * @brief Validate the transport header of @p datagram and return the payload size it announces.
+ *
+ * Returns false (and logs a warning) when the datagram is shorter than the
+ * header or its big-endian length field disagrees with @p size.
+ */
+bool validate_transport_header(const uint8_t* datagram, size_t size, uint16_t& payload_size);
+
+/** @brief Read the big-endian board ID of @p width bytes at @p offset of the transport header. */
+uint64_t read_board_id(const uint8_t* datagram, size_t offset, size_t width);
+
+/** @brief Format a host-order IPv4 address and port as `a.b.c.d:port`. */
+std::string format_source(uint32_t address, uint16_t port);
+
+}  // namespace nalu_event_collector
@@ -1,46 +1,167 @@
 /**
  * @file udp_data_buffer.h
- * @brief Thread-safe raw byte buffer used between UDP reception and parsing.
+ * @brief Single-producer/single-consumer byte ring used between UDP reception and parsing.
  */
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <vector>
 
+#include "nalu_event_collector/data/arrival_mark.h"
+
 namespace nalu_event_collector {
 
 /**
- * @brief Bounded FIFO-style byte buffer for raw UDP payload data.
+ * @brief Bounded FIFO byte buffer for raw UDP payload data.
+ *
+ * Storage is one preallocated contiguous ring. Exactly one thread may append
+ * (the receiver) and exactly one thread may read (the collector). Appends copy
+ * each payload with a single memcpy and publish a whole batch with one atomic
+ * store; readers obtain a lock-free ReadView of everything published so far and
+ * hand the space back with releaseRead().
+ *
+ * The producer also records where every appended segment ends, so an
+ * overflow policy can discard whole datagrams instead of cutting one apart.
+ * With arrival tracking enabled it additionally queues each segment's kernel
+ * arrival time for the consumer, which collects the marks of its current
+ * claim with takeArrivals(). The marks double as datagram length records for
+ * datagram-aligned parsing.
  */
 class UdpDataBuffer {
   public:
+    /** @brief What appendBatch() does when the segments do not fit. */
+    enum class OverflowPolicy {
+        /** @brief Invoke the overflow callback and throw std::overflow_error. */
+        Throw,
+        /** @brief Keep the buffered bytes and discard the segments that do not fit. */
+        DropNewest,
+        /**
+         * @brief Discard the oldest buffered datagrams to make room.
+         *
+         * Bytes claimed by the consumer cannot be discarded, so while a claim is
+         * held this falls back to DropNewest; claim bounded prefixes with
+         * acquireRead(size_t) to keep that window short.
+         */
+        DropOldest,
+        /** @brief Wait for the consumer to free space, then drop the newest on timeout. */
+        Block,
+    };
+
+    /** @brief Counters describing data lost to overflow. */
+    struct OverflowStats {
+        /** @brief Appends that had to discard data (or throw) because they did not fit. */
+        uint64_t overflows = 0;
+
+        /** @brief Datagrams (appended segments) discarded by the policy. */
+        uint64_t dropped_datagrams = 0;
+
+        /** @brief Bytes discarded by the policy. */
+        uint64_t dropped_bytes = 0;
+    };
+
+    /** @brief One contiguous byte range handed to appendBatch(). */
+    struct Segment {
+        const uint8_t* data;
+        size_t size;
+        uint64_t arrival_ns = 0;
+    };
+
+    /**
+     * @brief Read-only view of buffered bytes, split in two at the ring wrap point.
+     *
+     * The view stays valid until releaseRead() is called.
+     */
+    struct ReadView {
+        const uint8_t* first = nullptr;
+        size_t first_size = 0;
+        const uint8_t* second = nullptr;
+        size_t second_size = 0;
+
+        /** @brief Return the total number of bytes covered by the view. */
+        size_t size() const { return first_size + second_size; }
+
+        /** @brief Return true when the view covers no bytes. */
+        bool empty() const { return size() == 0; }
+    };
+
     /** @brief Construct a buffer with a fixed byte capacity. */
     explicit UdpDataBuffer(size_t size);
 
-    /** @brief Append a byte range to the buffer. */
+    /** @brief Append a byte range to the buffer (producer thread only). */
     void append(const uint8_t* data, size_t size);
 
-    /** @brief Pop one byte from the front of the buffer if available. */
+    /** @brief Append several byte ranges and publish them together (producer thread only). */
+    void appendBatch(const Segment* segments, size_t count);
+
+    /** @brief Claim every currently published byte without copying (consumer thread only). */
+    ReadView acquireRead();
+
+    /**
+     * @brief Claim at most @p max_bytes of the oldest published bytes (consumer thread only).
+     *
+     * With arrival tracking the claim ends on a segment boundary, so it may
+     * stop short of @p max_bytes, or pass it when the first segment is longer.
+     * Keeping claims short leaves the unclaimed bytes to drop-oldest.
+     */
+    ReadView acquireRead(size_t max_bytes);
+
+    /** @brief Return the bytes covered by the last acquireRead() to the producer. */
+    void releaseRead();
+
+    /**
+     * @brief Append the arrival marks of the bytes claimed by the last acquireRead() (consumer thread only).
+     *
+     * Offsets are relative to the start of the claimed view. Segments whose
+     * mark did not fit in the arrival queue are attributed to the next mark.
+     */
+    void takeArrivals(std::vector<ArrivalMark>& marks);
+
+    /** @brief Queue the arrival time of every appended segment; call before the producer starts. */
+    void enableArrivalTracking();
+
+    /** @brief Return true when arrival times are queued for the consumer. */
+    bool isArrivalTrackingEnabled() const { return arrivals_ != nullptr; }
+
+    /** @brief Pop one byte from the front of the buffer if available (consumer thread only). */
     bool pop(uint8_t& byte);
 
     /** @brief Return the number of buffered bytes. */
     size_t size() const;
 
-    /** @brief Return all currently buffered bytes and clear the buffer. */
+    /** @brief Return the fixed byte capacity. */
+    size_t capacity() const { return capacity_; }
+
+    /** @brief Return all currently buffered bytes as a copy and clear the buffer. */
     std::vector<uint8_t> getAllBytes();
 
     /** @brief Block until at least @p min_count bytes are available. */
     void waitForBytes(size_t min_count);
 
-    /** @brief Set a callback invoked before throwing on overflow. */
+    /** @brief Block until at least @p min_count bytes are available or @p max_wait elapses; return whether they are. */
+    bool waitForBytes(size_t min_count, std::chrono::microseconds max_wait);
+
+    /** @brief Set a callback invoked on the producer thread whenever an append does not fit. */
     void setOverflowCallback(std::function<void()> callback);
 
+    /** @brief Select the overflow policy; call before the producer starts. */
+    void setOverflowPolicy(OverflowPolicy policy,
+                           std::chrono::milliseconds block_timeout = std::chrono::milliseconds(100));
+
+    /** @brief Return the active overflow policy. */
+    OverflowPolicy getOverflowPolicy() const { return overflow_policy_; }
+
+    /** @brief Return the overflow counters. */
+    OverflowStats getOverflowStats() const;
+
     /** @brief Return true when the buffer is empty. */
     bool isEmpty() const;
 
@@ -48,10 +169,64 @@ class UdpDataBuffer {
     bool isFull() const;
 
   private:
-    std::deque<uint8_t> buffer_;
+    void writeAt(size_t index, const uint8_t* data, size_t size);
+    void publish(size_t write_index);
+    void pushRecord(size_t end_index);
+    void pushArrival(size_t end_index, uint64_t arrival_ns);
+    size_t claimEnd(size_t read_index, size_t limit, size_t write_index) const;
+    size_t handleOverflow(const Segment* segments,
+                          size_t count,
+                          size_t requested,
+                          size_t used,
+                          bool& keep_rest);
+    bool waitForSpace(size_t requested);
+    size_t dropOldest(size_t requested);
+    size_t dropNewest(const Segment* segments, size_t count, size_t free_bytes);
+    void releaseTo(size_t read_index);
+
+    std::unique_ptr<uint8_t[]> storage_;
     size_t capacity_;
+
+    // Monotonic byte counters; ring offsets are taken modulo capacity_.
+    alignas(64) std::atomic<size_t> write_index_{0};
+    alignas(64) std::atomic<size_t> read_index_{0};
+    size_t claimed_index_ = 0;
+    size_t claimed_start_ = 0;
+
+    // Ring of segment end indices, owned by the producer. Entries at or
+    // behind read_index_ are stale and skipped lazily.
+    std::unique_ptr<size_t[]> records_;
+    size_t record_capacity_;
+    size_t record_head_ = 0;
+    size_t record_tail_ = 0;
+
+    struct ArrivalRecord {
+        size_t end_index;
+        uint64_t arrival_ns;
+    };
+
+    // Producer-to-consumer queue of segment arrival times (arrival tracking only).
+    std::unique_ptr<ArrivalRecord[]> arrivals_;
+    size_t arrival_capacity_ = 0;
+    std::atomic<size_t> arrival_head_{0};
+    std::atomic<size_t> arrival_tail_{0};
+
+    OverflowPolicy overflow_policy_ = OverflowPolicy::Throw;
+    std::chrono::milliseconds block_timeout_{100};
+    bool overflowing_ = false;
+    std::atomic<uint64_t> overflows_{0};
+    std::atomic<uint64_t> dropped_datagrams_{0};
+    std::atomic<uint64_t> dropped_bytes_{0};
+
+    // Serialises drop-oldest against consumer claims; only taken under that policy.
+    std::mutex claim_mutex_;
+    bool claim_active_ = false;
+
+    std::atomic<int> waiters_{0};
+    std::atomic<int> space_waiters_{0};
     mutable std::mutex mutex_;
     std::condition_variable cv_;
+    std::condition_variable space_cv_;
     std::function<void()> overflow_callback_;
 };
 
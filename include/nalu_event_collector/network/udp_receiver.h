@@ -6,12 +6,29 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
 
 #include "nalu_event_collector/config/udp_receiver_config.h"
+#include "nalu_event_collector/input/input_source.h"
+#include "nalu_event_collector/network/af_packet_ring.h"
+#include "nalu_event_collector/network/datagram_recorder.h"
+#include "nalu_event_collector/network/datagram_pool.h"
+#include "nalu_event_collector/network/datagram_view.h"
+#include "nalu_event_collector/network/io_uring_recv_ring.h"
+#include "nalu_event_collector/network/sequence_tracker.h"
+#include "nalu_event_collector/network/transport_header.h"
 #include "nalu_event_collector/network/udp_data_buffer.h"
 
 namespace nalu_event_collector {
@@ -21,44 +38,249 @@ namespace nalu_event_collector {
  *
  * The receiver strips the fixed transport header currently expected by the
  * collector and exposes the remaining payload stream to downstream parsing
- * code.
+ * code. When a sequence field is configured, the header's counter is also
+ * tracked per source to account for lost, duplicated, and reordered datagrams.
+ *
+ * The receiver can run several shards, each with its own socket, receive
+ * thread, and buffer: either several `SO_REUSEPORT` sockets on one port or
+ * one socket per configured port.
+ *
+ * A full shard buffer or pool never stops reception: the configured overflow
+ * policy drops the newest or oldest data, or blocks for a bounded time, and
+ * the losses are counted in the shard stats.
+ *
+ * Datagrams are read through the regular socket API, from a TPACKET_V3
+ * memory-mapped ring per shard (`af_packet`), or from io_uring multishot
+ * `recvmsg` completions (`io_uring`). Shards whose kernel lacks io_uring
+ * support fall back to the socket API.
+ *
+ * Socket-based backends enable `SO_RXQ_OVFL` and read the kernel's per-socket
+ * drop counter from the control messages of received datagrams. With
+ * autotuning enabled, every newly reported drop doubles the socket receive
+ * buffer up to the configured maximum. When arrival timestamps are enabled,
+ * `SO_TIMESTAMPNS` (or the TPACKET_V3 frame time for `af_packet`) stamps every
+ * datagram with its kernel arrival time.
+ *
+ * With demultiplexing enabled, each shard routes datagrams by sender address
+ * or by a board ID in the transport header into per-stream byte buffers, so
+ * boards sharing a port never interleave inside one stream. Streams are
+ * created on the first datagram of a new sender, up to a fixed limit per
+ * shard; datagrams from further senders are dropped and counted.
+ *
+ * With the recorder enabled, every received datagram is also copied into a
+ * DatagramRecorder file ring without ever blocking the receive threads.
+ *
+ * UdpReceiver is the live InputSource of the Collector.
  */
-class UdpReceiver {
+class UdpReceiver : public InputSource {
   public:
-    /** @brief Construct a receiver from explicit socket parameters. */
+    /** @brief Construct a single-socket receiver from explicit socket parameters. */
     UdpReceiver(const std::string& address,
                 uint16_t port,
                 size_t buffer_size = 1024 * 1024 * 100,
                 size_t max_packet_size = 1040,
-                int timeout_sec = 10);
+                int timeout_sec = 10,
+                size_t recv_batch_size = 32);
 
     /** @brief Construct a receiver from a configuration object. */
     explicit UdpReceiver(const UdpReceiverConfig& config);
 
-    /** @brief Stop any running receive loop and release the socket. */
-    ~UdpReceiver();
+    /** @brief Stop any running receive loop and release the sockets. */
+    ~UdpReceiver() override;
+
+    /** @brief Start one UDP receive thread per shard. */
+    void start() override;
 
-    /** @brief Start the UDP receive thread. */
-    void start();
+    /** @brief Stop the UDP receive threads and close the sockets. */
+    void stop() override;
 
-    /** @brief Stop the UDP receive thread and close the socket. */
-    void stop();
+    /** @brief Return the number of receive shards. */
+    size_t getShardCount() const override { return shards_.size(); }
 
-    /** @brief Access the owned raw byte buffer. */
+    /** @brief Access the raw byte buffer of the first shard. */
     UdpDataBuffer& getDataBuffer();
 
+    /** @brief Access the raw byte buffer of shard @p shard. */
+    UdpDataBuffer& getDataBuffer(size_t shard) override;
+
+    /** @brief Enable pooled zero-copy reception with @p slot_count slots per shard (0 derives it). */
+    void enableDatagramPool(size_t slot_count = 0);
+
+    /** @brief Return the datagram pool of @p shard, or nullptr when pooled reception is disabled. */
+    DatagramPool* getDatagramPool(size_t shard = 0) override;
+
+    /** @brief Return pool occupancy and recycle counters summed over all shards. */
+    DatagramPoolStats getDatagramPoolStats() const override;
+
+    /** @brief Return traffic counters for every shard. */
+    std::vector<UdpShardStats> getShardStats() const override;
+
+    /** @brief Return payload bytes received by all shards and not yet drained. */
+    size_t getBufferedBytes() const override;
+
+    /**
+     * @brief Block until at least @p min_bytes are buffered across all shards.
+     *
+     * Returns true when the threshold was reached and false when @p max_wait
+     * elapsed first or the receiver was stopped.
+     */
+    bool waitForData(size_t min_bytes, std::chrono::microseconds max_wait) override;
+
+    /**
+     * @brief Return true when kernel arrival times are recorded.
+     *
+     * Arrival times travel with pooled datagrams and, for the byte ring, as
+     * arrival marks retrieved with UdpDataBuffer::takeArrivals().
+     */
+    bool isArrivalTimestampingEnabled() const override;
+
+    /** @brief Return true when datagrams are split into per-sender streams. */
+    bool isDemuxEnabled() const override { return demux_ != Demux::None; }
+
+    /** @brief Return the number of streams shard @p shard has created so far. */
+    size_t getStreamCount(size_t shard) const override;
+
+    /** @brief Access the byte buffer of stream @p stream in shard @p shard. */
+    UdpDataBuffer& getStreamBuffer(size_t shard, size_t stream) override;
+
+    /** @brief Return the label (`address:port` or `board N`) of stream @p stream in shard @p shard. */
+    const std::string& getStreamLabel(size_t shard, size_t stream) const override;
+
+    /** @brief Return traffic counters for every stream of every shard. */
+    std::vector<UdpStreamStats> getStreamStats() const override;
+
+    /** @brief Return true when transport-header sequence tracking is enabled. */
+    bool isSequenceTrackingEnabled() const override;
+
+    /** @brief Return sequence-continuity counters summed over all shards and sources. */
+    SequenceStats getSequenceStats() const override;
+
+    /** @brief Return sequence state and counters for every source seen by any shard. */
+    std::vector<SourceSequenceStats> getSourceSequenceStats() const;
+
+    /** @brief Return true when received datagrams are recorded into a file ring. */
+    bool isRecording() const { return recorder_ != nullptr; }
+
+    /** @brief Return recorder counters (all zero when recording is disabled). */
+    DatagramRecorderStats getRecorderStats() const;
+
   private:
-    void initSocket();
-    void receiveLoop();
+    enum class Backend {
+        Socket,
+        AfPacket,
+        IoUring,
+    };
+
+    enum class Demux {
+        None,
+        Source,
+        BoardId,
+    };
+
+    struct Stream {
+        Stream(uint64_t stream_key, std::string stream_label, size_t buffer_size)
+            : key(stream_key), label(std::move(stream_label)), data_buffer(buffer_size) {}
+
+        uint64_t key;
+        std::string label;
+        UdpDataBuffer data_buffer;
+        std::vector<UdpDataBuffer::Segment> segments;
+        uint64_t batch_bytes = 0;
+        std::atomic<uint64_t> datagrams{0};
+        std::atomic<uint64_t> bytes{0};
+    };
+
+    struct Shard {
+        Shard(uint16_t shard_port, size_t buffer_size)
+            : port(shard_port), data_buffer(buffer_size) {}
+
+        uint16_t port;
+        size_t index = 0;
+        int socket_fd = -1;
+        std::thread thread;
+        UdpDataBuffer data_buffer;
+        std::unique_ptr<DatagramPool> datagram_pool;
+        std::unique_ptr<AfPacketRing> af_packet_ring;
+        std::unique_ptr<IoUringRecvRing> io_uring_ring;
+        std::unique_ptr<SequenceTracker> sequence_tracker;
+        std::vector<UdpDataBuffer::Segment> segments;
+        std::vector<DatagramView> accepted;
+        std::vector<DatagramView> recorded;
+        std::vector<DatagramRef> refs;
+        std::vector<uint32_t> slots;
+        std::atomic<uint64_t> datagrams{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> malformed{0};
+        std::atomic<uint64_t> ring_drops{0};
+        std::atomic<uint64_t> socket_drops{0};
+        std::atomic<size_t> socket_receive_buffer{0};
+        uint32_t socket_drop_counter = 0;
+        size_t requested_receive_buffer = 0;
+        bool receive_buffer_capped = false;
+        std::atomic<uint64_t> dropped_datagrams{0};
+        std::atomic<uint64_t> dropped_bytes{0};
+        std::vector<DatagramRef> reclaimed;
+
+        // Streams are only added by the receive thread; readers see the first
+        // stream_count entries, which are never moved or removed.
+        std::unique_ptr<std::unique_ptr<Stream>[]> streams;
+        std::atomic<size_t> stream_count{0};
+        std::unordered_map<uint64_t, Stream*> stream_index;
+        std::vector<Stream*> touched_streams;
+        bool stream_limit_logged = false;
+    };
+
+    static Backend parseBackend(const std::string& backend);
+    static UdpDataBuffer::OverflowPolicy parseOverflowPolicy(const std::string& policy);
+    static Demux parseDemux(const std::string& demux);
+
+    void initSocket(Shard& shard);
+    void setReceiveBuffer(Shard& shard, size_t bytes);
+    void noteSocketDrops(Shard& shard, uint32_t counter);
+    void initAfPacketRing(Shard& shard);
+    void initIoUringRing(Shard& shard);
+    void runSocketLoop(Shard& shard);
+    void receiveLoop(Shard& shard);
+    void receiveLoopBatched(Shard& shard);
+    void receiveLoopPooled(Shard& shard);
+    void receiveLoopAfPacket(Shard& shard);
+    void receiveLoopIoUring(Shard& shard);
+    void deliverBatch(Shard& shard, const DatagramView* datagrams, size_t count);
+    size_t acquireSlots(Shard& shard, uint32_t* slots, size_t needed);
+    void deliverStreams(Shard& shard, uint64_t& batch_bytes);
+    Stream* findStream(Shard& shard, const DatagramView& datagram);
+    void noteDropped(Shard& shard, uint64_t datagrams, uint64_t bytes);
+    void notifyData();
 
     std::string address_;
-    uint16_t port_;
-    int socket_fd_;
-    std::thread receiver_thread_;
     std::atomic<bool> running_;
-    UdpDataBuffer data_buffer_;
+    std::vector<std::unique_ptr<Shard>> shards_;
     size_t max_packet_size_;
     int timeout_sec_;
+    size_t recv_batch_size_;
+    bool reuse_port_;
+    Backend backend_;
+    UdpDataBuffer::OverflowPolicy overflow_policy_;
+    std::chrono::milliseconds overflow_block_timeout_;
+    size_t socket_receive_buffer_ = 0;
+    bool socket_receive_buffer_force_ = false;
+    bool socket_receive_buffer_autotune_ = false;
+    size_t socket_receive_buffer_max_ = 0;
+    bool arrival_timestamps_ = false;
+    bool datagram_records_ = false;
+    Demux demux_ = Demux::None;
+    size_t board_id_offset_ = 4;
+    size_t board_id_width_ = 1;
+    size_t max_streams_ = 0;
+    size_t stream_buffer_size_ = 0;
+
+    std::atomic<int> data_waiters_{0};
+    std::atomic<size_t> data_threshold_{0};
+    std::mutex data_mutex_;
+    std::condition_variable data_cv_;
+    std::unique_ptr<DatagramRecorder> recorder_;
+    AfPacketRing::Options af_packet_options_;
+    size_t io_uring_buffer_count_ = 1024;
 };
 
 }  // namespace nalu_event_collector
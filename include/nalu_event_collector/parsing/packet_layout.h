@@ -0,0 +1,114 @@
+/**
+ * @file packet_layout.h
+ * @brief Compile-time firmware packet layouts and their specialized field decoder.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "nalu_event_collector/data/packet.h"
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Layout of the standard 74-byte Nalu packet (the PacketParserConfig defaults).
+ *
+ * A layout is a type with the constexpr members below; decode_fields()
+ * specialized on it has every offset, mask, and shift folded in.
+ */
+struct Nalu74Layout {
+    /** @brief Raw packet size in bytes. */
+    static constexpr size_t packet_size = 74;
+
+    /** @brief Start marker bytes. */
+    static constexpr std::array<uint8_t, 1> start_marker = {0x0E};
+
+    /** @brief Stop marker bytes. */
+    static constexpr std::array<uint8_t, 2> stop_marker = {0xFA, 0x5A};
+
+    /** @brief Channel mask. */
+    static constexpr uint8_t chan_mask = 0x3F;
+
+    /** @brief Channel shift. */
+    static constexpr uint8_t chan_shift = 0;
+
+    /** @brief Absolute-window mask. */
+    static constexpr uint8_t abs_wind_mask = 0x3F;
+
+    /** @brief Event-window mask. */
+    static constexpr uint8_t evt_wind_mask = 0x3F;
+
+    /** @brief Event-window shift. */
+    static constexpr uint8_t evt_wind_shift = 6;
+
+    /** @brief Timing mask. */
+    static constexpr uint16_t timing_mask = 0xFFF;
+
+    /** @brief Timing shift. */
+    static constexpr uint8_t timing_shift = 12;
+};
+
+/**
+ * @brief Decode the fields of the packet at @p slot into @p packet for @p Layout.
+ *
+ * Matches PacketParser's generic decoding; header, footer, info, and parser
+ * index are left to the caller.
+ */
+template <typename Layout>
+inline void decode_fields(const uint8_t* slot, Packet& packet) {
+    constexpr size_t channel_offset = Layout::start_marker.size();
+    constexpr size_t timing_offset = channel_offset + 1;
+    constexpr size_t window_offset = timing_offset + 4;
+    constexpr size_t samples_offset = window_offset + 2;
+    static_assert(samples_offset + sizeof(packet.raw_samples) + Layout::stop_marker.size() <=
+                      Layout::packet_size,
+                  "Packet layout is too small for its fields");
+
+    packet.channel =
+        static_cast<uint8_t>((slot[channel_offset] >> Layout::chan_shift) & Layout::chan_mask);
+
+    const uint16_t trigger_time_1 =
+        static_cast<uint16_t>((slot[timing_offset] << 8) | slot[timing_offset + 1]);
+    const uint16_t trigger_time_2 =
+        static_cast<uint16_t>((slot[timing_offset + 2] << 8) | slot[timing_offset + 3]);
+    packet.trigger_time =
+        (trigger_time_1 << Layout::timing_shift) | (trigger_time_2 & Layout::timing_mask);
+
+    packet.logical_position = static_cast<uint16_t>(
+        ((slot[window_offset] & Layout::abs_wind_mask) << (8 - Layout::evt_wind_shift)) |
+        ((slot[window_offset + 1] >> Layout::evt_wind_shift) & Layout::evt_wind_mask));
+    packet.physical_position =
+        static_cast<uint16_t>(slot[window_offset + 1] & Layout::abs_wind_mask);
+
+    std::memcpy(packet.raw_samples, slot + samples_offset, sizeof(packet.raw_samples));
+}
+
+/** @brief Return true when the runtime parameters describe exactly @p Layout. */
+template <typename Layout>
+inline bool matches_layout(size_t packet_size,
+                           const std::vector<uint8_t>& start_marker,
+                           const std::vector<uint8_t>& stop_marker,
+                           uint8_t chan_mask,
+                           uint8_t chan_shift,
+                           uint8_t abs_wind_mask,
+                           uint8_t evt_wind_mask,
+                           uint8_t evt_wind_shift,
+                           uint16_t timing_mask,
+                           uint8_t timing_shift) {
+    return packet_size == Layout::packet_size &&
+           start_marker == std::vector<uint8_t>(Layout::start_marker.begin(),
+                                                Layout::start_marker.end()) &&
+           stop_marker ==
+               std::vector<uint8_t>(Layout::stop_marker.begin(), Layout::stop_marker.end()) &&
+           chan_mask == Layout::chan_mask && chan_shift == Layout::chan_shift &&
+           abs_wind_mask == Layout::abs_wind_mask && evt_wind_mask == Layout::evt_wind_mask &&
+           evt_wind_shift == Layout::evt_wind_shift && timing_mask == Layout::timing_mask &&
+           timing_shift == Layout::timing_shift;
+}
+
+}  // namespace nalu_event_collector
@@ -7,20 +7,64 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "nalu_event_collector/config/packet_parser_config.h"
+#include "nalu_event_collector/data/arrival_mark.h"
 #include "nalu_event_collector/data/packet.h"
+#include "nalu_event_collector/parsing/marker_validator.h"
+#include "nalu_event_collector/parsing/packet_layout.h"
+#include "nalu_event_collector/parsing/parse_worker_pool.h"
 
 namespace nalu_event_collector {
 
+/**
+ * @brief Cumulative counters of a PacketParser.
+ */
+struct PacketParserStats {
+    /** @brief Times the parser lost packet alignment and searched for the next packet. */
+    uint64_t resync_events = 0;
+
+    /** @brief Bytes skipped while resynchronizing. */
+    uint64_t resync_skipped_bytes = 0;
+};
+
 /**
  * @brief Incrementally parses a raw byte stream into Packet objects.
  *
  * The parser supports optional marker validation, carries partial-packet
  * leftovers across calls, and converts hardware byte fields into the collector
- * packet model.
+ * packet model. With integrity checks on, markers are validated for up to
+ * MarkerValidator::kMaxSlots packets at a time and only damaged or
+ * misaligned packets fall back to the per-packet checks.
+ *
+ * When a stop marker is missing, the parser resynchronizes: it scans ahead
+ * with `memchr` for the first byte of the start marker and accepts a
+ * candidate only if its own stop marker and those of the next
+ * `resync_confirm_packets` packets (as far as buffered) are in place.
+ *
+ * With the `auto` decoder, a parser whose parameters match a built-in
+ * firmware layout (currently Nalu74Layout) decodes whole runs of packets
+ * with decode_fields() specialized on that layout; any other layout uses
+ * the generic decoder driven by the runtime parameters.
+ *
+ * With `parse_threads` above 1, a batch of at least `parallel_min_bytes` is
+ * cut into one chunk per thread at validated packet boundaries (stride
+ * boundaries without integrity checks), the chunks are decoded on a
+ * ParseWorkerPool, and the results are appended in stream order with
+ * consecutive `parser_index` values. With integrity checks the calling
+ * thread re-parses the bytes around each cut serially and keeps a chunk's
+ * packets only from where the two parses agree, so packets and statistics
+ * match a serial parse. Copies of a parser share its pool. Batches parsed
+ * with arrival marks are always parsed serially.
+ *
+ * process_datagrams() parses each datagram of a batch on its own, using the
+ * datagram boundaries recorded by the receiver: no partial packet is carried
+ * between datagrams or calls, and a misaligned datagram cannot disturb the
+ * ones after it. Large batches are split across the pool at datagram
+ * boundaries.
  */
 class PacketParser {
   public:
@@ -37,7 +81,11 @@ class PacketParser {
                  uint8_t timing_shift = 12,
                  bool check_packet_integrity = false,
                  uint16_t constructed_packet_header = 0xAAAA,
-                 uint16_t constructed_packet_footer = 0xFFFF);
+                 uint16_t constructed_packet_footer = 0xFFFF,
+                 size_t resync_confirm_packets = 1,
+                 const std::string& decoder = "auto",
+                 size_t parse_threads = 1,
+                 size_t parallel_min_bytes = 4 * 1024 * 1024);
 
     /** @brief Construct a parser from a configuration object. */
     explicit PacketParser(const PacketParserConfig& config);
@@ -102,11 +150,163 @@ class PacketParser {
     /** @brief Set the stop marker bytes. */
     void set_stop_marker(const std::vector<uint8_t>& stop_marker);
 
+    /** @brief Return true when packets are decoded by a compile-time layout specialization. */
+    bool is_decoder_specialized() const { return decoder_ != Decoder::Generic; }
+
+    /** @brief Return resynchronization counters accumulated since construction. */
+    const PacketParserStats& get_stats() const { return stats_; }
+
     /** @brief Parse @p byte_stream into zero or more Packet objects. */
     std::vector<Packet> process_stream(const std::vector<uint8_t>& byte_stream);
 
+    /**
+     * @brief Parse @p size bytes at @p data in place, appending decoded packets to @p packets.
+     *
+     * Nothing is allocated once @p packets has grown to its steady-state
+     * capacity, so a caller that clears and reuses it parses allocation-free.
+     *
+     * @return The number of packets appended.
+     */
+    size_t process_stream(const uint8_t* data, size_t size, std::vector<Packet>& packets);
+
+    /**
+     * @brief Parse two spans as one stream, e.g. the two halves of a wrapped ring buffer.
+     *
+     * The packet straddling the spans is stitched through the leftover buffer,
+     * so neither span is copied.
+     *
+     * @return The number of packets appended.
+     */
+    size_t process_stream(const uint8_t* first,
+                          size_t first_size,
+                          const uint8_t* second,
+                          size_t second_size,
+                          std::vector<Packet>& packets);
+
+    /**
+     * @brief Parse like process_stream() and record when each packet arrived.
+     *
+     * @p marks describe the arrival times of @p data in increasing offset
+     * order. For every appended packet, the arrival time of the datagram
+     * that completed it is appended to @p arrivals, which is first padded
+     * with zeros to the size of @p packets. Packets with no covering mark
+     * get 0.
+     *
+     * @return The number of packets appended.
+     */
+    size_t process_stream(const uint8_t* data,
+                          size_t size,
+                          const ArrivalMark* marks,
+                          size_t mark_count,
+                          std::vector<Packet>& packets,
+                          std::vector<uint64_t>& arrivals);
+
+    /**
+     * @brief Parse two spans as one stream and record arrivals.
+     *
+     * Mark offsets are relative to the start of @p first and continue into @p second.
+     *
+     * @return The number of packets appended.
+     */
+    size_t process_stream(const uint8_t* first,
+                          size_t first_size,
+                          const uint8_t* second,
+                          size_t second_size,
+                          const ArrivalMark* marks,
+                          size_t mark_count,
+                          std::vector<Packet>& packets,
+                          std::vector<uint64_t>& arrivals);
+
+    /**
+     * @brief Parse every datagram of a batch independently of the others.
+     *
+     * @p marks give the end offset of each datagram, relative to the start of
+     * @p first and continuing into @p second; bytes after the last mark are
+     * parsed as one more datagram. A datagram split across the spans is
+     * copied once into scratch space. Bytes of a datagram that do not form a
+     * whole packet are dropped and counted as skipped; leftovers from
+     * process_stream() are neither used nor touched.
+     *
+     * @return The number of packets appended.
+     */
+    size_t process_datagrams(const uint8_t* first,
+                             size_t first_size,
+                             const uint8_t* second,
+                             size_t second_size,
+                             const ArrivalMark* marks,
+                             size_t mark_count,
+                             std::vector<Packet>& packets);
+
+    /**
+     * @brief Parse every datagram of a batch independently and record arrivals.
+     *
+     * Each appended packet gets the arrival time of its datagram's mark in
+     * @p arrivals, which is first padded with zeros to the size of @p packets.
+     *
+     * @return The number of packets appended.
+     */
+    size_t process_datagrams(const uint8_t* first,
+                             size_t first_size,
+                             const uint8_t* second,
+                             size_t second_size,
+                             const ArrivalMark* marks,
+                             size_t mark_count,
+                             std::vector<Packet>& packets,
+                             std::vector<uint64_t>& arrivals);
+
   private:
+    enum class Decoder { Generic, Nalu74 };
+
     static std::vector<uint8_t> hexStringToBytes(const std::string& hex);
+    static bool parse_decoder(const std::string& decoder);
+
+    void select_decoder();
+    void prepare_chunk_parsers(size_t chunks);
+    void merge_chunk(std::vector<Packet>& packets, size_t k);
+    void append_chunk_packets(std::vector<Packet>& packets, size_t k, size_t begin, size_t end);
+    void stitch_chunks(std::vector<Packet>& packets,
+                       const uint8_t* byte_stream,
+                       size_t size,
+                       size_t& i,
+                       uint8_t& error_code);
+    void process_datagram(std::vector<Packet>& packets, const uint8_t* data, size_t size);
+    void process_datagram_range(std::vector<Packet>& packets,
+                                const uint8_t* first,
+                                size_t first_size,
+                                const uint8_t* second,
+                                size_t second_size,
+                                const ArrivalMark* marks,
+                                size_t begin_datagram,
+                                size_t end_datagram,
+                                size_t mark_count,
+                                std::vector<uint64_t>* arrivals);
+    bool process_datagrams_parallel(std::vector<Packet>& packets,
+                                    const uint8_t* first,
+                                    size_t first_size,
+                                    const uint8_t* second,
+                                    size_t second_size,
+                                    const ArrivalMark* marks,
+                                    size_t mark_count);
+    void process_parallel(std::vector<Packet>& packets,
+                          const uint8_t* byte_stream,
+                          size_t size,
+                          size_t& i,
+                          uint8_t& error_code);
+    size_t find_chunk_start(const uint8_t* byte_stream,
+                            size_t aligned_from,
+                            size_t target,
+                            size_t size) const;
+    void decode_run(std::vector<Packet>& packets,
+                    const uint8_t* byte_stream,
+                    size_t& i,
+                    size_t count,
+                    uint8_t error_code);
+    template <typename Layout>
+    void decode_run_as(std::vector<Packet>& packets,
+                       const uint8_t* byte_stream,
+                       size_t& i,
+                       size_t count,
+                       uint8_t error_code);
 
     void process_packet(std::vector<Packet>& packets,
                         const uint8_t* byte_stream,
@@ -116,21 +316,24 @@ class PacketParser {
                       size_t index,
                       const uint8_t* marker,
                       size_t marker_len);
+    size_t find_resync_point(const uint8_t* byte_stream, size_t from, size_t size) const;
     void process_byte_stream_segment_with_checks(std::vector<Packet>& packets,
                                                  const uint8_t* byte_stream,
+                                                 size_t size,
                                                  size_t& i,
                                                  uint8_t& error_code,
                                                  size_t start_marker_len,
                                                  size_t stop_marker_len);
-    void process_byte_stream_segment_without_checks(std::vector<Packet>& packets,
-                                                    const uint8_t* byte_stream,
-                                                    size_t& i,
-                                                    uint8_t& error_code,
-                                                    size_t start_marker_len,
-                                                    size_t stop_marker_len);
+    void process_validated_segments(std::vector<Packet>& packets,
+                                    const uint8_t* byte_stream,
+                                    size_t size,
+                                    size_t& i,
+                                    uint8_t& error_code,
+                                    size_t start_marker_len,
+                                    size_t stop_marker_len);
+    void stamp_arrivals(const std::vector<Packet>& packets, size_t end_offset);
     void process_leftovers(std::vector<Packet>& data_list,
                            const uint8_t* byte_stream,
-                           size_t byte_stream_len,
                            size_t leftovers_size,
                            size_t packet_size,
                            size_t start_marker_len,
@@ -147,10 +350,42 @@ class PacketParser {
     bool check_packet_integrity_;
     std::vector<uint8_t> start_marker_;
     std::vector<uint8_t> stop_marker_;
+    MarkerValidator marker_validator_;
     uint16_t packet_index_ = 0;
     std::vector<uint8_t> leftovers_;
+
+    // Holds the one datagram per batch that wraps around the end of the ring.
+    std::vector<uint8_t> datagram_scratch_;
+
+    // Arrival marks of the chunk being parsed; only set during the stamping overload.
+    const ArrivalMark* arrival_marks_ = nullptr;
+    size_t arrival_mark_count_ = 0;
+    size_t arrival_cursor_ = 0;
+    size_t arrival_base_ = 0;
+    std::vector<uint64_t>* arrivals_ = nullptr;
     uint16_t constructed_packet_header_;
     uint16_t constructed_packet_footer_;
+    size_t resync_confirm_packets_;
+    bool specialize_;
+    Decoder decoder_ = Decoder::Generic;
+    PacketParserStats stats_;
+
+    // Parallel parsing: one serial parser and output buffer per chunk, rebuilt
+    // from this parser whenever its layout changes.
+    size_t parallel_min_bytes_;
+    bool chunk_parser_ = false;
+    std::shared_ptr<ParseWorkerPool> parse_pool_;
+    std::vector<PacketParser> chunk_parsers_;
+    std::vector<std::vector<Packet>> chunk_packets_;
+    std::vector<size_t> chunk_bounds_;
+
+    // Where each packet of a chunk parser ended, with the resynchronizations
+    // counted by then, so checked chunks can be rejoined to the serial parse.
+    struct PacketEnd {
+        size_t end_offset;
+        uint64_t resync_events;
+    };
+    std::vector<PacketEnd> packet_ends_;
 };
 
 }  // namespace nalu_event_collector
@@ -0,0 +1,66 @@
+/**
+ * @file parse_worker_pool.h
+ * @brief Fixed-size thread pool that runs the chunks of one parse batch in parallel.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Runs indexed tasks on persistent worker threads plus the calling thread.
+ *
+ * run() hands out task indices to whichever participant is free and returns
+ * once every task has finished. Concurrent run() calls are serialized, so
+ * several parsers may share one pool.
+ */
+class ParseWorkerPool {
+  public:
+    /** @brief Start @p threads - 1 workers; the thread calling run() is the last one. */
+    explicit ParseWorkerPool(size_t threads);
+
+    /** @brief Stop and join the workers. */
+    ~ParseWorkerPool();
+
+    ParseWorkerPool(const ParseWorkerPool&) = delete;
+    ParseWorkerPool& operator=(const ParseWorkerPool&) = delete;
+
+    /** @brief Return the number of threads that take part in run(), the caller included. */
+    size_t size() const { return workers_.size() + 1; }
+
+    /**
+     * @brief Call @p task with every index in `[0, tasks)` and wait for all of them.
+     *
+     * The first exception thrown by a task is rethrown once all tasks have ended.
+     */
+    void run(size_t tasks, const std::function<void(size_t)>& task);
+
+  private:
+    void worker_loop();
+    void run_tasks();
+
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t task_count_ = 0;
+    std::atomic<size_t> next_task_{0};
+    size_t busy_workers_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace nalu_event_collector
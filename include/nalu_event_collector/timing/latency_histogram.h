@@ -0,0 +1,58 @@
+/**
+ * @file latency_histogram.h
+ * @brief Fixed-size log-linear histogram for latency percentiles.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace nalu_event_collector {
+
+/**
+ * @brief Records nanosecond latencies into log-linear buckets.
+ *
+ * Values below 16 ns get one bucket each; every larger power of two is split
+ * into 16 linear sub-buckets, so a reported percentile is never more than
+ * about 6% above the true value. Recording is O(1) and never allocates.
+ *
+ * The histogram is not synchronized; callers serialize access.
+ */
+class LatencyHistogram {
+  public:
+    /** @brief Add one latency sample in nanoseconds. */
+    void record(uint64_t latency_ns);
+
+    /** @brief Return the number of recorded samples. */
+    uint64_t count() const { return count_; }
+
+    /** @brief Return the largest recorded sample in nanoseconds. */
+    uint64_t max() const { return max_; }
+
+    /**
+     * @brief Return the latency in nanoseconds at or below which @p percentile percent of samples fall.
+     *
+     * Returns the upper bound of the bucket holding that sample (capped at
+     * max()), or 0 when nothing was recorded.
+     */
+    uint64_t percentile(double percentile) const;
+
+    /** @brief Forget every sample. */
+    void reset();
+
+  private:
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_upper_bound(size_t index);
+
+    std::array<uint64_t, kBucketCount> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t max_ = 0;
+};
+
+}  // namespace nalu_event_collector
@@ -9,14 +9,16 @@ print_help() {
     cat <<EOF
 Usage: ./scripts/run.sh <app> [app args...]
 
-Run one of the standalone example apps.
+Run one of the standalone example apps or tools.
 
 Available apps:
   collector_demo
+  board_emulator
 
 Examples:
   ./scripts/run.sh collector_demo
   ./scripts/run.sh collector_demo --background
+  ./scripts/run.sh board_emulator --rate 5000 --duration 10
 EOF
 }
 
@@ -32,6 +34,9 @@ case "$APP_NAME" in
     collector_demo)
         exec "$PROJECT_DIR/apps/examples/collector_demo/scripts/run.sh" "$@"
         ;;
+    board_emulator)
+        exec "$PROJECT_DIR/apps/tools/board_emulator/scripts/run.sh" "$@"
+        ;;
     -h|--help)
         print_help
         exit 0
@@ -5,10 +5,17 @@
 
 #include "nalu_event_collector/collector/collector.h"
 
+#include <pthread.h>
+#include <sched.h>
+
 #include <algorithm>
+#include <cstring>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -20,6 +27,14 @@ namespace {
 
 constexpr int kTableColumnWidth = 23;
 
+// How often the background loop looks for new streams while board workers
+// do the collecting.
+constexpr std::chrono::milliseconds kBoardDiscoveryInterval(10);
+
+// Under drop-oldest each claim covers at most this fraction of a ring, so the
+// producer can still discard older unclaimed datagrams while a claim is parsed.
+constexpr size_t kDropOldestClaimDivisor = 8;
+
 void print_table_separator(std::ostream& stream, size_t columns) {
     for (size_t i = 0; i < columns; ++i) {
         stream << '+'
@@ -46,19 +61,87 @@ std::string format_integer(size_t value) {
     return std::to_string(value);
 }
 
+// Arrival timestamps come from the kernel's CLOCK_REALTIME.
+uint64_t realtime_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+void record_latencies(LatencyHistogram& histogram,
+                      const std::vector<uint64_t>& arrivals,
+                      size_t first,
+                      uint64_t now_ns) {
+    for (size_t i = first; i < arrivals.size(); ++i) {
+        if (arrivals[i] != 0) {
+            histogram.record(now_ns > arrivals[i] ? now_ns - arrivals[i] : 0);
+        }
+    }
+}
+
+LatencyPercentiles summarize(const LatencyHistogram& histogram) {
+    LatencyPercentiles result;
+    result.samples = histogram.count();
+    result.p50_us = histogram.percentile(50.0) / 1e3;
+    result.p90_us = histogram.percentile(90.0) / 1e3;
+    result.p99_us = histogram.percentile(99.0) / 1e3;
+    result.max_us = histogram.max() / 1e3;
+    return result;
+}
+
+std::unique_ptr<InputSource> make_input_source(const CollectorConfig& config) {
+    // Datagram-aligned parsing needs the receiver to record datagram lengths.
+    UdpReceiverConfig receiver_config = config.udp_receiver;
+    receiver_config.datagram_records |= config.packet_parser.datagram_aligned;
+    if (config.input == "udp") {
+        return std::make_unique<UdpReceiver>(receiver_config);
+    }
+    if (config.input == "replay") {
+        return std::make_unique<ReplaySource>(config.replay, receiver_config);
+    }
+    throw std::invalid_argument("Invalid collector input: " + config.input);
+}
+
+std::unique_ptr<InputSource> require_input_source(std::unique_ptr<InputSource> source) {
+    if (!source) {
+        throw std::invalid_argument("Collector requires an input source");
+    }
+    return source;
+}
+
 }  // namespace
 
 Collector::Collector(const CollectorConfig& config)
-    : receiver_(config.udp_receiver),
-      parser_(config.packet_parser),
+    : Collector(config, make_input_source(config)) {}
+
+Collector::Collector(const CollectorConfig& config, std::unique_ptr<InputSource> source)
+    : source_(require_input_source(std::move(source))),
+      parsers_(source_->getShardCount(), PacketParser(config.packet_parser)),
       event_builder_(config.event_builder),
       running_(false),
       last_event_index_(0),
       cycle_count_(0),
-      sleep_time_us_(config.sleep_time_us) {
-    receiver_.getDataBuffer().setOverflowCallback([]() {
-        throw std::runtime_error("UdpDataBuffer overflow detected");
-    });
+      sleep_time_us_(config.sleep_time_us),
+      wakeup_min_bytes_(config.wakeup_min_bytes),
+      wakeup_max_wait_us_(config.wakeup_max_wait_us),
+      track_arrivals_(source_->isArrivalTimestampingEnabled()),
+      datagram_aligned_(config.packet_parser.datagram_aligned),
+      board_parser_(parsers_.front()),
+      event_builder_config_(config.event_builder),
+      board_workers_(config.board_workers),
+      board_worker_cpus_(config.board_worker_cpus),
+      board_stream_counts_(source_->getShardCount(), 0) {
+    if (board_workers_ && !source_->isDemuxEnabled()) {
+        throw std::invalid_argument("board_workers requires udp_receiver.demux");
+    }
+    if (config.event_merger.enabled) {
+        if (!source_->isDemuxEnabled()) {
+            throw std::invalid_argument("event_merger requires udp_receiver.demux");
+        }
+        merger_ = std::make_unique<EventMerger>(config.event_merger,
+                                                config.event_builder.max_trigger_time,
+                                                config.event_builder.clock_frequency);
+    }
 }
 
 Collector::~Collector() { stop(); }
@@ -69,7 +152,7 @@ void Collector::start() {
     }
 
     running_ = true;
-    receiver_.start();
+    source_->start();
     collector_thread_ = std::thread(&Collector::collectionLoop, this);
 }
 
@@ -79,41 +162,266 @@ void Collector::stop() {
     }
 
     running_ = false;
-    receiver_.stop();
+    source_->stop();
     if (collector_thread_.joinable()) {
         collector_thread_.join();
     }
+    for (auto& board : boards_) {
+        if (board->worker.joinable()) {
+            board->worker.join();
+        }
+    }
 }
 
-void Collector::collect() {
-    const auto start_time = std::chrono::steady_clock::now();
+size_t Collector::drain(UdpDataBuffer& data_buffer,
+                        DatagramPool* pool,
+                        PacketParser& parser,
+                        DrainScratch& scratch,
+                        std::vector<Packet>& packets,
+                        std::vector<uint64_t>& arrivals,
+                        double& udp_time,
+                        double& parse_time) {
     const auto udp_start = std::chrono::steady_clock::now();
-    std::vector<uint8_t> data = receiver_.getDataBuffer().getAllBytes();
-    const auto udp_end = std::chrono::steady_clock::now();
+    size_t data_size = 0;
+    UdpDataBuffer::ReadView view;
+    // Under drop-oldest the ring is drained in bounded claims, each released
+    // before the next, up to the bytes buffered on entry.
+    const size_t claim_limit =
+        data_buffer.getOverflowPolicy() == UdpDataBuffer::OverflowPolicy::DropOldest
+            ? data_buffer.capacity() / kDropOldestClaimDivisor
+            : std::numeric_limits<size_t>::max();
+    const size_t backlog = pool != nullptr ? 0 : data_buffer.size();
+    const auto claim = [&](size_t max_bytes) {
+        view = data_buffer.acquireRead(max_bytes);
+        if (!view.empty() && (track_arrivals_ || datagram_aligned_)) {
+            scratch.arrival_marks.clear();
+            data_buffer.takeArrivals(scratch.arrival_marks);
+        }
+        data_size += view.size();
+    };
+    if (pool != nullptr) {
+        scratch.ready_datagrams.clear();
+        pool->drain(scratch.ready_datagrams);
+        for (const auto& datagram : scratch.ready_datagrams) {
+            data_size += datagram.payload_size;
+        }
+        if (data_size == 0) {
+            pool->recycle(scratch.ready_datagrams);
+            return 0;
+        }
+    } else {
+        claim(claim_limit);
+        if (view.empty()) {
+            return 0;
+        }
+    }
+
+    const size_t first_packet = packets.size();
+    const PacketParserStats parser_stats = parser.get_stats();
+    const auto parse_start = std::chrono::steady_clock::now();
+    if (pool != nullptr) {
+        // Parse every datagram where recvmmsg left it, then recycle the slots.
+        for (const auto& datagram : scratch.ready_datagrams) {
+            const ArrivalMark mark{datagram.payload_size, datagram.arrival_ns};
+            if (datagram_aligned_ && track_arrivals_) {
+                parser.process_datagrams(pool->payload(datagram),
+                                         datagram.payload_size,
+                                         nullptr,
+                                         0,
+                                         &mark,
+                                         1,
+                                         packets,
+                                         arrivals);
+            } else if (datagram_aligned_) {
+                parser.process_datagrams(
+                    pool->payload(datagram), datagram.payload_size, nullptr, 0, &mark, 1, packets);
+            } else if (track_arrivals_) {
+                parser.process_stream(
+                    pool->payload(datagram), datagram.payload_size, &mark, 1, packets, arrivals);
+            } else {
+                parser.process_stream(pool->payload(datagram), datagram.payload_size, packets);
+            }
+        }
+        pool->recycle(scratch.ready_datagrams);
+    } else {
+        // Parse both ring segments where they are; the claim keeps the
+        // receiver off them until the ring space is handed back below.
+        // Datagram-aligned parsing falls back to the stream parser on
+        // buffers of a source that does not record datagram lengths.
+        const bool by_datagram = datagram_aligned_ && data_buffer.isArrivalTrackingEnabled();
+        while (true) {
+            if (by_datagram && track_arrivals_) {
+                parser.process_datagrams(view.first,
+                                         view.first_size,
+                                         view.second,
+                                         view.second_size,
+                                         scratch.arrival_marks.data(),
+                                         scratch.arrival_marks.size(),
+                                         packets,
+                                         arrivals);
+            } else if (by_datagram) {
+                parser.process_datagrams(view.first,
+                                         view.first_size,
+                                         view.second,
+                                         view.second_size,
+                                         scratch.arrival_marks.data(),
+                                         scratch.arrival_marks.size(),
+                                         packets);
+            } else if (track_arrivals_) {
+                parser.process_stream(view.first,
+                                      view.first_size,
+                                      view.second,
+                                      view.second_size,
+                                      scratch.arrival_marks.data(),
+                                      scratch.arrival_marks.size(),
+                                      packets,
+                                      arrivals);
+            } else {
+                parser.process_stream(
+                    view.first, view.first_size, view.second, view.second_size, packets);
+            }
+            data_buffer.releaseRead();
+            if (data_size >= backlog) {
+                break;
+            }
+            claim(std::min(claim_limit, backlog - data_size));
+            if (view.empty()) {
+                break;
+            }
+        }
+    }
+    const auto parse_end = std::chrono::steady_clock::now();
+
+    // Truncated datagram tails are skipped without a resync event, so either
+    // counter can move on its own.
+    if (parser.get_stats().resync_events != parser_stats.resync_events ||
+        parser.get_stats().resync_skipped_bytes != parser_stats.resync_skipped_bytes) {
+        std::lock_guard<std::mutex> lock(data_mutex_);
+        timing_data_.resync_events +=
+            parser.get_stats().resync_events - parser_stats.resync_events;
+        timing_data_.resync_skipped_bytes +=
+            parser.get_stats().resync_skipped_bytes - parser_stats.resync_skipped_bytes;
+    }
+
+    if (track_arrivals_) {
+        const uint64_t parsed_ns = realtime_ns();
+        std::lock_guard<std::mutex> lock(data_mutex_);
+        record_latencies(parse_latency_, arrivals, first_packet, parsed_ns);
+    }
 
-    const double udp_time = std::chrono::duration<double>(udp_end - udp_start).count();
-    const size_t data_size = data.size();
+    udp_time += std::chrono::duration<double>(parse_start - udp_start).count();
+    parse_time += std::chrono::duration<double>(parse_end - parse_start).count();
+    return data_size;
+}
 
-    if (data.empty()) {
+void Collector::collect() {
+    if (source_->isDemuxEnabled()) {
+        refresh_boards();
+        for (auto& board : boards_) {
+            if (!board->worker.joinable()) {
+                collect_board(*board);
+            }
+        }
         return;
     }
 
-    const auto parse_start = std::chrono::steady_clock::now();
-    std::vector<Packet> packets = parser_.process_stream(data);
-    const auto parse_end = std::chrono::steady_clock::now();
+    const auto start_time = std::chrono::steady_clock::now();
+    double udp_time = 0.0;
+    double parse_time = 0.0;
+    size_t data_size = 0;
+    std::vector<Packet>& packets = scratch_.packets;
+    std::vector<uint64_t>& arrivals = scratch_.arrivals;
+    packets.clear();
+    arrivals.clear();
+
+    // Every shard carries its own byte stream, so each keeps its own parser
+    // state; the decoded packets all feed the same event builder.
+    for (size_t shard = 0; shard < parsers_.size(); ++shard) {
+        data_size += drain(source_->getDataBuffer(shard),
+                           source_->getDatagramPool(shard),
+                           parsers_[shard],
+                           scratch_,
+                           packets,
+                           arrivals,
+                           udp_time,
+                           parse_time);
+    }
+
+    if (data_size == 0) {
+        return;
+    }
 
     if (packets.empty()) {
         return;
     }
 
     const auto event_start = std::chrono::steady_clock::now();
-    event_builder_.collect_events(packets);
+    if (track_arrivals_) {
+        event_builder_.collect_events(packets, arrivals);
+    } else {
+        event_builder_.collect_events(packets);
+    }
     const auto event_end = std::chrono::steady_clock::now();
-    const auto total_end = std::chrono::steady_clock::now();
+    const uint64_t built_ns = track_arrivals_ ? realtime_ns() : 0;
+
+    record_cycle(start_time,
+                 data_size,
+                 udp_time,
+                 parse_time,
+                 std::chrono::duration<double>(event_end - event_start).count(),
+                 arrivals,
+                 built_ns);
+}
+
+void Collector::collect_board(BoardPipeline& board) {
+    const auto start_time = std::chrono::steady_clock::now();
+    double udp_time = 0.0;
+    double parse_time = 0.0;
+    std::vector<Packet>& packets = board.scratch.packets;
+    std::vector<uint64_t>& arrivals = board.scratch.arrivals;
+    packets.clear();
+    arrivals.clear();
+
+    const size_t data_size = drain(board.data_buffer,
+                                   nullptr,
+                                   board.parser,
+                                   board.scratch,
+                                   packets,
+                                   arrivals,
+                                   udp_time,
+                                   parse_time);
+    if (data_size == 0 || packets.empty()) {
+        return;
+    }
 
+    const auto event_start = std::chrono::steady_clock::now();
+    if (track_arrivals_) {
+        board.event_builder.collect_events(packets, arrivals);
+    } else {
+        board.event_builder.collect_events(packets);
+    }
+    const auto event_end = std::chrono::steady_clock::now();
+    const uint64_t built_ns = track_arrivals_ ? realtime_ns() : 0;
+    board.packets.fetch_add(packets.size(), std::memory_order_relaxed);
+
+    record_cycle(start_time,
+                 data_size,
+                 udp_time,
+                 parse_time,
+                 std::chrono::duration<double>(event_end - event_start).count(),
+                 arrivals,
+                 built_ns);
+}
+
+void Collector::record_cycle(std::chrono::steady_clock::time_point start_time,
+                             size_t data_size,
+                             double udp_time,
+                             double parse_time,
+                             double event_time,
+                             const std::vector<uint64_t>& arrivals,
+                             uint64_t built_ns) {
+    const auto total_end = std::chrono::steady_clock::now();
     const double total_time = std::chrono::duration<double>(total_end - start_time).count();
-    const double parse_time = std::chrono::duration<double>(parse_end - parse_start).count();
-    const double event_time = std::chrono::duration<double>(event_end - event_start).count();
     const double data_rate = (data_size / (1024.0 * 1024.0)) / total_time;
 
     std::lock_guard<std::mutex> lock(data_mutex_);
@@ -126,6 +434,38 @@ void Collector::collect() {
     timing_data_.total_time = total_time;
     timing_data_.data_processed = data_size;
     timing_data_.data_rate = data_rate;
+    timing_data_.cumulative_udp_time += udp_time;
+    timing_data_.cumulative_parse_time += parse_time;
+    timing_data_.cumulative_event_time += event_time;
+    timing_data_.cumulative_data_processed += data_size;
+    timing_data_.wakeup_reason = wakeup_reason_;
+    if (source_->getDatagramPool() != nullptr) {
+        const DatagramPoolStats pool_stats = source_->getDatagramPoolStats();
+        timing_data_.pool_slots_in_use = pool_stats.slots_in_use;
+        timing_data_.pool_peak_slots_in_use = pool_stats.peak_slots_in_use;
+        timing_data_.pool_recycled_slots = pool_stats.recycled;
+    }
+    timing_data_.dropped_datagrams = 0;
+    timing_data_.dropped_bytes = 0;
+    timing_data_.socket_drops = 0;
+    for (const UdpShardStats& shard_stats : source_->getShardStats()) {
+        timing_data_.dropped_datagrams += shard_stats.dropped_datagrams;
+        timing_data_.dropped_bytes += shard_stats.dropped_bytes;
+        timing_data_.socket_drops += shard_stats.socket_drops;
+    }
+    if (track_arrivals_) {
+        record_latencies(build_latency_, arrivals, 0, built_ns);
+        timing_data_.arrival_to_parse = summarize(parse_latency_);
+        timing_data_.arrival_to_build = summarize(build_latency_);
+        timing_data_.arrival_to_delivery = summarize(delivery_latency_);
+    }
+    if (source_->isSequenceTrackingEnabled()) {
+        const SequenceStats sequence_stats = source_->getSequenceStats();
+        timing_data_.sequence_gaps = sequence_stats.gaps;
+        timing_data_.sequence_missing = sequence_stats.missing;
+        timing_data_.sequence_duplicates = sequence_stats.duplicates;
+        timing_data_.sequence_reordered = sequence_stats.reordered;
+    }
 
     ++cycle_count_;
     avg_data_rate_ += (data_rate - avg_data_rate_) / cycle_count_;
@@ -136,10 +476,103 @@ void Collector::collect() {
     avg_udp_time_ += (udp_time - avg_udp_time_) / cycle_count_;
 }
 
+void Collector::refresh_boards() {
+    for (size_t shard = 0; shard < board_stream_counts_.size(); ++shard) {
+        const size_t stream_count = source_->getStreamCount(shard);
+        for (size_t stream = board_stream_counts_[shard]; stream < stream_count; ++stream) {
+            auto board = std::make_unique<BoardPipeline>(shard,
+                                                         source_->getStreamBuffer(shard, stream),
+                                                         source_->getStreamLabel(shard, stream),
+                                                         board_parser_,
+                                                         event_builder_config_);
+            BoardPipeline& created = *board;
+            {
+                std::lock_guard<std::mutex> lock(data_mutex_);
+                boards_.push_back(std::move(board));
+                if (merger_) {
+                    merger_->add_board(created.label);
+                }
+            }
+            spdlog::info("Collecting {} on a dedicated board pipeline", created.label);
+        }
+        board_stream_counts_[shard] = stream_count;
+    }
+
+    if (running_ && board_workers_) {
+        for (size_t index = 0; index < boards_.size(); ++index) {
+            if (!boards_[index]->worker.joinable()) {
+                start_board_worker(*boards_[index], index);
+            }
+        }
+    }
+}
+
+void Collector::start_board_worker(BoardPipeline& board, size_t index) {
+    board.worker = std::thread(&Collector::boardLoop, this, std::ref(board));
+    if (board_worker_cpus_.empty()) {
+        return;
+    }
+
+    board.cpu = board_worker_cpus_[index % board_worker_cpus_.size()];
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(board.cpu, &cpus);
+    const int result = pthread_setaffinity_np(board.worker.native_handle(), sizeof(cpus), &cpus);
+    if (result != 0) {
+        spdlog::warn("Failed to pin the {} worker to CPU {}: {}",
+                     board.label,
+                     board.cpu,
+                     std::strerror(result));
+        board.cpu = -1;
+    }
+}
+
+void Collector::boardLoop(BoardPipeline& board) {
+    while (running_) {
+        if (wakeup_min_bytes_ > 0) {
+            board.data_buffer.waitForBytes(wakeup_min_bytes_, wakeup_max_wait_us_);
+            if (!running_) {
+                break;
+            }
+        }
+
+        collect_board(board);
+
+        if (wakeup_min_bytes_ == 0 && sleep_time_us_.count() > 0) {
+            std::this_thread::sleep_for(sleep_time_us_);
+        }
+    }
+}
+
 void Collector::collectionLoop() {
+    if (board_workers_) {
+        // Workers collect every board; this thread only turns new streams into boards.
+        while (running_) {
+            refresh_boards();
+            std::this_thread::sleep_for(kBoardDiscoveryInterval);
+        }
+        return;
+    }
+
     while (running_) {
+        if (wakeup_min_bytes_ > 0) {
+            const bool reached = source_->waitForData(wakeup_min_bytes_, wakeup_max_wait_us_);
+            if (!running_) {
+                break;
+            }
+            std::lock_guard<std::mutex> lock(data_mutex_);
+            wakeup_reason_ = reached ? WakeupReason::Threshold : WakeupReason::Timeout;
+            if (reached) {
+                ++timing_data_.threshold_wakeups;
+            } else {
+                ++timing_data_.timeout_wakeups;
+            }
+        }
+
         collect();
-        if (sleep_time_us_.count() > 0) {
+        wakeup_reason_ = WakeupReason::Polled;
+
+        if (wakeup_min_bytes_ == 0 && sleep_time_us_.count() > 0) {
             std::this_thread::sleep_for(sleep_time_us_);
         }
     }
@@ -191,11 +624,10 @@ CollectorTimingData Collector::get_timing_data() {
     return timing_data_;
 }
 
-std::pair<CollectorTimingData, std::vector<Event*>> Collector::get_data() {
-    std::lock_guard<std::mutex> lock(data_mutex_);
-
+std::vector<Event*> Collector::take_complete_events(EventBuilder& event_builder,
+                                                    size_t& last_event_index) {
     std::vector<Event*> new_events =
-        event_builder_.get_event_buffer().get_events_after_index_inclusive(last_event_index_);
+        event_builder.get_event_buffer().get_events_after_index_inclusive(last_event_index);
 
     std::vector<Event*> complete_events;
     complete_events.reserve(new_events.size());
@@ -206,12 +638,105 @@ std::pair<CollectorTimingData, std::vector<Event*>> Collector::get_data() {
     }
 
     log_skipped_incomplete_events(new_events, complete_events.size());
-    last_event_index_ += complete_events.size();
+    last_event_index += complete_events.size();
+    return complete_events;
+}
+
+std::pair<CollectorTimingData, std::vector<Event*>> Collector::get_data() {
+    std::lock_guard<std::mutex> lock(data_mutex_);
+
+    std::vector<Event*> complete_events;
+    if (merger_) {
+        std::vector<MergedEvent> merged;
+        merge_board_events(merged);
+        for (const auto& merged_event : merged) {
+            for (const auto& part : merged_event.parts) {
+                complete_events.push_back(part.event);
+            }
+        }
+    } else if (source_->isDemuxEnabled()) {
+        // Boards are returned one after the other; each board's events stay in order.
+        for (auto& board : boards_) {
+            std::vector<Event*> board_events =
+                take_complete_events(board->event_builder, board->last_event_index);
+            complete_events.insert(complete_events.end(), board_events.begin(), board_events.end());
+        }
+    } else {
+        complete_events = take_complete_events(event_builder_, last_event_index_);
+    }
+
+    record_delivery(complete_events);
     return {timing_data_, complete_events};
 }
 
+std::vector<MergedEvent> Collector::get_merged_events() {
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    if (!merger_) {
+        throw std::logic_error("The event merger is not enabled");
+    }
+
+    std::vector<MergedEvent> merged;
+    merge_board_events(merged);
+    std::vector<Event*> events;
+    for (const auto& merged_event : merged) {
+        for (const auto& part : merged_event.parts) {
+            events.push_back(part.event);
+        }
+    }
+    record_delivery(events);
+    return merged;
+}
+
+std::vector<BoardAlignment> Collector::get_board_alignment() {
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    return merger_ ? merger_->get_alignment() : std::vector<BoardAlignment>{};
+}
+
+void Collector::merge_board_events(std::vector<MergedEvent>& merged) {
+    // Events queued in the merger stay in their board's buffer until they are
+    // emitted; clear_events() only removes what has left the merger.
+    for (size_t index = 0; index < boards_.size(); ++index) {
+        BoardPipeline& board = *boards_[index];
+        merger_->push(index, take_complete_events(board.event_builder, board.last_event_index));
+    }
+    merger_->pop(merged);
+}
+
+void Collector::record_delivery(const std::vector<Event*>& events) {
+    if (!track_arrivals_ || events.empty()) {
+        return;
+    }
+    const uint64_t delivered_ns = realtime_ns();
+    for (const auto* event : events) {
+        if (event->last_arrival_ns != 0) {
+            delivery_latency_.record(
+                delivered_ns > event->last_arrival_ns ? delivered_ns - event->last_arrival_ns : 0);
+        }
+    }
+    timing_data_.arrival_to_delivery = summarize(delivery_latency_);
+}
+
+void Collector::reset_latency_stats() {
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    parse_latency_.reset();
+    build_latency_.reset();
+    delivery_latency_.reset();
+    timing_data_.arrival_to_parse = LatencyPercentiles{};
+    timing_data_.arrival_to_build = LatencyPercentiles{};
+    timing_data_.arrival_to_delivery = LatencyPercentiles{};
+}
+
 void Collector::clear_events() {
     std::lock_guard<std::mutex> lock(data_mutex_);
+    for (size_t index = 0; index < boards_.size(); ++index) {
+        BoardPipeline& board = *boards_[index];
+        const size_t released = board.last_event_index - (merger_ ? merger_->pending(index) : 0);
+        if (released > 0) {
+            board.last_event_index -=
+                board.event_builder.get_event_buffer().remove_events_before_index_exclusive(
+                    released);
+        }
+    }
     if (last_event_index_ == 0) {
         return;
     }
@@ -221,6 +746,21 @@ void Collector::clear_events() {
     last_event_index_ -= events_removed;
 }
 
+size_t Collector::get_board_count() {
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    return boards_.size();
+}
+
+std::string Collector::get_board_label(size_t board) {
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    return boards_.at(board)->label;
+}
+
+EventBuilder& Collector::get_board_event_builder(size_t board) {
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    return boards_.at(board)->event_builder;
+}
+
 void Collector::printPerformanceStats() {
     std::lock_guard<std::mutex> lock(data_mutex_);
 
@@ -241,6 +781,134 @@ void Collector::printPerformanceStats() {
                      format_fixed(avg_total_time_ * 1e6),
                      format_integer(static_cast<size_t>(avg_data_processed_))});
     print_table_separator(std::cout, 6);
+
+    const std::vector<UdpShardStats> shard_stats = source_->getShardStats();
+    uint64_t dropped_datagrams = 0;
+    for (const auto& stats : shard_stats) {
+        dropped_datagrams += stats.dropped_datagrams + stats.ring_drops + stats.socket_drops;
+    }
+    if (shard_stats.size() > 1 || dropped_datagrams > 0) {
+        std::cout << "Receive Shards (" << shard_stats.size() << ")\n";
+        print_table_separator(std::cout, 7);
+        print_table_row(
+            std::cout,
+            {"Shard", "Port", "Datagrams", "Bytes", "Malformed", "Kernel Drops", "Overflow Drops"});
+        for (size_t shard = 0; shard < shard_stats.size(); ++shard) {
+            print_table_row(std::cout,
+                            {format_integer(shard),
+                             format_integer(shard_stats[shard].port),
+                             format_integer(shard_stats[shard].datagrams),
+                             format_integer(shard_stats[shard].bytes),
+                             format_integer(shard_stats[shard].malformed_datagrams),
+                             format_integer(shard_stats[shard].ring_drops +
+                                            shard_stats[shard].socket_drops),
+                             format_integer(shard_stats[shard].dropped_datagrams)});
+        }
+        print_table_separator(std::cout, 7);
+    }
+
+    if (source_->isDemuxEnabled()) {
+        const std::vector<UdpStreamStats> stream_stats = source_->getStreamStats();
+        std::cout << "Boards (" << boards_.size() << ")\n";
+        print_table_separator(std::cout, 6);
+        print_table_row(std::cout,
+                        {"Board", "Shard", "Datagrams", "Packets", "Overflow Drops", "Worker CPU"});
+        for (const auto& board : boards_) {
+            UdpStreamStats stream;
+            for (const auto& stats : stream_stats) {
+                if (stats.shard == board->shard && stats.label == board->label) {
+                    stream = stats;
+                    break;
+                }
+            }
+            print_table_row(std::cout,
+                            {board->label,
+                             format_integer(board->shard),
+                             format_integer(stream.datagrams),
+                             format_integer(board->packets.load(std::memory_order_relaxed)),
+                             format_integer(stream.dropped_datagrams),
+                             board->cpu >= 0 ? std::to_string(board->cpu) : "-"});
+        }
+        print_table_separator(std::cout, 6);
+    }
+
+    if (merger_) {
+        const std::vector<BoardAlignment> alignment = merger_->get_alignment();
+        std::cout << "Event Merge (" << alignment.size() << " boards)\n";
+        print_table_separator(std::cout, 7);
+        print_table_row(
+            std::cout,
+            {"Board", "State", "Offset (us)", "Drift (ppm)", "Matched", "Unmatched", "Unaligned"});
+        for (const auto& board : alignment) {
+            print_table_row(std::cout,
+                            {board.label,
+                             board.reference ? "reference" : (board.locked ? "locked" : "searching"),
+                             format_fixed(board.offset_us),
+                             format_fixed(board.drift_ppm),
+                             format_integer(board.matched),
+                             format_integer(board.unmatched),
+                             format_integer(board.unaligned)});
+        }
+        print_table_separator(std::cout, 7);
+    }
+
+    if (source_->isSequenceTrackingEnabled()) {
+        const SequenceStats sequence_stats = source_->getSequenceStats();
+        std::cout << "Datagram Sequence (" << sequence_stats.sources << " sources)\n";
+        print_table_separator(std::cout, 6);
+        print_table_row(std::cout,
+                        {"Received", "Gaps", "Missing", "Duplicates", "Reordered", "Restarts"});
+        print_table_row(std::cout,
+                        {format_integer(sequence_stats.received),
+                         format_integer(sequence_stats.gaps),
+                         format_integer(sequence_stats.missing),
+                         format_integer(sequence_stats.duplicates),
+                         format_integer(sequence_stats.reordered),
+                         format_integer(sequence_stats.restarts)});
+        print_table_separator(std::cout, 6);
+    }
+
+    if (timing_data_.resync_events > 0) {
+        std::cout << "Stream Resync\n";
+        print_table_separator(std::cout, 2);
+        print_table_row(std::cout, {"Events", "Skipped Bytes"});
+        print_table_row(std::cout,
+                        {format_integer(timing_data_.resync_events),
+                         format_integer(timing_data_.resync_skipped_bytes)});
+        print_table_separator(std::cout, 2);
+    }
+
+    if (track_arrivals_) {
+        std::cout << "Arrival Latency (us)\n";
+        print_table_separator(std::cout, 6);
+        print_table_row(std::cout, {"Stage", "Samples", "p50", "p90", "p99", "Max"});
+        const std::pair<const char*, const LatencyHistogram*> stages[] = {
+            {"Parse", &parse_latency_},
+            {"Build", &build_latency_},
+            {"Delivery", &delivery_latency_},
+        };
+        for (const auto& stage : stages) {
+            const LatencyPercentiles latency = summarize(*stage.second);
+            print_table_row(std::cout,
+                            {stage.first,
+                             format_integer(latency.samples),
+                             format_fixed(latency.p50_us),
+                             format_fixed(latency.p90_us),
+                             format_fixed(latency.p99_us),
+                             format_fixed(latency.max_us)});
+        }
+        print_table_separator(std::cout, 6);
+    }
 }
 
+UdpReceiver& Collector::get_receiver() {
+    auto* receiver = dynamic_cast<UdpReceiver*>(source_.get());
+    if (receiver == nullptr) {
+        throw std::logic_error("The collector input source is not a UdpReceiver");
+    }
+    return *receiver;
+}
+
+std::vector<UdpShardStats> Collector::get_shard_stats() const { return source_->getShardStats(); }
+
 }  // namespace nalu_event_collector
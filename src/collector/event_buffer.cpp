@@ -171,7 +171,8 @@ std::vector<Event*> EventBuffer::get_events_after_index_inclusive(size_t index)
 
 void EventBuffer::add_packet(const Packet& packet,
                              bool& in_safety_buffer_zone,
-                             uint32_t& event_index) {
+                             uint32_t& event_index,
+                             uint64_t arrival_ns) {
     std::lock_guard<std::mutex> lock(buffer_mutex_);
 
     Event* matched_event = nullptr;
@@ -208,13 +209,13 @@ void EventBuffer::add_packet(const Packet& packet,
                                                  use_time_based_completion_,
                                                  expected_packet_count_,
                                                  warn_on_expected_overrun_);
-        new_event->add_packet(packet);
+        new_event->add_packet(packet, arrival_ns);
         add_event_helper(new_event);
         in_safety_buffer_zone = true;
         return;
     }
 
-    matched_event->add_packet(packet);
+    matched_event->add_packet(packet, arrival_ns);
 }
 
 void EventBuffer::clear() {
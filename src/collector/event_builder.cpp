@@ -68,6 +68,15 @@ void EventBuilder::collect_events(const std::vector<Packet>& packets) {
     }
 }
 
+void EventBuilder::collect_events(const std::vector<Packet>& packets,
+                                  const std::vector<uint64_t>& arrivals) {
+    for (size_t i = 0; i < packets.size(); ++i) {
+        const uint64_t arrival_ns = i < arrivals.size() ? arrivals[i] : 0;
+        event_buffer_.add_packet(packets[i], in_safety_buffer_zone_, event_index_, arrival_ns);
+        manage_safety_buffer();
+    }
+}
+
 void EventBuilder::manage_safety_buffer() {
     if (!in_safety_buffer_zone_) {
         return;
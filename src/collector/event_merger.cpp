@@ -0,0 +1,402 @@
+/**
+ * @file event_merger.cpp
+ * @brief Implements board alignment and the streaming k-way event merge.
+ */
+
+#include "nalu_event_collector/collector/event_merger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+
+namespace nalu_event_collector {
+
+namespace {
+
+// Reference events remembered for the coarse lock of the other boards.
+constexpr size_t kReferenceMarks = 512;
+
+// Queued board events scored against each lock candidate.
+constexpr size_t kLockCheckEvents = 32;
+
+int64_t steady_ns(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+}  // namespace
+
+EventMerger::EventMerger(const EventMergerConfig& config,
+                         uint32_t max_trigger_time,
+                         uint32_t clock_frequency)
+    : config_(config),
+      max_trigger_time_(max_trigger_time),
+      clock_frequency_(clock_frequency),
+      wait_ns_(static_cast<int64_t>(config.max_wait_us) * 1000),
+      lock_window_ns_(static_cast<int64_t>(config.lock_window_us) * 1000) {
+    if (max_trigger_time_ == 0) {
+        throw std::invalid_argument("EventMerger requires a non-zero max_trigger_time");
+    }
+    if (config_.channel_stride == 0) {
+        throw std::invalid_argument("EventMerger requires a non-zero channel_stride");
+    }
+    reference_marks_.reserve(kReferenceMarks);
+}
+
+size_t EventMerger::add_board(std::string label) {
+    Board board;
+    board.stats.label = label;
+    board.label = std::move(label);
+    boards_.push_back(std::move(board));
+    return boards_.size() - 1;
+}
+
+void EventMerger::push(size_t board, const std::vector<Event*>& events) {
+    if (events.empty()) {
+        return;
+    }
+    Board& target = boards_.at(board);
+    if (reference_ == SIZE_MAX) {
+        // The first board to deliver defines the global timeline: global == local.
+        reference_ = board;
+        target.locked = true;
+        target.stats.reference = true;
+        ++target.stats.locks;
+        spdlog::info("Event merge uses {} as the reference timeline", target.label);
+    }
+
+    for (Event* event : events) {
+        PendingEvent pending;
+        pending.event = event;
+        pending.local_time = unwrap(target, event->header.reference_time);
+        pending.global_time = target.locked ? to_global(target, pending.local_time) : 0;
+        pending.arrival_ns = event->first_arrival_ns;
+        pending.created_ns = steady_ns(event->get_creation_timestamp());
+        if (board == reference_) {
+            remember_reference(pending);
+        }
+        if (target.locked && target.queue.empty()) {
+            heap_.emplace(pending.global_time, board);
+        }
+        target.queue.push_back(pending);
+        ++target.stats.events;
+    }
+}
+
+size_t EventMerger::pop(std::vector<MergedEvent>& merged, bool flush) {
+    const size_t before = merged.size();
+    const int64_t now_ns = steady_ns(std::chrono::steady_clock::now());
+
+    // Boards without an alignment either lock now or give up on their oldest events.
+    for (size_t index = 0; index < boards_.size(); ++index) {
+        Board& board = boards_[index];
+        while (!board.locked && !board.queue.empty()) {
+            const bool expired = flush || board.queue.size() >= config_.max_pending_events ||
+                                 now_ns - board.queue.front().created_ns >= wait_ns_;
+            if (try_lock(index, expired)) {
+                break;
+            }
+            if (!expired) {
+                break;
+            }
+            emit_unaligned(index, merged);
+        }
+    }
+
+    while (!heap_.empty()) {
+        const HeapEntry top = heap_.top();
+        const Board& board = boards_[top.second];
+        if (!board.locked || board.queue.empty() ||
+            board.queue.front().global_time != top.first) {
+            heap_.pop();  // Stale entry from an earlier head.
+            continue;
+        }
+        if (!ready(top.first, now_ns, flush)) {
+            break;
+        }
+        emit_group(merged);
+    }
+    return merged.size() - before;
+}
+
+std::vector<BoardAlignment> EventMerger::get_alignment() const {
+    std::vector<BoardAlignment> result;
+    result.reserve(boards_.size());
+    for (const Board& board : boards_) {
+        BoardAlignment stats = board.stats;
+        stats.locked = board.locked;
+        stats.offset_ticks =
+            static_cast<int64_t>(std::llround(board.anchor_local - board.anchor_global));
+        stats.offset_us = clock_frequency_ == 0
+                              ? 0.0
+                              : static_cast<double>(stats.offset_ticks) * 1e6 / clock_frequency_;
+        stats.drift_ppm = (1.0 / board.rate - 1.0) * 1e6;
+        stats.pending = board.queue.size();
+        result.push_back(stats);
+    }
+    return result;
+}
+
+int64_t EventMerger::unwrap(Board& board, uint32_t trigger_time) {
+    trigger_time %= max_trigger_time_;
+    if (!board.started) {
+        board.started = true;
+        board.last_trigger_time = trigger_time;
+        board.local_time = trigger_time;
+        return board.local_time;
+    }
+
+    // Take the shorter way round the counter, so small reorderings step back.
+    int64_t delta = (static_cast<int64_t>(trigger_time) - board.last_trigger_time +
+                     max_trigger_time_) %
+                    max_trigger_time_;
+    if (delta > static_cast<int64_t>(max_trigger_time_ / 2)) {
+        delta -= max_trigger_time_;
+    }
+    board.last_trigger_time = trigger_time;
+    board.local_time += delta;
+    return board.local_time;
+}
+
+int64_t EventMerger::to_global(const Board& board, int64_t local_time) const {
+    return static_cast<int64_t>(std::llround(
+        board.anchor_global + (static_cast<double>(local_time) - board.anchor_local) * board.rate));
+}
+
+bool EventMerger::try_lock(size_t index, bool force) {
+    Board& board = boards_[index];
+    const PendingEvent& head = board.queue.front();
+
+    std::vector<int64_t> reference_times;
+    reference_times.reserve(reference_marks_.size());
+    for (const ReferenceMark& mark : reference_marks_) {
+        reference_times.push_back(mark.global_time);
+    }
+    std::sort(reference_times.begin(), reference_times.end());
+    const auto has_reference_near = [&](int64_t time) {
+        const auto found = std::lower_bound(
+            reference_times.begin(), reference_times.end(), time - config_.match_window);
+        return found != reference_times.end() && *found <= time + config_.match_window;
+    };
+
+    // Every reference event close enough in host time is a candidate for the
+    // head. Kernel arrival times are preferred because they do not depend on
+    // when each board's pipeline happened to run. Among the candidates, the
+    // one that also lines up the most other queued events wins, since trigger
+    // spacing is a far sharper signature than host time; host distance only
+    // breaks ties.
+    const ReferenceMark* best = nullptr;
+    size_t best_score = 0;
+    int64_t best_distance = std::numeric_limits<int64_t>::max();
+    const size_t checked = std::min(board.queue.size(), kLockCheckEvents);
+    for (const ReferenceMark& mark : reference_marks_) {
+        const int64_t distance =
+            head.arrival_ns != 0 && mark.arrival_ns != 0
+                ? std::llabs(static_cast<int64_t>(head.arrival_ns - mark.arrival_ns))
+                : std::llabs(head.created_ns - mark.created_ns);
+        if (distance > lock_window_ns_) {
+            continue;
+        }
+        size_t score = 0;
+        for (size_t i = 0; i < checked; ++i) {
+            const double elapsed =
+                static_cast<double>(board.queue[i].local_time - head.local_time) * board.rate;
+            score += has_reference_near(mark.global_time + std::llround(elapsed)) ? 1 : 0;
+        }
+        if (score > best_score || (score == best_score && distance < best_distance)) {
+            best = &mark;
+            best_score = score;
+            best_distance = distance;
+        }
+    }
+    if (best == nullptr) {
+        if (force) {
+            spdlog::debug("No reference event within {} us of {}'s event {}",
+                          config_.lock_window_us,
+                          board.label,
+                          head.event->header.index);
+        }
+        return false;
+    }
+
+    // A relocking board keeps its learned drift and only re-anchors.
+    board.locked = true;
+    board.anchor_local = static_cast<double>(head.local_time);
+    board.anchor_global = static_cast<double>(best->global_time);
+    board.misses = 0;
+    ++board.stats.locks;
+    for (PendingEvent& pending : board.queue) {
+        pending.global_time = to_global(board, pending.local_time);
+    }
+    spdlog::info("Event merge locked {} at offset {} ticks",
+                 board.label,
+                 static_cast<int64_t>(board.anchor_local - board.anchor_global));
+    rebuild_heap();
+    return true;
+}
+
+void EventMerger::realign(size_t index, int64_t reference_time, int64_t board_time) {
+    Board& board = boards_[index];
+    const double predicted = board.anchor_global +
+                             (static_cast<double>(board_time) - board.anchor_local) * board.rate;
+    const double error = static_cast<double>(reference_time) - predicted;
+    const double elapsed = static_cast<double>(board_time) - board.anchor_local;
+
+    // Second-order tracking loop: the error spread over the ticks since the
+    // last match measures the rate error, the rest moves the anchor.
+    if (elapsed > 0.0) {
+        const double max_rate_error = config_.max_drift_ppm * 1e-6;
+        board.rate = std::min(std::max(board.rate + config_.drift_gain * error / elapsed,
+                                       1.0 - max_rate_error),
+                              1.0 + max_rate_error);
+    }
+    board.anchor_local = static_cast<double>(board_time);
+    board.anchor_global = predicted + config_.offset_gain * error;
+
+    for (PendingEvent& pending : board.queue) {
+        pending.global_time = to_global(board, pending.local_time);
+    }
+}
+
+void EventMerger::remember_reference(const PendingEvent& pending) {
+    const ReferenceMark mark{pending.local_time, pending.arrival_ns, pending.created_ns};
+    if (reference_marks_.size() < kReferenceMarks) {
+        reference_marks_.push_back(mark);
+    } else {
+        reference_marks_[reference_mark_next_] = mark;
+        reference_mark_next_ = (reference_mark_next_ + 1) % kReferenceMarks;
+    }
+}
+
+void EventMerger::rebuild_heap() {
+    std::vector<HeapEntry> entries;
+    entries.reserve(boards_.size());
+    for (size_t index = 0; index < boards_.size(); ++index) {
+        if (boards_[index].locked && !boards_[index].queue.empty()) {
+            entries.emplace_back(boards_[index].queue.front().global_time, index);
+        }
+    }
+    heap_ = decltype(heap_)(std::greater<HeapEntry>(), std::move(entries));
+}
+
+bool EventMerger::ready(int64_t time, int64_t now_ns, bool flush) const {
+    if (flush) {
+        return true;
+    }
+
+    const int64_t window_end = time + config_.match_window;
+    for (const Board& board : boards_) {
+        if (!board.locked) {
+            continue;
+        }
+        if (board.queue.size() >= config_.max_pending_events) {
+            return true;
+        }
+        // The earliest event stops waiting for the other boards after max_wait_us.
+        if (!board.queue.empty() && board.queue.front().global_time == time &&
+            now_ns - board.queue.front().created_ns >= wait_ns_) {
+            return true;
+        }
+    }
+
+    // Every locked board must have moved past the window, so none of them
+    // can still deliver an event that belongs to this trigger.
+    for (const Board& board : boards_) {
+        if (board.locked && board.queue.empty() &&
+            to_global(board, board.local_time) <= window_end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EventMerger::emit_group(std::vector<MergedEvent>& merged) {
+    const int64_t time = heap_.top().first;
+    heap_.pop();
+    const int64_t window_end = time + config_.match_window;
+
+    MergedEvent result;
+    result.index = next_index_++;
+    result.global_time = time;
+
+    int64_t reference_time = 0;
+    bool has_reference = false;
+    for (size_t index = 0; index < boards_.size(); ++index) {
+        Board& board = boards_[index];
+        if (!board.locked || board.queue.empty() || board.queue.front().global_time > window_end) {
+            continue;
+        }
+        const PendingEvent& head = board.queue.front();
+        result.parts.push_back({index, head.event, head.global_time});
+        add_channels(result, index, head.event->header.channel_mask);
+        if (index == reference_) {
+            reference_time = head.global_time;
+            has_reference = true;
+        }
+    }
+
+    for (const MergedEventPart& part : result.parts) {
+        Board& board = boards_[part.board];
+        const int64_t local_time = board.queue.front().local_time;
+        board.queue.pop_front();
+        if (part.board == reference_) {
+            if (result.parts.size() > 1) {
+                ++board.stats.matched;
+            } else {
+                ++board.stats.unmatched;
+            }
+        } else if (has_reference) {
+            realign(part.board, reference_time, local_time);
+            board.misses = 0;
+            ++board.stats.matched;
+        } else {
+            ++board.stats.unmatched;
+            if (++board.misses > config_.max_misses) {
+                // Persistent misses mean the lock is wrong; start over.
+                board.locked = false;
+                spdlog::warn("Event merge lost the alignment of {}; relocking", board.label);
+            }
+        }
+        if (board.locked && !board.queue.empty()) {
+            heap_.emplace(board.queue.front().global_time, part.board);
+        }
+    }
+
+    merged.push_back(std::move(result));
+}
+
+void EventMerger::emit_unaligned(size_t index, std::vector<MergedEvent>& merged) {
+    Board& board = boards_[index];
+    const PendingEvent& head = board.queue.front();
+
+    MergedEvent result;
+    result.index = next_index_++;
+    result.global_time = head.local_time;
+    result.aligned = false;
+    result.parts.push_back({index, head.event, head.local_time});
+    add_channels(result, index, head.event->header.channel_mask);
+    merged.push_back(std::move(result));
+
+    board.queue.pop_front();
+    ++board.stats.unaligned;
+}
+
+void EventMerger::add_channels(MergedEvent& merged, size_t board, uint64_t channel_mask) const {
+    for (uint64_t bits = channel_mask; bits != 0; bits &= bits - 1) {
+        const size_t channel = static_cast<size_t>(__builtin_ctzll(bits));
+        if (channel >= config_.channel_stride) {
+            break;
+        }
+        const size_t global = board * config_.channel_stride + channel;
+        if (merged.channel_mask.size() <= global / 64) {
+            merged.channel_mask.resize(global / 64 + 1, 0);
+        }
+        merged.channel_mask[global / 64] |= uint64_t{1} << (global % 64);
+    }
+}
+
+}  // namespace nalu_event_collector
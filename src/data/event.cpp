@@ -133,6 +133,19 @@ void Event::add_packet(const Packet& packet) {
     }
 }
 
+void Event::add_packet(const Packet& packet, uint64_t arrival_ns) {
+    add_packet(packet);
+    if (arrival_ns == 0) {
+        return;
+    }
+    if (first_arrival_ns == 0 || arrival_ns < first_arrival_ns) {
+        first_arrival_ns = arrival_ns;
+    }
+    if (arrival_ns > last_arrival_ns) {
+        last_arrival_ns = arrival_ns;
+    }
+}
+
 int Event::count_active_channels(uint64_t channel_mask) const {
     int count = 0;
     while (channel_mask != 0) {
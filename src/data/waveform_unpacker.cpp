@@ -0,0 +1,225 @@
+/**
+ * @file waveform_unpacker.cpp
+ * @brief Implements scalar, SSE4.1, and AVX2 sample unpacking kernels.
+ */
+
+#include "nalu_event_collector/data/waveform_unpacker.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NALU_WAVEFORM_UNPACKER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace nalu_event_collector {
+
+namespace {
+
+constexpr size_t kSamples = WaveformUnpacker::kSamplesPerPacket;
+
+uint16_t load_sample(const uint8_t* raw, size_t sample, bool swap_bytes, uint16_t mask) {
+    const uint8_t low = raw[2 * sample + (swap_bytes ? 1 : 0)];
+    const uint8_t high = raw[2 * sample + (swap_bytes ? 0 : 1)];
+    return static_cast<uint16_t>((high << 8) | low) & mask;
+}
+
+template <typename Sample>
+void unpack_scalar(const Packet* packets,
+                   size_t count,
+                   uint16_t mask,
+                   bool swap_bytes,
+                   Sample* samples) {
+    for (size_t k = 0; k < count; ++k) {
+        const uint8_t* raw = packets[k].raw_samples;
+        Sample* out = samples + k * kSamples;
+        for (size_t j = 0; j < kSamples; ++j) {
+            out[j] = static_cast<Sample>(load_sample(raw, j, swap_bytes, mask));
+        }
+    }
+}
+
+#ifdef NALU_WAVEFORM_UNPACKER_X86
+
+__attribute__((target("sse4.1"))) __m128i swap_shuffle_128() {
+    return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+}
+
+// Load eight sample words, byte-swapped if requested, and mask them.
+__attribute__((target("sse4.1"))) __m128i load_words_128(const uint8_t* raw,
+                                                         bool swap_bytes,
+                                                         __m128i masks,
+                                                         __m128i shuffle) {
+    __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw));
+    if (swap_bytes) {
+        words = _mm_shuffle_epi8(words, shuffle);
+    }
+    return _mm_and_si128(words, masks);
+}
+
+__attribute__((target("sse4.1"))) void unpack_sse41(const Packet* packets,
+                                                    size_t count,
+                                                    uint16_t mask,
+                                                    bool swap_bytes,
+                                                    int16_t* samples) {
+    const __m128i masks = _mm_set1_epi16(static_cast<short>(mask));
+    const __m128i shuffle = swap_shuffle_128();
+    for (size_t k = 0; k < count; ++k) {
+        const uint8_t* raw = packets[k].raw_samples;
+        auto* out = reinterpret_cast<__m128i*>(samples + k * kSamples);
+        for (size_t step = 0; step < 4; ++step) {
+            _mm_storeu_si128(out + step,
+                             load_words_128(raw + 16 * step, swap_bytes, masks, shuffle));
+        }
+    }
+}
+
+__attribute__((target("sse4.1"))) void unpack_sse41(const Packet* packets,
+                                                    size_t count,
+                                                    uint16_t mask,
+                                                    bool swap_bytes,
+                                                    float* samples) {
+    const __m128i masks = _mm_set1_epi16(static_cast<short>(mask));
+    const __m128i shuffle = swap_shuffle_128();
+    for (size_t k = 0; k < count; ++k) {
+        const uint8_t* raw = packets[k].raw_samples;
+        float* out = samples + k * kSamples;
+        for (size_t step = 0; step < 4; ++step) {
+            const __m128i words = load_words_128(raw + 16 * step, swap_bytes, masks, shuffle);
+            // Words are unsigned; zero-extend four at a time before converting.
+            _mm_storeu_ps(out + 8 * step, _mm_cvtepi32_ps(_mm_cvtepu16_epi32(words)));
+            _mm_storeu_ps(out + 8 * step + 4,
+                          _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_srli_si128(words, 8))));
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void unpack_avx2(const Packet* packets,
+                                                 size_t count,
+                                                 uint16_t mask,
+                                                 bool swap_bytes,
+                                                 int16_t* samples) {
+    const __m256i masks = _mm256_set1_epi16(static_cast<short>(mask));
+    const __m256i shuffle = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                             1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    for (size_t k = 0; k < count; ++k) {
+        const auto* raw = reinterpret_cast<const __m256i*>(packets[k].raw_samples);
+        auto* out = reinterpret_cast<__m256i*>(samples + k * kSamples);
+        __m256i low = _mm256_loadu_si256(raw);
+        __m256i high = _mm256_loadu_si256(raw + 1);
+        if (swap_bytes) {
+            low = _mm256_shuffle_epi8(low, shuffle);
+            high = _mm256_shuffle_epi8(high, shuffle);
+        }
+        _mm256_storeu_si256(out, _mm256_and_si256(low, masks));
+        _mm256_storeu_si256(out + 1, _mm256_and_si256(high, masks));
+    }
+}
+
+__attribute__((target("avx2"))) void unpack_avx2(const Packet* packets,
+                                                 size_t count,
+                                                 uint16_t mask,
+                                                 bool swap_bytes,
+                                                 float* samples) {
+    const __m128i masks = _mm_set1_epi16(static_cast<short>(mask));
+    const __m128i shuffle = swap_shuffle_128();
+    for (size_t k = 0; k < count; ++k) {
+        const uint8_t* raw = packets[k].raw_samples;
+        float* out = samples + k * kSamples;
+        for (size_t step = 0; step < 4; ++step) {
+            const __m128i words = load_words_128(raw + 16 * step, swap_bytes, masks, shuffle);
+            _mm256_storeu_ps(out + 8 * step, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(words)));
+        }
+    }
+}
+
+#endif  // NALU_WAVEFORM_UNPACKER_X86
+
+}  // namespace
+
+WaveformUnpacker::WaveformUnpacker(uint8_t sample_bits, bool swap_bytes, Isa max_isa)
+    : sample_bits_(sample_bits),
+      swap_bytes_(swap_bytes),
+      isa_(std::min(max_isa, detect_isa())) {
+    if (sample_bits_ == 0 || sample_bits_ > 16) {
+        throw std::invalid_argument("Invalid waveform sample width: " +
+                                    std::to_string(sample_bits_) + " (expected 1 to 16 bits)");
+    }
+    mask_ = static_cast<uint16_t>((1u << sample_bits_) - 1);
+}
+
+void WaveformUnpacker::unpack(const Packet* packets, size_t count, int16_t* samples) const {
+    switch (isa_) {
+#ifdef NALU_WAVEFORM_UNPACKER_X86
+        case Isa::Avx2:
+            unpack_avx2(packets, count, mask_, swap_bytes_, samples);
+            return;
+        case Isa::Sse41:
+            unpack_sse41(packets, count, mask_, swap_bytes_, samples);
+            return;
+#endif
+        default:
+            break;
+    }
+    unpack_scalar(packets, count, mask_, swap_bytes_, samples);
+}
+
+void WaveformUnpacker::unpack(const Packet* packets, size_t count, float* samples) const {
+    switch (isa_) {
+#ifdef NALU_WAVEFORM_UNPACKER_X86
+        case Isa::Avx2:
+            unpack_avx2(packets, count, mask_, swap_bytes_, samples);
+            return;
+        case Isa::Sse41:
+            unpack_sse41(packets, count, mask_, swap_bytes_, samples);
+            return;
+#endif
+        default:
+            break;
+    }
+    unpack_scalar(packets, count, mask_, swap_bytes_, samples);
+}
+
+void WaveformUnpacker::unpack(const Event& event, std::vector<int16_t>& samples) const {
+    samples.resize(event.header.num_packets * kSamplesPerPacket);
+    unpack(event.packets.get(), event.header.num_packets, samples.data());
+}
+
+void WaveformUnpacker::unpack(const Event& event, std::vector<float>& samples) const {
+    samples.resize(event.header.num_packets * kSamplesPerPacket);
+    unpack(event.packets.get(), event.header.num_packets, samples.data());
+}
+
+WaveformUnpacker::Isa WaveformUnpacker::detect_isa() {
+#ifdef NALU_WAVEFORM_UNPACKER_X86
+    static const Isa detected = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Isa::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.1")) {
+            return Isa::Sse41;
+        }
+        return Isa::Scalar;
+    }();
+    return detected;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+const char* WaveformUnpacker::isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Sse41:
+            return "sse4.1";
+        case Isa::Scalar:
+        default:
+            return "scalar";
+    }
+}
+
+}  // namespace nalu_event_collector
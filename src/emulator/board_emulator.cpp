@@ -0,0 +1,135 @@
+/**
+ * @file board_emulator.cpp
+ * @brief Implements paced and batched sending of emulated board traffic.
+ */
+
+#include "nalu_event_collector/emulator/board_emulator.h"
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+namespace nalu_event_collector {
+
+namespace {
+
+// Longest single sleep, so stop() is noticed promptly at low trigger rates.
+constexpr std::chrono::milliseconds kMaxSleep(100);
+
+}  // namespace
+
+BoardEmulator::BoardEmulator(const BoardEmulatorConfig& config)
+    : config_(config), generator_(config) {
+    if (config_.send_batch_size == 0) {
+        throw std::invalid_argument("Board emulator send_batch_size must be > 0");
+    }
+    messages_.resize(config_.send_batch_size);
+    iovecs_.resize(config_.send_batch_size);
+    destination_.sin_family = AF_INET;
+    destination_.sin_port = htons(config_.port);
+    if (inet_pton(AF_INET, config_.address.c_str(), &destination_.sin_addr) != 1) {
+        throw std::invalid_argument("Invalid board emulator address: " + config_.address);
+    }
+
+    socket_fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (socket_fd_ < 0) {
+        throw std::runtime_error(std::string("Failed to create emulator socket: ") +
+                                 std::strerror(errno));
+    }
+}
+
+BoardEmulator::~BoardEmulator() {
+    if (socket_fd_ >= 0) {
+        close(socket_fd_);
+    }
+}
+
+void BoardEmulator::run() {
+    spdlog::info("Emulating board {} -> {}:{} ({} mode, {} channels x {} windows, {} Hz{})",
+                 config_.board_id,
+                 config_.address,
+                 config_.port,
+                 config_.trigger_mode,
+                 config_.channels.size(),
+                 config_.windows,
+                 config_.event_rate,
+                 config_.paced ? "" : ", unpaced");
+
+    const auto start = std::chrono::steady_clock::now();
+    size_t used = 0;
+    while (running_.load(std::memory_order_relaxed) &&
+           (config_.event_count == 0 || generator_.stats().triggers < config_.event_count)) {
+        used = generator_.next_trigger(datagrams_, used);
+        if (config_.paced) {
+            const auto due = start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::duration<double>(generator_.board_time()));
+            auto now = std::chrono::steady_clock::now();
+            while (now < due && running_.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_until(std::min(due, now + kMaxSleep));
+                now = std::chrono::steady_clock::now();
+            }
+            send(used);
+            used = 0;
+        } else if (used >= config_.send_batch_size) {
+            send(used);
+            used = 0;
+        }
+    }
+    used = generator_.flush(datagrams_, used);
+    send(used);
+
+    stats_.traffic = generator_.stats();
+    stats_.elapsed_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BoardEmulator::send(size_t count) {
+    size_t next = 0;
+    while (next < count) {
+        const size_t batch = std::min(count - next, messages_.size());
+        for (size_t i = 0; i < batch; ++i) {
+            std::vector<uint8_t>& datagram = datagrams_[next + i];
+            iovecs_[i] = iovec{datagram.data(), datagram.size()};
+            messages_[i] = mmsghdr{};
+            messages_[i].msg_hdr.msg_name = &destination_;
+            messages_[i].msg_hdr.msg_namelen = sizeof(destination_);
+            messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+            messages_[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int sent =
+            sendmmsg(socket_fd_, messages_.data(), static_cast<unsigned int>(batch), 0);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Skip the datagram the kernel refused and carry on with the rest.
+            if (!send_error_logged_) {
+                spdlog::warn("Board emulator send to {}:{} failed: {}",
+                             config_.address,
+                             config_.port,
+                             std::strerror(errno));
+                send_error_logged_ = true;
+            }
+            ++stats_.send_errors;
+            ++next;
+            continue;
+        }
+        for (int i = 0; i < sent; ++i) {
+            stats_.sent_bytes += messages_[i].msg_len;
+        }
+        stats_.sent_datagrams += static_cast<uint64_t>(sent);
+        next += static_cast<size_t>(sent);
+    }
+}
+
+}  // namespace nalu_event_collector
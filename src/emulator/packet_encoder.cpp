@@ -0,0 +1,30 @@
+/**
+ * @file packet_encoder.cpp
+ * @brief Implements serialization of packets into the board wire format.
+ */
+
+#include "nalu_event_collector/emulator/packet_encoder.h"
+
+#include <cstring>
+
+namespace nalu_event_collector {
+
+void encode_packet(const Packet& packet, uint8_t* out) {
+    const uint16_t trigger_high = static_cast<uint16_t>((packet.trigger_time >> 12) & 0xFFF);
+    const uint16_t trigger_low = static_cast<uint16_t>(packet.trigger_time & 0xFFF);
+
+    out[0] = 0x0E;
+    out[1] = static_cast<uint8_t>(packet.channel & 0x3F);
+    out[2] = static_cast<uint8_t>(trigger_high >> 8);
+    out[3] = static_cast<uint8_t>(trigger_high);
+    out[4] = static_cast<uint8_t>(trigger_low >> 8);
+    out[5] = static_cast<uint8_t>(trigger_low);
+    out[6] = static_cast<uint8_t>((packet.logical_position >> 2) & 0x3F);
+    out[7] = static_cast<uint8_t>(((packet.logical_position & 0x3) << 6) |
+                                  (packet.physical_position & 0x3F));
+    std::memcpy(out + 8, packet.raw_samples, sizeof(packet.raw_samples));
+    out[72] = 0xFA;
+    out[73] = 0x5A;
+}
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,264 @@
+/**
+ * @file traffic_generator.cpp
+ * @brief Implements synthetic trigger, packet, and datagram generation.
+ */
+
+#include "nalu_event_collector/emulator/traffic_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace nalu_event_collector {
+
+namespace {
+
+// Largest UDP payload over IPv4.
+constexpr size_t kMaxDatagramSize = 65507;
+constexpr uint32_t kMaxTriggerTime = 1u << 24;
+constexpr int kPhysicalWindows = 64;
+
+void check_probability(double value, const char* name) {
+    if (!(value >= 0.0 && value <= 1.0)) {
+        throw std::invalid_argument(std::string("Board emulator ") + name +
+                                    " must be between 0 and 1");
+    }
+}
+
+void check_header_field(size_t offset, size_t width, const char* name) {
+    if (width > 8) {
+        throw std::invalid_argument(std::string("Board emulator ") + name +
+                                    " width must be at most 8 bytes");
+    }
+    if (width != 0 && (offset < 2 || offset + width > kTransportHeaderSize)) {
+        throw std::invalid_argument(std::string("Board emulator ") + name +
+                                    " must lie within transport header bytes 2-15");
+    }
+}
+
+void write_big_endian(uint8_t* target, uint64_t value, size_t width) {
+    for (size_t i = width; i > 0; --i) {
+        target[i - 1] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+}
+
+}  // namespace
+
+TrafficGenerator::TrafficGenerator(const BoardEmulatorConfig& config)
+    : config_(config),
+      trigger_mode_(parse_trigger_mode(config.trigger_mode)),
+      ticks_per_trigger_(0.0),
+      random_(config.seed) {
+    if (config_.channels.empty()) {
+        throw std::invalid_argument("Board emulator needs at least one channel");
+    }
+    for (int channel : config_.channels) {
+        if (channel < 0 || channel > 63) {
+            throw std::invalid_argument("Board emulator channels must be between 0 and 63");
+        }
+    }
+    if (config_.windows < 1 || config_.windows > kPhysicalWindows) {
+        throw std::invalid_argument("Board emulator windows must be between 1 and 64");
+    }
+    if (!(config_.event_rate > 0.0) || config_.clock_frequency == 0) {
+        throw std::invalid_argument("Board emulator event_rate and clock_frequency must be > 0");
+    }
+    if (config_.max_trigger_time == 0 || config_.max_trigger_time > kMaxTriggerTime) {
+        throw std::invalid_argument("Board emulator max_trigger_time must be between 1 and 2^24");
+    }
+    if (config_.start_trigger_time >= config_.max_trigger_time) {
+        throw std::invalid_argument("Board emulator start_trigger_time must be < max_trigger_time");
+    }
+    if (config_.packets_per_datagram == 0 ||
+        kTransportHeaderSize + config_.packets_per_datagram * kWirePacketSize > kMaxDatagramSize) {
+        throw std::invalid_argument("Board emulator packets_per_datagram must fit one datagram");
+    }
+    check_header_field(config_.sequence_offset, config_.sequence_width, "sequence field");
+    check_header_field(config_.board_id_offset, config_.board_id_width, "board ID field");
+    if (config_.sequence_width != 0 && config_.board_id_width != 0 &&
+        config_.sequence_offset < config_.board_id_offset + config_.board_id_width &&
+        config_.board_id_offset < config_.sequence_offset + config_.sequence_width) {
+        throw std::invalid_argument("Board emulator sequence and board ID fields overlap");
+    }
+    check_probability(config_.self_trigger_occupancy, "self_trigger_occupancy");
+    check_probability(config_.loss_rate, "loss_rate");
+    check_probability(config_.reorder_rate, "reorder_rate");
+    check_probability(config_.corrupt_marker_rate, "corrupt_marker_rate");
+    if (config_.reorder_distance == 0) {
+        throw std::invalid_argument("Board emulator reorder_distance must be > 0");
+    }
+
+    ticks_per_trigger_ = config_.clock_frequency / config_.event_rate;
+    packets_.reserve(config_.channels.size() * static_cast<size_t>(config_.windows));
+    framing_.reserve(kTransportHeaderSize + config_.packets_per_datagram * kWirePacketSize);
+}
+
+TrafficGenerator::TriggerMode TrafficGenerator::parse_trigger_mode(
+    const std::string& trigger_mode) {
+    if (trigger_mode == "ext" || trigger_mode == "imm") {
+        return TriggerMode::Periodic;
+    }
+    if (trigger_mode == "self") {
+        return TriggerMode::Self;
+    }
+    throw std::invalid_argument("Invalid board emulator trigger_mode: " + trigger_mode +
+                                " (expected ext, imm, or self)");
+}
+
+size_t TrafficGenerator::next_trigger(std::vector<std::vector<uint8_t>>& datagrams,
+                                      size_t used) {
+    if (stats_.triggers > 0) {
+        if (trigger_mode_ == TriggerMode::Self) {
+            // Poisson arrivals with the configured mean rate.
+            board_ticks_ += -std::log(1.0 - uniform_(random_)) * ticks_per_trigger_;
+        } else {
+            board_ticks_ += ticks_per_trigger_;
+        }
+    }
+    build_packets();
+    frame_datagrams(datagrams, used);
+    return used;
+}
+
+size_t TrafficGenerator::flush(std::vector<std::vector<uint8_t>>& datagrams, size_t used) {
+    release_held(datagrams, used, true);
+    return used;
+}
+
+double TrafficGenerator::board_time() const {
+    return board_ticks_ / config_.clock_frequency;
+}
+
+void TrafficGenerator::build_packets() {
+    const uint32_t max_trigger_time = config_.max_trigger_time;
+    const uint32_t trigger_time = static_cast<uint32_t>(
+        (config_.start_trigger_time + static_cast<uint64_t>(board_ticks_)) % max_trigger_time);
+    if (stats_.triggers > 0 && trigger_time < last_trigger_time_) {
+        ++stats_.trigger_time_wraps;
+    }
+    last_trigger_time_ = trigger_time;
+    ++stats_.triggers;
+
+    packets_.clear();
+    const auto add_channel = [&](int channel, uint32_t channel_trigger_time) {
+        for (int window = 0; window < config_.windows; ++window) {
+            Packet packet;
+            packet.channel = static_cast<uint8_t>(channel);
+            packet.trigger_time = channel_trigger_time;
+            packet.logical_position = static_cast<uint16_t>(window);
+            packet.physical_position =
+                static_cast<uint16_t>((next_window_ + window) % kPhysicalWindows);
+            // A small channel-dependent ramp so decoded samples are recognizable.
+            for (size_t i = 0; i < sizeof(packet.raw_samples); ++i) {
+                packet.raw_samples[i] =
+                    static_cast<uint8_t>(0x40 + ((channel * 4 + window + i) & 0x3F));
+            }
+            packets_.push_back(packet);
+        }
+    };
+
+    if (trigger_mode_ == TriggerMode::Periodic) {
+        for (int channel : config_.channels) {
+            add_channel(channel, trigger_time);
+        }
+    } else {
+        for (int channel : config_.channels) {
+            if (uniform_(random_) < config_.self_trigger_occupancy) {
+                const uint32_t jitter = static_cast<uint32_t>(
+                    uniform_(random_) * (static_cast<double>(config_.self_trigger_jitter) + 1.0));
+                add_channel(channel,
+                            static_cast<uint32_t>((static_cast<uint64_t>(trigger_time) + jitter) %
+                                                  max_trigger_time));
+            }
+        }
+        if (packets_.empty()) {
+            // A self trigger always has at least the channel that fired it.
+            const size_t pick =
+                static_cast<size_t>(uniform_(random_) * config_.channels.size());
+            add_channel(config_.channels[std::min(pick, config_.channels.size() - 1)],
+                        trigger_time);
+        }
+    }
+    next_window_ = static_cast<uint8_t>((next_window_ + config_.windows) % kPhysicalWindows);
+    stats_.packets += packets_.size();
+}
+
+void TrafficGenerator::frame_datagrams(std::vector<std::vector<uint8_t>>& datagrams,
+                                       size_t& used) {
+    for (size_t first = 0; first < packets_.size(); first += config_.packets_per_datagram) {
+        const size_t count = std::min(config_.packets_per_datagram, packets_.size() - first);
+        const size_t payload_size = count * kWirePacketSize;
+        framing_.assign(kTransportHeaderSize + payload_size, 0);
+
+        uint8_t* header = framing_.data();
+        write_big_endian(header, payload_size, 2);
+        if (config_.sequence_width != 0) {
+            write_big_endian(header + config_.sequence_offset, sequence_, config_.sequence_width);
+        }
+        if (config_.board_id_width != 0) {
+            write_big_endian(header + config_.board_id_offset,
+                             config_.board_id,
+                             config_.board_id_width);
+        }
+        ++sequence_;
+
+        for (size_t k = 0; k < count; ++k) {
+            uint8_t* packet = header + kTransportHeaderSize + k * kWirePacketSize;
+            encode_packet(packets_[first + k], packet);
+            if (config_.corrupt_marker_rate > 0.0 &&
+                uniform_(random_) < config_.corrupt_marker_rate) {
+                if (uniform_(random_) < 0.5) {
+                    packet[0] ^= 0xFF;
+                } else {
+                    packet[kWirePacketSize - 1] ^= 0xFF;
+                }
+                ++stats_.corrupted_markers;
+            }
+        }
+        ++stats_.datagrams;
+        emit(framing_, datagrams, used);
+    }
+}
+
+void TrafficGenerator::emit(const std::vector<uint8_t>& datagram,
+                            std::vector<std::vector<uint8_t>>& datagrams,
+                            size_t& used) {
+    if (config_.loss_rate > 0.0 && uniform_(random_) < config_.loss_rate) {
+        ++stats_.lost_datagrams;
+        return;
+    }
+    if (config_.reorder_rate > 0.0 && uniform_(random_) < config_.reorder_rate) {
+        held_.emplace_back(config_.reorder_distance, datagram);
+        return;
+    }
+    push(datagram, datagrams, used);
+    release_held(datagrams, used, false);
+}
+
+void TrafficGenerator::release_held(std::vector<std::vector<uint8_t>>& datagrams,
+                                    size_t& used,
+                                    bool all) {
+    for (auto& held : held_) {
+        --held.first;
+    }
+    // Every datagram is held for the same distance, so the oldest is released first.
+    while (!held_.empty() && (all || held_.front().first == 0)) {
+        push(held_.front().second, datagrams, used);
+        held_.pop_front();
+        ++stats_.reordered_datagrams;
+    }
+}
+
+void TrafficGenerator::push(const std::vector<uint8_t>& datagram,
+                            std::vector<std::vector<uint8_t>>& datagrams,
+                            size_t& used) {
+    if (used == datagrams.size()) {
+        datagrams.emplace_back();
+    }
+    datagrams[used].assign(datagram.begin(), datagram.end());
+    ++used;
+}
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,369 @@
+/**
+ * @file capture_reader.cpp
+ * @brief Implements memory-mapped reading of raw and pcap captures.
+ */
+
+#include "nalu_event_collector/input/capture_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+namespace nalu_event_collector {
+
+namespace {
+
+constexpr size_t kPcapFileHeaderSize = 24;
+constexpr size_t kPcapRecordHeaderSize = 16;
+constexpr uint32_t kPcapMagicMicro = 0xa1b2c3d4;
+constexpr uint32_t kPcapMagicNano = 0xa1b23c4d;
+constexpr uint32_t kPcapngMagic = 0x0a0d0d0a;
+
+constexpr uint32_t kLinkTypeNull = 0;
+constexpr uint32_t kLinkTypeEthernet = 1;
+constexpr uint32_t kLinkTypeRawBsd = 12;
+constexpr uint32_t kLinkTypeRaw = 101;
+constexpr uint32_t kLinkTypeLoop = 108;
+constexpr uint32_t kLinkTypeLinuxSll = 113;
+constexpr uint32_t kLinkTypeIpv4 = 228;
+constexpr uint32_t kLinkTypeLinuxSll2 = 276;
+
+constexpr uint16_t kEtherTypeIpv4 = 0x0800;
+constexpr uint16_t kEtherTypeVlan = 0x8100;
+constexpr uint16_t kEtherTypeQinQ = 0x88a8;
+constexpr uint32_t kAddressFamilyInet = 2;
+constexpr size_t kIpv4MinHeaderSize = 20;
+constexpr size_t kUdpHeaderSize = 8;
+constexpr uint8_t kIpProtocolUdp = 17;
+
+uint16_t read_be16(const uint8_t* data) {
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+uint32_t read_be32(const uint8_t* data) {
+    return (static_cast<uint32_t>(read_be16(data)) << 16) | read_be16(data + 2);
+}
+
+uint32_t read_u32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::runtime_error file_error(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+CaptureReader::CaptureReader(const std::string& path, const std::string& format, uint16_t port)
+    : path_(path), port_(port) {
+    const bool detect = format == "auto";
+    const Format requested = detect ? Format::Raw : parseFormat(format);
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw file_error("Failed to open capture", path);
+    }
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw file_error("Failed to stat capture", path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ == 0) {
+        ::close(fd);
+        throw std::runtime_error("Capture file is empty: " + path);
+    }
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw file_error("Failed to map capture", path);
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+    madvise(mapping, size_, MADV_SEQUENTIAL);
+
+    const bool is_raw =
+        size_ >= sizeof(CaptureFileHeader) &&
+        std::memcmp(data_, kCaptureMagic, sizeof(kCaptureMagic)) == 0;
+    const uint32_t magic = size_ >= sizeof(uint32_t) ? read_u32(data_) : 0;
+    const bool is_pcap = size_ >= kPcapFileHeaderSize &&
+                         (magic == kPcapMagicMicro || magic == kPcapMagicNano ||
+                          magic == __builtin_bswap32(kPcapMagicMicro) ||
+                          magic == __builtin_bswap32(kPcapMagicNano));
+
+    try {
+        if (is_raw && (detect || requested == Format::Raw)) {
+            format_ = Format::Raw;
+            CaptureFileHeader header;
+            std::memcpy(&header, data_, sizeof(header));
+            if (header.version != kCaptureVersion) {
+                throw std::runtime_error("Unsupported raw capture version " +
+                                         std::to_string(header.version) + ": " + path);
+            }
+            first_record_ = sizeof(CaptureFileHeader);
+            if ((header.flags & kCaptureFlagRing) != 0) {
+                CaptureRingHeader ring;
+                if (size_ < sizeof(CaptureFileHeader) + sizeof(ring)) {
+                    throw std::runtime_error("Truncated ring capture: " + path);
+                }
+                std::memcpy(&ring, data_ + sizeof(CaptureFileHeader), sizeof(ring));
+                if (ring.data_offset > size_ || ring.data_size > size_ - ring.data_offset ||
+                    ring.tail < ring.head || ring.tail - ring.head > ring.data_size) {
+                    throw std::runtime_error("Corrupt ring capture header: " + path);
+                }
+                ring_ = true;
+                ring_data_ = data_ + ring.data_offset;
+                ring_size_ = ring.data_size;
+                ring_head_ = ring.head;
+                ring_tail_ = ring.tail;
+            }
+        } else if (is_pcap && (detect || requested == Format::Pcap)) {
+            format_ = Format::Pcap;
+            readPcapHeader();
+        } else if (magic == kPcapngMagic) {
+            throw std::runtime_error("pcapng captures are not supported; convert with "
+                                     "`editcap -F pcap`: " + path);
+        } else {
+            throw std::runtime_error("Not a " + (detect ? std::string("raw or pcap") : format) +
+                                     " capture: " + path);
+        }
+    } catch (...) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+        throw;
+    }
+    offset_ = first_record_;
+    ring_position_ = ring_head_;
+}
+
+CaptureReader::~CaptureReader() {
+    if (data_ != nullptr) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+CaptureReader::Format CaptureReader::parseFormat(const std::string& format) {
+    if (format == "raw") {
+        return Format::Raw;
+    }
+    if (format == "pcap") {
+        return Format::Pcap;
+    }
+    throw std::invalid_argument("Invalid capture format: " + format);
+}
+
+void CaptureReader::readPcapHeader() {
+    const uint32_t magic = read_u32(data_);
+    swapped_ = magic == __builtin_bswap32(kPcapMagicMicro) ||
+               magic == __builtin_bswap32(kPcapMagicNano);
+    nanosecond_ = magic == kPcapMagicNano || magic == __builtin_bswap32(kPcapMagicNano);
+    // The upper bits of the link-type field carry FCS information.
+    link_type_ = pcapField(data_ + 20) & 0xffff;
+    switch (link_type_) {
+        case kLinkTypeNull:
+        case kLinkTypeEthernet:
+        case kLinkTypeRawBsd:
+        case kLinkTypeRaw:
+        case kLinkTypeLoop:
+        case kLinkTypeLinuxSll:
+        case kLinkTypeIpv4:
+        case kLinkTypeLinuxSll2:
+            break;
+        default:
+            throw std::runtime_error("Unsupported pcap link type " + std::to_string(link_type_) +
+                                     ": " + path_);
+    }
+    first_record_ = kPcapFileHeaderSize;
+}
+
+uint32_t CaptureReader::pcapField(const uint8_t* field) const {
+    const uint32_t value = read_u32(field);
+    return swapped_ ? __builtin_bswap32(value) : value;
+}
+
+void CaptureReader::rewind() {
+    offset_ = first_record_;
+    ring_position_ = ring_head_;
+}
+
+bool CaptureReader::next(CapturedDatagram& datagram) {
+    return format_ == Format::Raw ? nextRaw(datagram) : nextPcap(datagram);
+}
+
+bool CaptureReader::nextRaw(CapturedDatagram& datagram) {
+    if (ring_) {
+        return nextRing(datagram);
+    }
+    if (offset_ + sizeof(CaptureRecordHeader) > size_) {
+        return false;
+    }
+    CaptureRecordHeader record;
+    std::memcpy(&record, data_ + offset_, sizeof(record));
+    const size_t end = offset_ + sizeof(record) + record.length;
+    if (end > size_) {
+        spdlog::warn("Capture {} ends inside a record; ignoring the last {} bytes",
+                     path_,
+                     size_ - offset_);
+        offset_ = size_;
+        return false;
+    }
+
+    datagram.data = data_ + offset_ + sizeof(record);
+    datagram.size = record.length;
+    datagram.timestamp_ns = record.timestamp_ns;
+    datagram.source_address = record.source_address;
+    datagram.source_port = record.source_port;
+    datagram.destination_port = 0;
+    offset_ = end;
+    return true;
+}
+
+bool CaptureReader::nextRing(CapturedDatagram& datagram) {
+    while (ring_position_ < ring_tail_) {
+        const size_t position = ring_position_ % ring_size_;
+        const size_t remaining = ring_size_ - position;
+        if (remaining < sizeof(CaptureRecordHeader)) {
+            ring_position_ += remaining;
+            continue;
+        }
+        CaptureRecordHeader record;
+        std::memcpy(&record, ring_data_ + position, sizeof(record));
+        if (record.length == kCapturePadLength) {
+            ring_position_ += remaining;
+            continue;
+        }
+        if (sizeof(record) + record.length > remaining) {
+            spdlog::warn("Ring capture {} has a corrupt record; stopping early", path_);
+            ring_position_ = ring_tail_;
+            return false;
+        }
+
+        datagram.data = ring_data_ + position + sizeof(record);
+        datagram.size = record.length;
+        datagram.timestamp_ns = record.timestamp_ns;
+        datagram.source_address = record.source_address;
+        datagram.source_port = record.source_port;
+        datagram.destination_port = 0;
+        ring_position_ += sizeof(record) + record.length;
+        return true;
+    }
+    return false;
+}
+
+bool CaptureReader::nextPcap(CapturedDatagram& datagram) {
+    while (offset_ + kPcapRecordHeaderSize <= size_) {
+        const uint8_t* record = data_ + offset_;
+        const uint64_t seconds = pcapField(record);
+        const uint64_t fraction = pcapField(record + 4);
+        const size_t captured = pcapField(record + 8);
+        const size_t original = pcapField(record + 12);
+        const size_t end = offset_ + kPcapRecordHeaderSize + captured;
+        if (end > size_) {
+            spdlog::warn("Capture {} ends inside a record; ignoring the last {} bytes",
+                         path_,
+                         size_ - offset_);
+            offset_ = size_;
+            return false;
+        }
+        offset_ = end;
+
+        if (captured < original ||
+            !decodeFrame(record + kPcapRecordHeaderSize, captured, datagram)) {
+            ++skipped_;
+            continue;
+        }
+        datagram.timestamp_ns = seconds * 1000000000ULL + fraction * (nanosecond_ ? 1 : 1000);
+        return true;
+    }
+    return false;
+}
+
+bool CaptureReader::decodeFrame(const uint8_t* frame,
+                                size_t size,
+                                CapturedDatagram& datagram) const {
+    size_t offset = 0;
+    switch (link_type_) {
+        case kLinkTypeEthernet: {
+            if (size < 14) {
+                return false;
+            }
+            uint16_t ether_type = read_be16(frame + 12);
+            offset = 14;
+            while ((ether_type == kEtherTypeVlan || ether_type == kEtherTypeQinQ) &&
+                   offset + 4 <= size) {
+                ether_type = read_be16(frame + offset + 2);
+                offset += 4;
+            }
+            if (ether_type != kEtherTypeIpv4) {
+                return false;
+            }
+            break;
+        }
+        case kLinkTypeLinuxSll:
+            if (size < 16 || read_be16(frame + 14) != kEtherTypeIpv4) {
+                return false;
+            }
+            offset = 16;
+            break;
+        case kLinkTypeLinuxSll2:
+            if (size < 20 || read_be16(frame) != kEtherTypeIpv4) {
+                return false;
+            }
+            offset = 20;
+            break;
+        case kLinkTypeNull:
+        case kLinkTypeLoop: {
+            // The address family is in the byte order of the capturing host.
+            if (size < 4) {
+                return false;
+            }
+            const uint32_t family = read_u32(frame);
+            if (family != kAddressFamilyInet && __builtin_bswap32(family) != kAddressFamilyInet) {
+                return false;
+            }
+            offset = 4;
+            break;
+        }
+        default:
+            break;
+    }
+
+    const uint8_t* ip = frame + offset;
+    const size_t available = size - offset;
+    if (available < kIpv4MinHeaderSize || (ip[0] >> 4) != 4) {
+        return false;
+    }
+    const size_t ip_header_size = static_cast<size_t>(ip[0] & 0x0f) * 4;
+    // More-fragments flag or a fragment offset: only whole datagrams are replayed.
+    if (ip_header_size < kIpv4MinHeaderSize || ip[9] != kIpProtocolUdp ||
+        (read_be16(ip + 6) & 0x3fff) != 0 || available < ip_header_size + kUdpHeaderSize) {
+        return false;
+    }
+
+    const uint8_t* udp = ip + ip_header_size;
+    const size_t udp_size = read_be16(udp + 4);
+    if (udp_size < kUdpHeaderSize || ip_header_size + udp_size > available) {
+        return false;
+    }
+    const uint16_t destination_port = read_be16(udp + 2);
+    if (port_ != 0 && destination_port != port_) {
+        return false;
+    }
+
+    datagram.data = udp + kUdpHeaderSize;
+    datagram.size = udp_size - kUdpHeaderSize;
+    datagram.source_address = read_be32(ip + 12);
+    datagram.source_port = read_be16(udp);
+    datagram.destination_port = destination_port;
+    return true;
+}
+
+}  // namespace nalu_event_collector
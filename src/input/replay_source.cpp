@@ -0,0 +1,435 @@
+/**
+ * @file replay_source.cpp
+ * @brief Implements paced and unpaced replay of datagram captures.
+ */
+
+#include "nalu_event_collector/input/replay_source.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace nalu_event_collector {
+
+namespace {
+
+uint64_t realtime_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+}  // namespace
+
+ReplaySource::ReplaySource(const ReplaySourceConfig& config,
+                           const UdpReceiverConfig& receiver_config)
+    : reader_(config.path, config.format, config.port),
+      pace_(parsePace(config.pace)),
+      speed_(config.speed),
+      loops_(config.loops),
+      port_(config.port),
+      batch_size_(std::max<size_t>(config.batch_size, 1)),
+      arrival_timestamps_(receiver_config.arrival_timestamps),
+      datagram_records_(receiver_config.arrival_timestamps || receiver_config.datagram_records),
+      demux_(parseDemux(receiver_config.demux)),
+      board_id_offset_(receiver_config.board_id_offset),
+      board_id_width_(receiver_config.board_id_width),
+      max_streams_(receiver_config.max_streams),
+      buffer_size_(receiver_config.buffer_size),
+      overflow_block_timeout_(receiver_config.overflow_block_timeout_ms),
+      data_buffer_(receiver_config.buffer_size) {
+    if (!(speed_ > 0.0)) {
+        throw std::invalid_argument("Replay speed must be positive");
+    }
+    if (demux_ == Demux::BoardId &&
+        ((board_id_width_ != 1 && board_id_width_ != 2 && board_id_width_ != 4) ||
+         board_id_offset_ + board_id_width_ > kTransportHeaderSize)) {
+        throw std::invalid_argument(
+            "Invalid board ID field: width must be 1, 2, or 4 and lie inside the 16-byte "
+            "transport header");
+    }
+    if (demux_ != Demux::None) {
+        if (max_streams_ == 0) {
+            throw std::invalid_argument("UDP demultiplexing requires max_streams > 0");
+        }
+        streams_ = std::make_unique<std::unique_ptr<Stream>[]>(max_streams_);
+    }
+    if (receiver_config.use_datagram_pool) {
+        spdlog::warn("Replay delivers into the byte ring; ignoring use_datagram_pool");
+    }
+
+    data_buffer_.setOverflowPolicy(UdpDataBuffer::OverflowPolicy::Block, overflow_block_timeout_);
+    if (datagram_records_) {
+        data_buffer_.enableArrivalTracking();
+    }
+    if (receiver_config.sequence_width > 0) {
+        sequence_tracker_ = std::make_unique<SequenceTracker>(receiver_config.sequence_offset,
+                                                              receiver_config.sequence_width);
+    }
+    batch_.reserve(batch_size_);
+
+    spdlog::info("Replaying {} capture {} ({} pace)",
+                 reader_.format() == CaptureReader::Format::Raw ? "raw" : "pcap",
+                 reader_.path(),
+                 config.pace);
+}
+
+ReplaySource::~ReplaySource() { stop(); }
+
+ReplaySource::Pace ReplaySource::parsePace(const std::string& pace) {
+    if (pace == "fast") {
+        return Pace::Fast;
+    }
+    if (pace == "original") {
+        return Pace::Original;
+    }
+    throw std::invalid_argument("Invalid replay pace: " + pace);
+}
+
+ReplaySource::Demux ReplaySource::parseDemux(const std::string& demux) {
+    if (demux == "none") {
+        return Demux::None;
+    }
+    if (demux == "source") {
+        return Demux::Source;
+    }
+    if (demux == "board_id") {
+        return Demux::BoardId;
+    }
+    throw std::invalid_argument("Invalid UDP demux mode: " + demux);
+}
+
+void ReplaySource::start() {
+    if (running_) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    running_ = true;
+    exhausted_ = false;
+    thread_ = std::thread([this] { replayLoop(); });
+}
+
+void ReplaySource::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+    notifyData();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ReplaySource::replayLoop() {
+    using Clock = std::chrono::steady_clock;
+
+    const auto replay_start = Clock::now();
+    const uint64_t start_datagrams = datagrams_.load(std::memory_order_relaxed);
+    const uint64_t start_bytes = bytes_.load(std::memory_order_relaxed);
+    stall_time_ = std::chrono::nanoseconds(0);
+
+    CapturedDatagram captured;
+    for (size_t loop = 0; running_ && (loops_ == 0 || loop < loops_); ++loop) {
+        reader_.rewind();
+        const auto pass_start = Clock::now();
+        uint64_t first_timestamp_ns = 0;
+        bool first = true;
+
+        while (running_ && reader_.next(captured)) {
+            if (pace_ == Pace::Original) {
+                if (first) {
+                    first_timestamp_ns = captured.timestamp_ns;
+                    first = false;
+                }
+                // Records stamped earlier than the first one are due immediately.
+                const uint64_t capture_offset_ns =
+                    captured.timestamp_ns > first_timestamp_ns
+                        ? captured.timestamp_ns - first_timestamp_ns
+                        : 0;
+                const double offset_ns = static_cast<double>(capture_offset_ns) / speed_;
+                const auto due =
+                    pass_start + std::chrono::nanoseconds(static_cast<int64_t>(offset_ns));
+                if (due > Clock::now()) {
+                    // Publish what is due before sleeping; later datagrams whose
+                    // time has already passed are delivered together.
+                    deliverBatch();
+                    std::this_thread::sleep_until(due);
+                }
+            }
+
+            DatagramView view;
+            view.data = captured.data;
+            view.size = captured.size;
+            view.source_address = captured.source_address;
+            view.source_port = captured.source_port;
+            batch_.push_back(view);
+            if (batch_.size() >= batch_size_) {
+                deliverBatch();
+            }
+        }
+        deliverBatch();
+        if (running_) {
+            completed_loops_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - replay_start).count();
+    const uint64_t datagrams = datagrams_.load(std::memory_order_relaxed) - start_datagrams;
+    const uint64_t bytes = bytes_.load(std::memory_order_relaxed) - start_bytes;
+    spdlog::info("Replay of {} {}: {} datagrams, {} payload bytes in {:.3f} s ({:.1f} MB/s, "
+                 "{:.3f} s stalled on full buffers, {} records skipped)",
+                 reader_.path(),
+                 running_ ? "finished" : "stopped",
+                 datagrams,
+                 bytes,
+                 elapsed,
+                 elapsed > 0.0 ? bytes / elapsed / 1e6 : 0.0,
+                 std::chrono::duration<double>(stall_time_).count(),
+                 reader_.skipped());
+
+    if (running_) {
+        exhausted_.store(true, std::memory_order_release);
+    }
+    notifyData();
+}
+
+void ReplaySource::deliverBatch() {
+    if (batch_.empty()) {
+        return;
+    }
+
+    const uint64_t arrival_ns = arrival_timestamps_ ? realtime_ns() : 0;
+    segments_.clear();
+    accepted_.clear();
+    uint64_t batch_bytes = 0;
+    for (DatagramView& datagram : batch_) {
+        uint16_t payload_size = 0;
+        if (!validate_transport_header(datagram.data, datagram.size, payload_size)) {
+            malformed_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        datagram.arrival_ns = arrival_ns;
+        segments_.push_back({datagram.data + kTransportHeaderSize, payload_size, arrival_ns});
+        accepted_.push_back(datagram);
+        batch_bytes += payload_size;
+    }
+    batch_.clear();
+    if (segments_.empty()) {
+        return;
+    }
+    if (sequence_tracker_) {
+        sequence_tracker_->observe(accepted_.data(), accepted_.size());
+    }
+
+    if (demux_ != Demux::None) {
+        deliverStreams();
+    } else {
+        waitForSpace(data_buffer_, batch_bytes);
+        data_buffer_.appendBatch(segments_.data(), segments_.size());
+        datagrams_.fetch_add(segments_.size(), std::memory_order_relaxed);
+        bytes_.fetch_add(batch_bytes, std::memory_order_relaxed);
+    }
+    notifyData();
+}
+
+void ReplaySource::deliverStreams() {
+    touched_streams_.clear();
+    uint64_t unrouted = 0;
+    uint64_t unrouted_bytes = 0;
+    for (size_t k = 0; k < segments_.size(); ++k) {
+        Stream* stream = findStream(accepted_[k]);
+        if (stream == nullptr) {
+            ++unrouted;
+            unrouted_bytes += segments_[k].size;
+            continue;
+        }
+        if (stream->segments.empty()) {
+            touched_streams_.push_back(stream);
+            stream->batch_bytes = 0;
+        }
+        stream->segments.push_back(segments_[k]);
+        stream->batch_bytes += segments_[k].size;
+    }
+
+    for (Stream* stream : touched_streams_) {
+        waitForSpace(stream->data_buffer, stream->batch_bytes);
+        stream->data_buffer.appendBatch(stream->segments.data(), stream->segments.size());
+        stream->datagrams.fetch_add(stream->segments.size(), std::memory_order_relaxed);
+        stream->bytes.fetch_add(stream->batch_bytes, std::memory_order_relaxed);
+        datagrams_.fetch_add(stream->segments.size(), std::memory_order_relaxed);
+        bytes_.fetch_add(stream->batch_bytes, std::memory_order_relaxed);
+        stream->segments.clear();
+    }
+
+    unrouted_datagrams_.fetch_add(unrouted, std::memory_order_relaxed);
+    unrouted_bytes_.fetch_add(unrouted_bytes, std::memory_order_relaxed);
+}
+
+ReplaySource::Stream* ReplaySource::findStream(const DatagramView& datagram) {
+    const uint64_t key =
+        demux_ == Demux::Source
+            ? (static_cast<uint64_t>(datagram.source_address) << 16) | datagram.source_port
+            : read_board_id(datagram.data, board_id_offset_, board_id_width_);
+
+    const auto found = stream_index_.find(key);
+    if (found != stream_index_.end()) {
+        return found->second;
+    }
+
+    const size_t count = stream_count_.load(std::memory_order_relaxed);
+    if (count >= max_streams_) {
+        if (!stream_limit_logged_) {
+            spdlog::warn("Replay reached max_streams ({}); dropping datagrams from new senders",
+                         max_streams_);
+            stream_limit_logged_ = true;
+        }
+        return nullptr;
+    }
+
+    const std::string label = demux_ == Demux::Source
+                                  ? format_source(datagram.source_address, datagram.source_port)
+                                  : "board " + std::to_string(key);
+
+    auto stream = std::make_unique<Stream>(key, label, buffer_size_);
+    stream->data_buffer.setOverflowPolicy(UdpDataBuffer::OverflowPolicy::Block,
+                                          overflow_block_timeout_);
+    if (datagram_records_) {
+        stream->data_buffer.enableArrivalTracking();
+    }
+    Stream* created = stream.get();
+    streams_[count] = std::move(stream);
+    stream_index_.emplace(key, created);
+    // Publishes the fully constructed stream to readers of stream_count_.
+    stream_count_.store(count + 1, std::memory_order_release);
+    spdlog::info("Replay: new stream {}", label);
+    return created;
+}
+
+void ReplaySource::waitForSpace(UdpDataBuffer& buffer, size_t bytes) {
+    // Replay never drops: hold the capture back until the collector has
+    // drained enough of the buffer.
+    const size_t needed = std::min(bytes, buffer.capacity());
+    if (buffer.capacity() - buffer.size() >= needed) {
+        return;
+    }
+    const auto stall_start = std::chrono::steady_clock::now();
+    while (running_ && buffer.capacity() - buffer.size() < needed) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    stall_time_ += std::chrono::steady_clock::now() - stall_start;
+}
+
+size_t ReplaySource::getBufferedBytes() const {
+    size_t total = data_buffer_.size();
+    const size_t stream_count = stream_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < stream_count; ++i) {
+        total += streams_[i]->data_buffer.size();
+    }
+    return total;
+}
+
+bool ReplaySource::waitForData(size_t min_bytes, std::chrono::microseconds max_wait) {
+    min_bytes = std::max<size_t>(min_bytes, 1);
+    data_threshold_.store(min_bytes);
+    data_waiters_.fetch_add(1);
+    bool reached = false;
+    {
+        std::unique_lock<std::mutex> lock(data_mutex_);
+        reached = data_cv_.wait_for(lock, max_wait, [this, min_bytes] {
+            return !running_ || getBufferedBytes() >= min_bytes;
+        });
+    }
+    data_waiters_.fetch_sub(1);
+    return reached && running_;
+}
+
+void ReplaySource::notifyData() {
+    // Pairs with the waiter registering before it checks the buffers, so a
+    // publish racing with a new waiter is either seen or notified.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (data_waiters_.load() == 0) {
+        return;
+    }
+    if (running_ && getBufferedBytes() < data_threshold_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    data_cv_.notify_all();
+}
+
+UdpDataBuffer& ReplaySource::getDataBuffer(size_t shard) {
+    if (shard != 0) {
+        throw std::out_of_range("Replay shard index out of range");
+    }
+    return data_buffer_;
+}
+
+std::vector<UdpShardStats> ReplaySource::getShardStats() const {
+    UdpShardStats stats;
+    stats.port = port_;
+    stats.datagrams = datagrams_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.malformed_datagrams = malformed_.load(std::memory_order_relaxed);
+    const UdpDataBuffer::OverflowStats overflow = data_buffer_.getOverflowStats();
+    stats.dropped_datagrams =
+        unrouted_datagrams_.load(std::memory_order_relaxed) + overflow.dropped_datagrams;
+    stats.dropped_bytes = unrouted_bytes_.load(std::memory_order_relaxed) + overflow.dropped_bytes;
+    const size_t stream_count = stream_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < stream_count; ++i) {
+        const UdpDataBuffer::OverflowStats stream_overflow =
+            streams_[i]->data_buffer.getOverflowStats();
+        stats.dropped_datagrams += stream_overflow.dropped_datagrams;
+        stats.dropped_bytes += stream_overflow.dropped_bytes;
+    }
+    return {stats};
+}
+
+size_t ReplaySource::getStreamCount(size_t shard) const {
+    return shard == 0 ? stream_count_.load(std::memory_order_acquire) : 0;
+}
+
+UdpDataBuffer& ReplaySource::getStreamBuffer(size_t shard, size_t stream) {
+    if (stream >= getStreamCount(shard)) {
+        throw std::out_of_range("Replay stream index out of range");
+    }
+    return streams_[stream]->data_buffer;
+}
+
+const std::string& ReplaySource::getStreamLabel(size_t shard, size_t stream) const {
+    if (stream >= getStreamCount(shard)) {
+        throw std::out_of_range("Replay stream index out of range");
+    }
+    return streams_[stream]->label;
+}
+
+std::vector<UdpStreamStats> ReplaySource::getStreamStats() const {
+    std::vector<UdpStreamStats> result;
+    const size_t stream_count = stream_count_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < stream_count; ++i) {
+        const Stream& stream = *streams_[i];
+        UdpStreamStats stats;
+        stats.label = stream.label;
+        stats.key = stream.key;
+        stats.datagrams = stream.datagrams.load(std::memory_order_relaxed);
+        stats.bytes = stream.bytes.load(std::memory_order_relaxed);
+        const UdpDataBuffer::OverflowStats overflow = stream.data_buffer.getOverflowStats();
+        stats.dropped_datagrams = overflow.dropped_datagrams;
+        stats.dropped_bytes = overflow.dropped_bytes;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+SequenceStats ReplaySource::getSequenceStats() const {
+    return sequence_tracker_ ? sequence_tracker_->stats() : SequenceStats{};
+}
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,285 @@
+/**
+ * @file af_packet_ring.cpp
+ * @brief Implements the TPACKET_V3 memory-mapped receive ring.
+ */
+
+#include "nalu_event_collector/network/af_packet_ring.h"
+
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace nalu_event_collector {
+
+namespace {
+
+constexpr unsigned int kFrameSize = 2048;
+constexpr uint32_t kFilterSnapLength = 0x40000;
+constexpr size_t kIpv4MinHeaderSize = 20;
+constexpr size_t kUdpHeaderSize = 8;
+constexpr uint8_t kIpProtocolUdp = 17;
+
+uint16_t read_be16(const uint8_t* data) {
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+uint32_t read_be32(const uint8_t* data) {
+    return (static_cast<uint32_t>(read_be16(data)) << 16) | read_be16(data + 2);
+}
+
+std::runtime_error socket_error(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+AfPacketRing::AfPacketRing(Options options) : options_(std::move(options)) {}
+
+AfPacketRing::~AfPacketRing() { close(); }
+
+void AfPacketRing::open() {
+    if (socket_fd_ >= 0) {
+        return;
+    }
+
+    socket_fd_ = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_IP));
+    if (socket_fd_ < 0) {
+        throw socket_error("Failed to create AF_PACKET socket (CAP_NET_RAW required)");
+    }
+
+    try {
+        // Filter before binding so no unrelated frame ever lands in the ring.
+        attach_filter();
+
+        const int version = TPACKET_V3;
+        if (setsockopt(socket_fd_, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+            throw socket_error("Failed to select TPACKET_V3");
+        }
+
+        tpacket_req3 request{};
+        request.tp_block_size = static_cast<unsigned int>(options_.block_size);
+        request.tp_block_nr = static_cast<unsigned int>(options_.block_count);
+        request.tp_frame_size = kFrameSize;
+        request.tp_frame_nr =
+            static_cast<unsigned int>(options_.block_size * options_.block_count / kFrameSize);
+        request.tp_retire_blk_tov = static_cast<unsigned int>(options_.block_timeout_ms);
+        if (setsockopt(socket_fd_, SOL_PACKET, PACKET_RX_RING, &request, sizeof(request)) < 0) {
+            throw socket_error("Failed to configure PACKET_RX_RING");
+        }
+
+        ring_size_ = options_.block_size * options_.block_count;
+        void* ring = mmap(nullptr,
+                          ring_size_,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED,
+                          socket_fd_,
+                          0);
+        if (ring == MAP_FAILED) {
+            ring_size_ = 0;
+            throw socket_error("Failed to map the TPACKET_V3 ring");
+        }
+        ring_ = static_cast<uint8_t*>(ring);
+
+        sockaddr_ll link_addr{};
+        link_addr.sll_family = AF_PACKET;
+        link_addr.sll_protocol = htons(ETH_P_IP);
+        link_addr.sll_ifindex = resolve_interface_index();
+        if (bind(socket_fd_, reinterpret_cast<sockaddr*>(&link_addr), sizeof(link_addr)) < 0) {
+            throw socket_error("Failed to bind AF_PACKET socket");
+        }
+
+        if (options_.fanout_group >= 0) {
+            const int fanout = (options_.fanout_group & 0xFFFF) | (PACKET_FANOUT_HASH << 16);
+            if (setsockopt(socket_fd_, SOL_PACKET, PACKET_FANOUT, &fanout, sizeof(fanout)) < 0) {
+                throw socket_error("Failed to join PACKET_FANOUT group");
+            }
+        }
+    } catch (...) {
+        close();
+        throw;
+    }
+
+    current_block_ = 0;
+    block_held_ = false;
+}
+
+void AfPacketRing::close() {
+    if (ring_ != nullptr) {
+        munmap(ring_, ring_size_);
+        ring_ = nullptr;
+        ring_size_ = 0;
+    }
+    if (socket_fd_ >= 0) {
+        ::close(socket_fd_);
+        socket_fd_ = -1;
+    }
+    block_held_ = false;
+}
+
+bool AfPacketRing::next_block(std::vector<DatagramView>& datagrams, int timeout_ms) {
+    if (ring_ == nullptr) {
+        return false;
+    }
+
+    auto* block =
+        reinterpret_cast<tpacket_block_desc*>(ring_ + current_block_ * options_.block_size);
+    if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+        pollfd descriptor{};
+        descriptor.fd = socket_fd_;
+        descriptor.events = POLLIN | POLLERR;
+        if (poll(&descriptor, 1, timeout_ms) <= 0 ||
+            (block->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+            return false;
+        }
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    block_held_ = true;
+
+    const uint32_t packet_count = block->hdr.bh1.num_pkts;
+    auto* frame = reinterpret_cast<uint8_t*>(block) + block->hdr.bh1.offset_to_first_pkt;
+    const uint32_t destination_port = options_.port;
+
+    for (uint32_t p = 0; p < packet_count; ++p) {
+        const auto* header = reinterpret_cast<const tpacket3_hdr*>(frame);
+        const auto* link =
+            reinterpret_cast<const sockaddr_ll*>(frame + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+
+        // On loopback every datagram is seen once leaving and once arriving.
+        if (link->sll_pkttype != PACKET_OUTGOING) {
+            const uint8_t* ip = frame + header->tp_net;
+            const size_t captured = header->tp_snaplen;
+            if (captured >= kIpv4MinHeaderSize && (ip[0] >> 4) == 4 &&
+                ip[9] == kIpProtocolUdp) {
+                const size_t ip_header_size = static_cast<size_t>(ip[0] & 0x0F) * 4;
+                const uint8_t* udp = ip + ip_header_size;
+                if (captured >= ip_header_size + kUdpHeaderSize &&
+                    read_be16(udp + 2) == destination_port) {
+                    const size_t udp_length = read_be16(udp + 4);
+                    const size_t available = captured - ip_header_size;
+                    if (udp_length >= kUdpHeaderSize && udp_length <= available) {
+                        datagrams.push_back({udp + kUdpHeaderSize,
+                                             udp_length - kUdpHeaderSize,
+                                             read_be32(ip + 12),
+                                             read_be16(udp),
+                                             static_cast<uint64_t>(header->tp_sec) * 1000000000ULL +
+                                                 header->tp_nsec});
+                    }
+                }
+            }
+        }
+
+        frame += header->tp_next_offset;
+    }
+    return true;
+}
+
+void AfPacketRing::release_block() {
+    if (!block_held_) {
+        return;
+    }
+
+    auto* block =
+        reinterpret_cast<tpacket_block_desc*>(ring_ + current_block_ * options_.block_size);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+    current_block_ = (current_block_ + 1) % options_.block_count;
+    block_held_ = false;
+}
+
+uint64_t AfPacketRing::kernel_drops() {
+    if (socket_fd_ >= 0) {
+        tpacket_stats_v3 stats{};
+        socklen_t length = sizeof(stats);
+        // Reading the statistics resets them, so accumulate locally.
+        if (getsockopt(socket_fd_, SOL_PACKET, PACKET_STATISTICS, &stats, &length) == 0) {
+            kernel_drops_ += stats.tp_drops;
+        }
+    }
+    return kernel_drops_;
+}
+
+int AfPacketRing::resolve_interface_index() const {
+    if (!options_.interface_name.empty()) {
+        const unsigned int index = if_nametoindex(options_.interface_name.c_str());
+        if (index == 0) {
+            throw std::runtime_error("Unknown network interface: " + options_.interface_name);
+        }
+        return static_cast<int>(index);
+    }
+
+    in_addr target{};
+    if (inet_pton(AF_INET, options_.address.c_str(), &target) != 1 ||
+        target.s_addr == htonl(INADDR_ANY)) {
+        return 0;
+    }
+
+    ifaddrs* interfaces = nullptr;
+    if (getifaddrs(&interfaces) < 0) {
+        throw socket_error("Failed to enumerate network interfaces");
+    }
+    int index = 0;
+    for (const ifaddrs* entry = interfaces; entry != nullptr; entry = entry->ifa_next) {
+        if (entry->ifa_addr == nullptr || entry->ifa_addr->sa_family != AF_INET) {
+            continue;
+        }
+        const auto* address = reinterpret_cast<const sockaddr_in*>(entry->ifa_addr);
+        if (address->sin_addr.s_addr == target.s_addr) {
+            index = static_cast<int>(if_nametoindex(entry->ifa_name));
+            break;
+        }
+    }
+    freeifaddrs(interfaces);
+
+    if (index == 0) {
+        spdlog::warn("No interface owns {}; AF_PACKET ring will capture on all interfaces",
+                     options_.address);
+    }
+    return index;
+}
+
+void AfPacketRing::attach_filter() {
+    in_addr target{};
+    const bool match_address = inet_pton(AF_INET, options_.address.c_str(), &target) == 1 &&
+                               target.s_addr != htonl(INADDR_ANY);
+
+    // Offsets are relative to the IPv4 header because the socket is SOCK_DGRAM.
+    std::vector<sock_filter> program;
+    if (match_address) {
+        program.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 16));
+        program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohl(target.s_addr), 0, 8));
+    }
+    program.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9));
+    program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, kIpProtocolUdp, 0, 6));
+    program.push_back(BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 6));
+    program.push_back(BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x1FFF, 4, 0));
+    program.push_back(BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0));
+    program.push_back(BPF_STMT(BPF_LD | BPF_H | BPF_IND, 2));
+    program.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, options_.port, 0, 1));
+    program.push_back(BPF_STMT(BPF_RET | BPF_K, kFilterSnapLength));
+    program.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+
+    sock_fprog filter{};
+    filter.len = static_cast<unsigned short>(program.size());
+    filter.filter = program.data();
+    if (setsockopt(socket_fd_, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) < 0) {
+        throw socket_error("Failed to attach AF_PACKET port filter");
+    }
+}
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,130 @@
+/**
+ * @file datagram_pool.cpp
+ * @brief Implements the fixed-size datagram slot pool.
+ */
+
+#include "nalu_event_collector/network/datagram_pool.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace nalu_event_collector {
+
+namespace {
+
+constexpr size_t kSlotAlignment = 64;
+
+}  // namespace
+
+DatagramPool::DatagramPool(size_t slot_count, size_t slot_size)
+    : slot_count_(slot_count),
+      slot_size_(slot_size),
+      slot_stride_((slot_size + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment) {
+    if (slot_count_ == 0 || slot_size_ == 0) {
+        throw std::invalid_argument("DatagramPool requires a non-zero slot count and size");
+    }
+    if (slot_count_ > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("DatagramPool slot count exceeds 32-bit slot ids");
+    }
+
+    storage_.reset(new uint8_t[slot_count_ * slot_stride_]);
+    ready_.reset(new DatagramRef[slot_count_]);
+
+    // Hand out low slot ids first so a lightly loaded pool stays cache-warm.
+    free_slots_.resize(slot_count_);
+    for (size_t i = 0; i < slot_count_; ++i) {
+        free_slots_[i] = static_cast<uint32_t>(slot_count_ - 1 - i);
+    }
+}
+
+size_t DatagramPool::acquire(uint32_t* slots, size_t max_count) {
+    std::lock_guard<std::mutex> lock(free_mutex_);
+    const size_t count = std::min(max_count, free_slots_.size());
+    for (size_t i = 0; i < count; ++i) {
+        slots[i] = free_slots_.back();
+        free_slots_.pop_back();
+    }
+    peak_in_use_ = std::max(peak_in_use_, slot_count_ - free_slots_.size());
+    return count;
+}
+
+void DatagramPool::recycle(const uint32_t* slots, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(free_mutex_);
+    free_slots_.insert(free_slots_.end(), slots, slots + count);
+}
+
+void DatagramPool::recycle(const std::vector<DatagramRef>& refs) {
+    if (refs.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(free_mutex_);
+    for (const auto& ref : refs) {
+        free_slots_.push_back(ref.slot);
+    }
+    recycled_ += refs.size();
+}
+
+void DatagramPool::publish(const DatagramRef* refs, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    const size_t head = ready_head_.load(std::memory_order_relaxed);
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        ready_[(head + i) % slot_count_] = refs[i];
+        bytes += refs[i].payload_size;
+    }
+    published_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    ready_head_.store(head + count, std::memory_order_release);
+    published_.fetch_add(count, std::memory_order_relaxed);
+}
+
+size_t DatagramPool::drain(std::vector<DatagramRef>& out) {
+    std::lock_guard<std::mutex> lock(ready_mutex_);
+    const size_t tail = ready_tail_.load(std::memory_order_relaxed);
+    const size_t head = ready_head_.load(std::memory_order_acquire);
+    size_t bytes = 0;
+    for (size_t i = tail; i < head; ++i) {
+        out.push_back(ready_[i % slot_count_]);
+        bytes += ready_[i % slot_count_].payload_size;
+    }
+    consumed_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    ready_tail_.store(head, std::memory_order_release);
+    return head - tail;
+}
+
+size_t DatagramPool::reclaim_oldest(DatagramRef* refs, size_t max_count) {
+    std::lock_guard<std::mutex> lock(ready_mutex_);
+    const size_t tail = ready_tail_.load(std::memory_order_relaxed);
+    const size_t head = ready_head_.load(std::memory_order_relaxed);
+    const size_t count = std::min(max_count, head - tail);
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        refs[i] = ready_[(tail + i) % slot_count_];
+        bytes += refs[i].payload_size;
+    }
+    consumed_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    ready_tail_.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+DatagramPoolStats DatagramPool::stats() const {
+    DatagramPoolStats stats;
+    stats.slot_count = slot_count_;
+    stats.slot_size = slot_size_;
+    {
+        std::lock_guard<std::mutex> lock(free_mutex_);
+        stats.slots_in_use = slot_count_ - free_slots_.size();
+        stats.peak_slots_in_use = peak_in_use_;
+        stats.recycled = recycled_;
+    }
+    stats.published = published_.load(std::memory_order_relaxed);
+    stats.exhausted = exhausted_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}  // namespace nalu_event_collector
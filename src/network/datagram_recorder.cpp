@@ -0,0 +1,313 @@
+/**
+ * @file datagram_recorder.cpp
+ * @brief Implements datagram staging and the memory-mapped recording ring.
+ */
+
+#include "nalu_event_collector/network/datagram_recorder.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+namespace nalu_event_collector {
+
+namespace {
+
+// The record space starts on its own page after the file and ring headers.
+constexpr size_t kRecordSpaceOffset = 4096;
+constexpr size_t kMaxRecordSize = sizeof(CaptureRecordHeader) + kCapturePadLength - 1;
+
+static_assert(sizeof(CaptureFileHeader) + sizeof(CaptureRingHeader) <= kRecordSpaceOffset,
+              "Ring headers must fit in front of the record space");
+
+uint64_t realtime_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+void copy_in(uint8_t* storage, size_t capacity, size_t index, const void* source, size_t size) {
+    const size_t start = index % capacity;
+    const size_t first = std::min(size, capacity - start);
+    std::memcpy(storage + start, source, first);
+    std::memcpy(storage, static_cast<const uint8_t*>(source) + first, size - first);
+}
+
+void copy_out(const uint8_t* storage, size_t capacity, size_t index, void* target, size_t size) {
+    const size_t start = index % capacity;
+    const size_t first = std::min(size, capacity - start);
+    std::memcpy(target, storage + start, first);
+    std::memcpy(static_cast<uint8_t*>(target) + first, storage, size - first);
+}
+
+std::runtime_error file_error(const std::string& what, const std::string& path, int error) {
+    return std::runtime_error(what + " " + path + ": " + std::strerror(error));
+}
+
+}  // namespace
+
+DatagramRecorder::DatagramRecorder(const DatagramRecorderConfig& config, size_t shard_count)
+    : path_(config.path), data_size_(config.file_size) {
+    if (data_size_ < 2 * kMaxRecordSize) {
+        throw std::invalid_argument("Recorder file_size must hold at least two 64 KiB datagrams");
+    }
+    if (config.staging_size < kMaxRecordSize) {
+        throw std::invalid_argument("Recorder staging_size must hold at least one 64 KiB datagram");
+    }
+    for (size_t i = 0; i < shard_count; ++i) {
+        staging_.push_back(std::make_unique<Staging>(config.staging_size));
+    }
+
+    mapping_size_ = kRecordSpaceOffset + data_size_;
+    const int fd = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw file_error("Failed to create recording", path_, errno);
+    }
+    // Reserve the blocks up front so the writer never runs out of disk
+    // midway; file systems without fallocate get a sparse file instead.
+    const int allocated = posix_fallocate(fd, 0, static_cast<off_t>(mapping_size_));
+    if (allocated != 0 && (allocated != EOPNOTSUPP && allocated != EINVAL)) {
+        ::close(fd);
+        throw file_error("Failed to preallocate recording", path_, allocated);
+    }
+    if (allocated != 0 && ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw file_error("Failed to size recording", path_, error);
+    }
+    void* mapping = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int map_error = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw file_error("Failed to map recording", path_, map_error);
+    }
+    mapping_ = static_cast<uint8_t*>(mapping);
+    data_ = mapping_ + kRecordSpaceOffset;
+
+    CaptureFileHeader header{};
+    std::memcpy(header.magic, kCaptureMagic, sizeof(kCaptureMagic));
+    header.version = kCaptureVersion;
+    header.flags = kCaptureFlagRing;
+    std::memcpy(mapping_, &header, sizeof(header));
+    ring_ = reinterpret_cast<CaptureRingHeader*>(mapping_ + sizeof(CaptureFileHeader));
+    *ring_ = CaptureRingHeader{kRecordSpaceOffset, data_size_, 0, 0, 0, 0, 0};
+
+    spdlog::info("Recording datagrams to {} ({} MiB ring, {} KiB staging per shard)",
+                 path_,
+                 data_size_ >> 20,
+                 config.staging_size >> 10);
+}
+
+DatagramRecorder::~DatagramRecorder() {
+    stop();
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mapping_size_);
+    }
+}
+
+void DatagramRecorder::start() {
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread([this] { writerLoop(); });
+}
+
+void DatagramRecorder::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    msync(mapping_, mapping_size_, MS_ASYNC);
+}
+
+void DatagramRecorder::record(size_t shard, const DatagramView* datagrams, size_t count) {
+    Staging& staging = *staging_[shard];
+    size_t write_index = staging.write_index.load(std::memory_order_relaxed);
+    uint64_t now_ns = 0;
+    uint64_t dropped = 0;
+    uint64_t dropped_bytes = 0;
+    for (size_t k = 0; k < count; ++k) {
+        const DatagramView& datagram = datagrams[k];
+        const size_t size = std::min<size_t>(datagram.size, kCapturePadLength - 1);
+        const size_t needed = sizeof(CaptureRecordHeader) + size;
+        if (needed > staging.capacity - (write_index - staging.cached_read_index)) {
+            // Only look at the writer's index when the cached one says full.
+            staging.cached_read_index = staging.read_index.load(std::memory_order_acquire);
+            if (needed > staging.capacity - (write_index - staging.cached_read_index)) {
+                ++dropped;
+                dropped_bytes += size;
+                continue;
+            }
+        }
+
+        uint64_t timestamp_ns = datagram.arrival_ns;
+        if (timestamp_ns == 0) {
+            if (now_ns == 0) {
+                now_ns = realtime_ns();
+            }
+            timestamp_ns = now_ns;
+        }
+        const CaptureRecordHeader record{timestamp_ns,
+                                         datagram.source_address,
+                                         datagram.source_port,
+                                         static_cast<uint16_t>(size)};
+        copy_in(staging.storage.get(), staging.capacity, write_index, &record, sizeof(record));
+        copy_in(staging.storage.get(),
+                staging.capacity,
+                write_index + sizeof(record),
+                datagram.data,
+                size);
+        write_index += needed;
+    }
+    staging.write_index.store(write_index, std::memory_order_release);
+    if (dropped != 0) {
+        staging.dropped_datagrams.fetch_add(dropped, std::memory_order_relaxed);
+        staging.dropped_bytes.fetch_add(dropped_bytes, std::memory_order_relaxed);
+    }
+}
+
+void DatagramRecorder::writerLoop() {
+    while (true) {
+        const bool stopping = !running_;
+        bool busy = false;
+        for (auto& staging : staging_) {
+            busy |= drain(*staging);
+        }
+        publishHeader();
+
+        const uint64_t dropped = ring_->dropped;
+        if (dropped > reported_drops_) {
+            spdlog::warn("Recorder {} skipped {} datagrams because the writer fell behind",
+                         path_,
+                         dropped - reported_drops_);
+            reported_drops_ = dropped;
+        }
+
+        if (stopping) {
+            break;
+        }
+        if (!busy) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+bool DatagramRecorder::drain(Staging& staging) {
+    size_t read_index = staging.read_index.load(std::memory_order_relaxed);
+    const size_t write_index = staging.write_index.load(std::memory_order_acquire);
+    if (read_index == write_index) {
+        return false;
+    }
+
+    while (read_index != write_index) {
+        CaptureRecordHeader record;
+        copy_out(staging.storage.get(), staging.capacity, read_index, &record, sizeof(record));
+        append(record, staging, read_index + sizeof(record));
+        read_index += sizeof(record) + record.length;
+        staging.read_index.store(read_index, std::memory_order_release);
+    }
+    return true;
+}
+
+void DatagramRecorder::append(const CaptureRecordHeader& record,
+                              const Staging& staging,
+                              size_t index) {
+    const size_t needed = sizeof(record) + record.length;
+    size_t position = tail_ % data_size_;
+    size_t padding = position + needed > data_size_ ? data_size_ - position : 0;
+    while (head_ != tail_ && data_size_ - (tail_ - head_) < padding + needed) {
+        advanceHead();
+    }
+    if (head_ == tail_ && padding > 0) {
+        // Nothing is left to overwrite, so wrap without a pad marker; the
+        // padding plus the record may not fit in the ring at all.
+        tail_ += padding;
+        head_ = tail_;
+        ring_->head = head_;
+        std::atomic_thread_fence(std::memory_order_release);
+        position = 0;
+        padding = 0;
+    }
+
+    if (padding > 0) {
+        if (padding >= sizeof(record)) {
+            const CaptureRecordHeader marker{0, 0, 0, kCapturePadLength};
+            std::memcpy(data_ + position, &marker, sizeof(marker));
+        }
+        tail_ += padding;
+        position = 0;
+    }
+    std::memcpy(data_ + position, &record, sizeof(record));
+    copy_out(staging.storage.get(),
+             staging.capacity,
+             index,
+             data_ + position + sizeof(record),
+             record.length);
+    tail_ += needed;
+
+    // The record is complete before the header claims it.
+    std::atomic_thread_fence(std::memory_order_release);
+    ring_->tail = tail_;
+    recorded_datagrams_.fetch_add(1, std::memory_order_relaxed);
+    recorded_bytes_.fetch_add(record.length, std::memory_order_relaxed);
+}
+
+void DatagramRecorder::advanceHead() {
+    const size_t position = head_ % data_size_;
+    const size_t remaining = data_size_ - position;
+    if (remaining < sizeof(CaptureRecordHeader)) {
+        head_ += remaining;
+    } else {
+        CaptureRecordHeader record;
+        std::memcpy(&record, data_ + position, sizeof(record));
+        if (record.length == kCapturePadLength) {
+            head_ += remaining;
+        } else {
+            head_ += sizeof(record) + record.length;
+            overwritten_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // The header gives up the oldest record before its bytes are overwritten.
+    ring_->head = head_;
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void DatagramRecorder::publishHeader() {
+    uint64_t dropped = 0;
+    for (const auto& staging : staging_) {
+        dropped += staging->dropped_datagrams.load(std::memory_order_relaxed);
+    }
+    ring_->records = recorded_datagrams_.load(std::memory_order_relaxed);
+    ring_->overwritten = overwritten_.load(std::memory_order_relaxed);
+    ring_->dropped = dropped;
+    bytes_in_use_.store(tail_ - head_, std::memory_order_relaxed);
+}
+
+DatagramRecorderStats DatagramRecorder::stats() const {
+    DatagramRecorderStats result;
+    result.recorded_datagrams = recorded_datagrams_.load(std::memory_order_relaxed);
+    result.recorded_bytes = recorded_bytes_.load(std::memory_order_relaxed);
+    result.overwritten_datagrams = overwritten_.load(std::memory_order_relaxed);
+    result.bytes_in_use = bytes_in_use_.load(std::memory_order_relaxed);
+    for (const auto& staging : staging_) {
+        result.dropped_datagrams += staging->dropped_datagrams.load(std::memory_order_relaxed);
+        result.dropped_bytes += staging->dropped_bytes.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,430 @@
+/**
+ * @file io_uring_recv_ring.cpp
+ * @brief Implements the io_uring multishot `recvmsg` reader.
+ */
+
+#include "nalu_event_collector/network/io_uring_recv_ring.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <system_error>
+
+namespace nalu_event_collector {
+
+namespace {
+
+constexpr unsigned int kQueueEntries = 8;
+constexpr uint16_t kBufferGroup = 0;
+constexpr size_t kMaxBufferCount = 1 << 15;
+constexpr size_t kBufferAlignment = 64;
+constexpr uint64_t kReceiveUserData = 1;
+constexpr uint64_t kCancelUserData = 2;
+constexpr int kCancelWaitMs = 10;
+constexpr int kCancelAttempts = 50;
+constexpr size_t kDropCounterControlSize = CMSG_SPACE(sizeof(uint32_t));
+constexpr size_t kTimestampControlSize = CMSG_SPACE(sizeof(timespec));
+
+std::system_error uring_error(int error, const char* what) {
+    return std::system_error(error, std::generic_category(), what);
+}
+
+size_t round_up_power_of_two(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void* map_anonymous(size_t size) {
+    void* memory =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw uring_error(errno, "Failed to allocate io_uring buffers");
+    }
+    return memory;
+}
+
+}  // namespace
+
+IoUringRecvRing::IoUringRecvRing(Options options) : options_(options) {}
+
+IoUringRecvRing::~IoUringRecvRing() { close(); }
+
+void IoUringRecvRing::open(int socket_fd) {
+    if (ring_fd_ >= 0) {
+        return;
+    }
+
+    io_uring_params params{};
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, kQueueEntries, &params));
+    if (ring_fd_ < 0) {
+        ring_fd_ = -1;
+        throw uring_error(errno, "io_uring_setup failed");
+    }
+
+    try {
+        // Provided buffer rings arrived after the extended wait argument, so
+        // requiring the latter also screens out kernels older than 5.11.
+        if ((params.features & IORING_FEAT_EXT_ARG) == 0) {
+            throw uring_error(ENOSYS, "io_uring lacks IORING_FEAT_EXT_ARG");
+        }
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        void* sq_ring = mmap(nullptr,
+                             sq_ring_size_,
+                             PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             ring_fd_,
+                             IORING_OFF_SQ_RING);
+        if (sq_ring == MAP_FAILED) {
+            sq_ring_size_ = 0;
+            throw uring_error(errno, "Failed to map the io_uring submission queue");
+        }
+        sq_ring_ = static_cast<uint8_t*>(sq_ring);
+
+        if (single_mmap) {
+            cq_ring_ = sq_ring_;
+        } else {
+            void* cq_ring = mmap(nullptr,
+                                 cq_ring_size_,
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_POPULATE,
+                                 ring_fd_,
+                                 IORING_OFF_CQ_RING);
+            if (cq_ring == MAP_FAILED) {
+                cq_ring_size_ = 0;
+                throw uring_error(errno, "Failed to map the io_uring completion queue");
+            }
+            cq_ring_ = static_cast<uint8_t*>(cq_ring);
+        }
+
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr,
+                          sqes_size_,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE,
+                          ring_fd_,
+                          IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            sqes_size_ = 0;
+            throw uring_error(errno, "Failed to map the io_uring submission entries");
+        }
+        sqes_ = sqes;
+
+        sq_head_ = reinterpret_cast<unsigned int*>(sq_ring_ + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned int*>(sq_ring_ + params.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned int*>(sq_ring_ + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned int*>(sq_ring_ + params.sq_off.array);
+        cq_head_ = reinterpret_cast<unsigned int*>(cq_ring_ + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned int*>(cq_ring_ + params.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned int*>(cq_ring_ + params.cq_off.ring_mask);
+        cqes_ = cq_ring_ + params.cq_off.cqes;
+
+        register_buffers();
+
+        socket_fd_ = socket_fd;
+        std::memset(&message_, 0, sizeof(message_));
+        message_.msg_namelen = sizeof(sockaddr_in);
+        message_.msg_controllen = control_size();
+        arm_receive();
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+void IoUringRecvRing::close() {
+    if (ring_fd_ >= 0) {
+        // The armed request holds a reference to the socket; cancel it so
+        // the port is released as soon as the caller closes the socket.
+        cancel_receive();
+        if (buffers_registered_) {
+            io_uring_buf_reg registration{};
+            registration.bgid = kBufferGroup;
+            syscall(__NR_io_uring_register,
+                    ring_fd_,
+                    IORING_UNREGISTER_PBUF_RING,
+                    &registration,
+                    1);
+            buffers_registered_ = false;
+        }
+        ::close(ring_fd_);
+        ring_fd_ = -1;
+    }
+
+    if (sqes_ != nullptr) {
+        munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    cq_ring_ = nullptr;
+    if (sq_ring_ != nullptr) {
+        munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = nullptr;
+    }
+    if (buffer_ring_ != nullptr) {
+        munmap(buffer_ring_, buffer_ring_size_);
+        buffer_ring_ = nullptr;
+    }
+    if (buffers_ != nullptr) {
+        munmap(buffers_, buffers_size_);
+        buffers_ = nullptr;
+    }
+
+    held_buffers_.clear();
+    socket_fd_ = -1;
+    armed_ = false;
+}
+
+bool IoUringRecvRing::next_batch(std::vector<DatagramView>& datagrams, int timeout_ms) {
+    if (ring_fd_ < 0) {
+        return false;
+    }
+    if (!armed_) {
+        // The previous multishot request ended (typically on buffer exhaustion).
+        arm_receive();
+    }
+
+    unsigned int head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        enter(0, 1, timeout_ms);
+    }
+
+    const unsigned int tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    const unsigned int mask = *cq_mask_;
+    const size_t first = datagrams.size();
+    for (; head != tail; ++head) {
+        const io_uring_cqe& completion = static_cast<const io_uring_cqe*>(cqes_)[head & mask];
+        if (completion.user_data != kReceiveUserData) {
+            continue;
+        }
+        if ((completion.flags & IORING_CQE_F_MORE) == 0) {
+            armed_ = false;
+        }
+
+        if (completion.res < 0) {
+            if (completion.res == -ENOBUFS) {
+                ++buffer_stalls_;
+            } else if (completion.res == -EINVAL || completion.res == -EOPNOTSUPP) {
+                __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+                throw uring_error(-completion.res, "Multishot recvmsg is not supported");
+            }
+            continue;
+        }
+        if ((completion.flags & IORING_CQE_F_BUFFER) == 0) {
+            continue;
+        }
+
+        const auto buffer_id =
+            static_cast<uint16_t>(completion.flags >> IORING_CQE_BUFFER_SHIFT);
+        held_buffers_.push_back(buffer_id);
+
+        uint8_t* buffer = buffers_ + static_cast<size_t>(buffer_id) * buffer_size_;
+        io_uring_recvmsg_out header;
+        std::memcpy(&header, buffer, sizeof(header));
+        const size_t payload_offset =
+            sizeof(io_uring_recvmsg_out) + message_.msg_namelen + message_.msg_controllen;
+        const size_t written = static_cast<size_t>(completion.res);
+        if (written < payload_offset) {
+            continue;
+        }
+        // A truncated datagram reports its full length; clamp it so the
+        // transport-header check rejects it instead of reading past the buffer.
+        const size_t size = std::min<size_t>(header.payloadlen, written - payload_offset);
+        DatagramView datagram{buffer + payload_offset, size};
+        if (header.namelen >= sizeof(sockaddr_in)) {
+            sockaddr_in source;
+            std::memcpy(&source, buffer + sizeof(io_uring_recvmsg_out), sizeof(source));
+            datagram.source_address = ntohl(source.sin_addr.s_addr);
+            datagram.source_port = ntohs(source.sin_port);
+        }
+        if (header.controllen > 0) {
+            read_control(buffer + sizeof(io_uring_recvmsg_out) + message_.msg_namelen,
+                         std::min<size_t>(header.controllen, message_.msg_controllen),
+                         datagram);
+        }
+        datagrams.push_back(datagram);
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+    return datagrams.size() > first;
+}
+
+void IoUringRecvRing::release_batch() {
+    if (held_buffers_.empty() || buffer_ring_ == nullptr) {
+        return;
+    }
+
+    // io_uring_buf_ring::bufs is a flexible array that C++ lays out one empty
+    // struct late, so index the entries directly; the ring tail overlays the
+    // reserved field of entry 0.
+    auto* entries = static_cast<io_uring_buf*>(buffer_ring_);
+    const size_t mask = buffer_count_ - 1;
+    for (uint16_t buffer_id : held_buffers_) {
+        io_uring_buf& entry = entries[buffer_tail_ & mask];
+        entry.addr = reinterpret_cast<uint64_t>(buffers_ + buffer_id * buffer_size_);
+        entry.len = static_cast<uint32_t>(buffer_size_);
+        entry.bid = buffer_id;
+        ++buffer_tail_;
+    }
+    __atomic_store_n(&entries[0].resv, buffer_tail_, __ATOMIC_RELEASE);
+    held_buffers_.clear();
+}
+
+size_t IoUringRecvRing::control_size() const {
+    return (options_.receive_drop_counter ? kDropCounterControlSize : 0) +
+           (options_.receive_timestamps ? kTimestampControlSize : 0);
+}
+
+void IoUringRecvRing::read_control(uint8_t* control, size_t size, DatagramView& datagram) {
+    // The control area is laid out like a regular msg_control buffer.
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = size;
+    for (cmsghdr* entry = CMSG_FIRSTHDR(&message); entry != nullptr;
+         entry = CMSG_NXTHDR(&message, entry)) {
+        if (entry->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+        if (entry->cmsg_type == SO_RXQ_OVFL) {
+            std::memcpy(&socket_drop_counter_, CMSG_DATA(entry), sizeof(uint32_t));
+        } else if (entry->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec arrival;
+            std::memcpy(&arrival, CMSG_DATA(entry), sizeof(arrival));
+            datagram.arrival_ns = static_cast<uint64_t>(arrival.tv_sec) * 1000000000ULL +
+                                  static_cast<uint64_t>(arrival.tv_nsec);
+        }
+    }
+}
+
+void IoUringRecvRing::register_buffers() {
+    buffer_count_ =
+        std::min(round_up_power_of_two(std::max<size_t>(options_.buffer_count, 1)),
+                 kMaxBufferCount);
+    buffer_size_ = sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in) + options_.max_datagram_size;
+    buffer_size_ += control_size();
+    buffer_size_ = (buffer_size_ + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+
+    buffer_ring_size_ = buffer_count_ * sizeof(io_uring_buf);
+    buffer_ring_ = map_anonymous(buffer_ring_size_);
+    buffers_size_ = buffer_count_ * buffer_size_;
+    buffers_ = static_cast<uint8_t*>(map_anonymous(buffers_size_));
+
+    io_uring_buf_reg registration{};
+    registration.ring_addr = reinterpret_cast<uint64_t>(buffer_ring_);
+    registration.ring_entries = static_cast<uint32_t>(buffer_count_);
+    registration.bgid = kBufferGroup;
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &registration, 1) <
+        0) {
+        throw uring_error(errno, "Failed to register the io_uring buffer ring");
+    }
+    buffers_registered_ = true;
+
+    buffer_tail_ = 0;
+    held_buffers_.reserve(buffer_count_);
+    for (size_t i = 0; i < buffer_count_; ++i) {
+        held_buffers_.push_back(static_cast<uint16_t>(i));
+    }
+    release_batch();
+}
+
+void IoUringRecvRing::arm_receive() {
+    io_uring_sqe entry{};
+    entry.opcode = IORING_OP_RECVMSG;
+    entry.fd = socket_fd_;
+    entry.addr = reinterpret_cast<uint64_t>(&message_);
+    entry.ioprio = IORING_RECV_MULTISHOT;
+    entry.flags = IOSQE_BUFFER_SELECT;
+    entry.buf_group = kBufferGroup;
+    entry.user_data = kReceiveUserData;
+    submit(entry);
+    armed_ = true;
+}
+
+void IoUringRecvRing::cancel_receive() {
+    if (!armed_ || sqes_ == nullptr) {
+        return;
+    }
+
+    io_uring_sqe entry{};
+    entry.opcode = IORING_OP_ASYNC_CANCEL;
+    entry.fd = -1;
+    entry.addr = kReceiveUserData;
+    entry.user_data = kCancelUserData;
+    try {
+        submit(entry);
+        for (int attempt = 0; attempt < kCancelAttempts && armed_; ++attempt) {
+            unsigned int head = *cq_head_;
+            if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+                enter(0, 1, kCancelWaitMs);
+            }
+            const unsigned int tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head) {
+                const io_uring_cqe& completion =
+                    static_cast<const io_uring_cqe*>(cqes_)[head & *cq_mask_];
+                if (completion.user_data == kReceiveUserData &&
+                    (completion.flags & IORING_CQE_F_MORE) == 0) {
+                    armed_ = false;
+                }
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        }
+    } catch (const std::system_error&) {
+        // Tearing the ring down cancels the request as well, just later.
+    }
+    armed_ = false;
+}
+
+void IoUringRecvRing::submit(const io_uring_sqe& entry) {
+    const unsigned int tail = *sq_tail_;
+    const unsigned int index = tail & *sq_mask_;
+    static_cast<io_uring_sqe*>(sqes_)[index] = entry;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    enter(1, 0, 0);
+}
+
+int IoUringRecvRing::enter(unsigned int to_submit, unsigned int min_complete, int timeout_ms) {
+    unsigned int flags = 0;
+    io_uring_getevents_arg argument{};
+    __kernel_timespec timeout{};
+    if (min_complete > 0) {
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+        argument.ts = reinterpret_cast<uint64_t>(&timeout);
+    }
+
+    const long result = syscall(__NR_io_uring_enter,
+                                ring_fd_,
+                                to_submit,
+                                min_complete,
+                                flags,
+                                min_complete > 0 ? &argument : nullptr,
+                                min_complete > 0 ? sizeof(argument) : 0);
+    if (result < 0) {
+        if (errno == ETIME || errno == EINTR || errno == EBUSY) {
+            return 0;
+        }
+        throw uring_error(errno, "io_uring_enter failed");
+    }
+    return static_cast<int>(result);
+}
+
+}  // namespace nalu_event_collector
@@ -0,0 +1,149 @@
+/**
+ * @file sequence_tracker.cpp
+ * @brief Implements per-source sequence continuity tracking.
+ */
+
+#include "nalu_event_collector/network/sequence_tracker.h"
+
+#include <stdexcept>
+
+#include "nalu_event_collector/network/transport_header.h"
+
+namespace nalu_event_collector {
+
+namespace {
+
+constexpr uint64_t kWindowSize = 64;
+
+uint64_t source_key(const DatagramView& datagram) {
+    return (static_cast<uint64_t>(datagram.source_address) << 16) | datagram.source_port;
+}
+
+void accumulate(SequenceStats& total, const SequenceStats& stats) {
+    total.received += stats.received;
+    total.gaps += stats.gaps;
+    total.missing += stats.missing;
+    total.duplicates += stats.duplicates;
+    total.reordered += stats.reordered;
+    total.restarts += stats.restarts;
+}
+
+}  // namespace
+
+SequenceTracker::SequenceTracker(size_t field_offset, size_t field_width)
+    : field_offset_(field_offset), field_width_(field_width) {
+    if (field_width != 1 && field_width != 2 && field_width != 4 && field_width != 8) {
+        throw std::invalid_argument("Sequence field width must be 1, 2, 4, or 8 bytes");
+    }
+    if (field_offset + field_width > kTransportHeaderSize) {
+        throw std::invalid_argument("Sequence field must lie inside the 16-byte transport header");
+    }
+    sequence_mask_ = field_width == 8 ? ~uint64_t{0} : (uint64_t{1} << (field_width * 8)) - 1;
+}
+
+void SequenceTracker::observe(const DatagramView* datagrams, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t sequence = read_sequence(datagrams[i].data);
+        auto inserted = sources_.try_emplace(source_key(datagrams[i]));
+        SourceState& state = inserted.first->second;
+        if (inserted.second) {
+            state.highest = sequence;
+            state.window = 1;
+            state.stats.sources = 1;
+            state.stats.received = 1;
+            continue;
+        }
+        observe_one(state, sequence);
+    }
+}
+
+SequenceStats SequenceTracker::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SequenceStats total;
+    total.sources = sources_.size();
+    for (const auto& entry : sources_) {
+        accumulate(total, entry.second.stats);
+    }
+    return total;
+}
+
+std::vector<SourceSequenceStats> SequenceTracker::source_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<SourceSequenceStats> result;
+    result.reserve(sources_.size());
+    for (const auto& entry : sources_) {
+        SourceSequenceStats source;
+        source.address = static_cast<uint32_t>(entry.first >> 16);
+        source.port = static_cast<uint16_t>(entry.first & 0xFFFF);
+        source.expected_next = (entry.second.highest + 1) & sequence_mask_;
+        source.stats = entry.second.stats;
+        result.push_back(source);
+    }
+    return result;
+}
+
+void SequenceTracker::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.clear();
+}
+
+uint64_t SequenceTracker::read_sequence(const uint8_t* header) const {
+    uint64_t sequence = 0;
+    for (size_t i = 0; i < field_width_; ++i) {
+        sequence = (sequence << 8) | header[field_offset_ + i];
+    }
+    return sequence;
+}
+
+void SequenceTracker::observe_one(SourceState& state, uint64_t sequence) {
+    SequenceStats& stats = state.stats;
+    ++stats.received;
+
+    // Distance from the highest sequence seen, interpreted as a signed value
+    // in the counter's own width so wrap-around counts as moving forward.
+    const uint64_t forward = (sequence - state.highest) & sequence_mask_;
+    const uint64_t half_range = (sequence_mask_ >> 1) + 1;
+
+    if (forward == 0) {
+        ++stats.duplicates;
+        return;
+    }
+
+    if (forward < half_range) {
+        if (forward > 1) {
+            ++stats.gaps;
+            stats.missing += forward - 1;
+        }
+        state.window = forward >= kWindowSize ? 0 : state.window << forward;
+        state.window |= 1;
+        state.highest = sequence;
+        return;
+    }
+
+    const uint64_t backward = (state.highest - sequence) & sequence_mask_;
+    if (backward < kWindowSize) {
+        const uint64_t bit = uint64_t{1} << backward;
+        if ((state.window & bit) != 0) {
+            ++stats.duplicates;
+        } else {
+            state.window |= bit;
+            ++stats.reordered;
+            if (stats.missing > 0) {
+                --stats.missing;
+            }
+        }
+        return;
+    }
+
+    // Too far behind to be a late arrival: the sender most likely restarted.
+    ++stats.restarts;
+    state.highest = sequence;
+    state.window = 1;
+}
+
+}  // namespace nalu_event_collector
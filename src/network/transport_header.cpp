@@ -0,0 +1,51 @@
+/**
+ * @file transport_header.cpp
+ * @brief Implements transport-header validation and sender formatting.
+ */
+
+#include "nalu_event_collector/network/transport_header.h"
+
+#include <arpa/inet.h>
+
+#include <cstring>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+namespace nalu_event_collector {
+
+bool validate_transport_header(const uint8_t* datagram, size_t size, uint16_t& payload_size) {
+    if (size < kTransportHeaderSize) {
+        spdlog::warn("Malformed UDP packet: too small ({} bytes)", size);
+        return false;
+    }
+
+    std::memcpy(&payload_size, datagram, sizeof(uint16_t));
+    payload_size = ntohs(payload_size);
+
+    if (payload_size != static_cast<uint16_t>(size - kTransportHeaderSize)) {
+        spdlog::warn("Malformed UDP packet: expected payload size {}, received {}",
+                     payload_size,
+                     size - kTransportHeaderSize);
+        return false;
+    }
+    return true;
+}
+
+uint64_t read_board_id(const uint8_t* datagram, size_t offset, size_t width) {
+    uint64_t board_id = 0;
+    for (size_t i = 0; i < width; ++i) {
+        board_id = (board_id << 8) | datagram[offset + i];
+    }
+    return board_id;
+}
+
+std::string format_source(uint32_t address, uint16_t port) {
+    in_addr host{};
+    host.s_addr = htonl(address);
+    char text[INET_ADDRSTRLEN] = {};
+    inet_ntop(AF_INET, &host, text, sizeof(text));
+    return std::string(text) + ":" + std::to_string(port);
+}
+
+}  // namespace nalu_event_collector
@@ -1,64 +1,244 @@
 /**
  * @file udp_data_buffer.cpp
- * @brief Implements the raw UDP byte buffer used by the receiver.
+ * @brief Implements the raw UDP byte ring used by the receiver.
  */
 
 #include "nalu_event_collector/network/udp_data_buffer.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 #include <spdlog/spdlog.h>
 
 namespace nalu_event_collector {
 
-UdpDataBuffer::UdpDataBuffer(size_t size) : capacity_(size) {}
+namespace {
 
-void UdpDataBuffer::append(const uint8_t* data, size_t size) {
-    std::lock_guard<std::mutex> lock(mutex_);
+// Smallest datagram the record ring is sized for; smaller ones only cost
+// boundary information once the ring is full, never correctness.
+constexpr size_t kMinRecordBytes = 256;
+constexpr size_t kMinRecordCapacity = 64;
+
+}  // namespace
 
+UdpDataBuffer::UdpDataBuffer(size_t size)
+    : storage_(new uint8_t[size == 0 ? 1 : size]),
+      capacity_(size),
+      record_capacity_(std::max(size / kMinRecordBytes, kMinRecordCapacity)) {
+    records_.reset(new size_t[record_capacity_]);
+}
+
+void UdpDataBuffer::append(const uint8_t* data, size_t size) {
     if (data == nullptr) {
         throw std::invalid_argument("Null pointer passed to append");
     }
 
-    if (buffer_.size() + size > capacity_) {
-        if (overflow_callback_) {
-            overflow_callback_();
+    const Segment segment{data, size};
+    appendBatch(&segment, 1);
+}
+
+void UdpDataBuffer::appendBatch(const Segment* segments, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (segments == nullptr) {
+        throw std::invalid_argument("Null pointer passed to appendBatch");
+    }
+
+    size_t batch_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (segments[i].data == nullptr) {
+            throw std::invalid_argument("Null segment passed to appendBatch");
         }
-        spdlog::error("UDP buffer overflow: append={} capacity={} current={}",
-                      size,
-                      capacity_,
-                      buffer_.size());
-        throw std::overflow_error("Buffer overflow");
+        batch_size += segments[i].size;
+    }
+
+    size_t write_index = write_index_.load(std::memory_order_relaxed);
+    while (count > 0) {
+        const size_t used = write_index - read_index_.load(std::memory_order_acquire);
+        size_t accepted = count;
+        bool keep_rest = false;
+        if (used + batch_size > capacity_) {
+            accepted = handleOverflow(segments, count, batch_size, used, keep_rest);
+        } else if (overflowing_) {
+            overflowing_ = false;
+            spdlog::info("UDP buffer recovered from overflow");
+        }
+
+        for (size_t i = 0; i < accepted; ++i) {
+            writeAt(write_index, segments[i].data, segments[i].size);
+            write_index += segments[i].size;
+            batch_size -= segments[i].size;
+            pushRecord(write_index);
+            if (arrivals_ != nullptr) {
+                pushArrival(write_index, segments[i].arrival_ns);
+            }
+        }
+        if (accepted > 0) {
+            publish(write_index);
+        }
+        if (!keep_rest) {
+            return;
+        }
+        segments += accepted;
+        count -= accepted;
+    }
+}
+
+UdpDataBuffer::ReadView UdpDataBuffer::acquireRead() {
+    return acquireRead(std::numeric_limits<size_t>::max());
+}
+
+UdpDataBuffer::ReadView UdpDataBuffer::acquireRead(size_t max_bytes) {
+    std::unique_lock<std::mutex> claim_lock;
+    if (overflow_policy_ == OverflowPolicy::DropOldest) {
+        claim_lock = std::unique_lock<std::mutex>(claim_mutex_);
+    }
+
+    const size_t read_index = read_index_.load(std::memory_order_relaxed);
+    size_t write_index = write_index_.load(std::memory_order_acquire);
+    if (write_index - read_index > max_bytes) {
+        write_index = claimEnd(read_index, read_index + max_bytes, write_index);
+    }
+    claimed_start_ = read_index;
+    claimed_index_ = write_index;
+
+    ReadView view;
+    const size_t available = write_index - read_index;
+    // An empty claim pins nothing, so drop-oldest stays possible.
+    claim_active_ = available != 0;
+    if (available == 0) {
+        return view;
     }
 
-    buffer_.insert(buffer_.end(), data, data + size);
-    cv_.notify_all();
+    const size_t start = read_index % capacity_;
+    view.first = storage_.get() + start;
+    view.first_size = std::min(available, capacity_ - start);
+    if (view.first_size < available) {
+        view.second = storage_.get();
+        view.second_size = available - view.first_size;
+    }
+    return view;
+}
+
+void UdpDataBuffer::releaseRead() {
+    if (overflow_policy_ == OverflowPolicy::DropOldest) {
+        std::lock_guard<std::mutex> claim_lock(claim_mutex_);
+        if (claim_active_) {
+            releaseTo(claimed_index_);
+            claim_active_ = false;
+        }
+        return;
+    }
+    releaseTo(claimed_index_);
+}
+
+size_t UdpDataBuffer::claimEnd(size_t read_index, size_t limit, size_t write_index) const {
+    if (arrivals_ == nullptr) {
+        return limit;
+    }
+
+    // Stop on the last queued segment end within the limit so marks and
+    // datagram records never straddle two claims; a segment longer than the
+    // limit is claimed whole.
+    size_t end = write_index;
+    const size_t tail = arrival_tail_.load(std::memory_order_acquire);
+    for (size_t head = arrival_head_.load(std::memory_order_relaxed); head != tail; ++head) {
+        const size_t end_index = arrivals_[head % arrival_capacity_].end_index;
+        if (end_index <= read_index) {
+            continue;
+        }
+        if (end_index > limit) {
+            if (end == write_index) {
+                end = std::min(end_index, write_index);
+            }
+            break;
+        }
+        end = end_index;
+    }
+    return end;
+}
+
+void UdpDataBuffer::takeArrivals(std::vector<ArrivalMark>& marks) {
+    if (arrivals_ == nullptr) {
+        return;
+    }
+
+    size_t head = arrival_head_.load(std::memory_order_relaxed);
+    const size_t tail = arrival_tail_.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+        const ArrivalRecord& record = arrivals_[head % arrival_capacity_];
+        if (record.end_index > claimed_index_) {
+            break;
+        }
+        // Records at or behind the claim start belong to dropped data.
+        if (record.end_index > claimed_start_) {
+            marks.push_back({record.end_index - claimed_start_, record.arrival_ns});
+        }
+    }
+    arrival_head_.store(head, std::memory_order_release);
+}
+
+void UdpDataBuffer::enableArrivalTracking() {
+    arrival_capacity_ = record_capacity_;
+    arrivals_.reset(new ArrivalRecord[arrival_capacity_]);
 }
 
 bool UdpDataBuffer::pop(uint8_t& byte) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (buffer_.empty()) {
+    std::unique_lock<std::mutex> claim_lock;
+    if (overflow_policy_ == OverflowPolicy::DropOldest) {
+        claim_lock = std::unique_lock<std::mutex>(claim_mutex_);
+    }
+
+    const size_t read_index = read_index_.load(std::memory_order_relaxed);
+    if (read_index == write_index_.load(std::memory_order_acquire)) {
         return false;
     }
 
-    byte = buffer_.front();
-    buffer_.pop_front();
+    byte = storage_[read_index % capacity_];
+    claimed_index_ = read_index + 1;
+    releaseTo(claimed_index_);
     return true;
 }
 
 size_t UdpDataBuffer::size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return buffer_.size();
+    const size_t read_index = read_index_.load(std::memory_order_acquire);
+    return write_index_.load(std::memory_order_acquire) - read_index;
 }
 
 std::vector<uint8_t> UdpDataBuffer::getAllBytes() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::vector<uint8_t> result(buffer_.begin(), buffer_.end());
-    buffer_.clear();
+    const ReadView view = acquireRead();
+    std::vector<uint8_t> result(view.size());
+    if (view.first_size > 0) {
+        std::memcpy(result.data(), view.first, view.first_size);
+    }
+    if (view.second_size > 0) {
+        std::memcpy(result.data() + view.first_size, view.second, view.second_size);
+    }
+    releaseRead();
     return result;
 }
 
 void UdpDataBuffer::waitForBytes(size_t min_count) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    cv_.wait(lock, [this, min_count] { return buffer_.size() >= min_count; });
+    waiters_.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this, min_count] { return size() >= min_count; });
+    }
+    waiters_.fetch_sub(1);
+}
+
+bool UdpDataBuffer::waitForBytes(size_t min_count, std::chrono::microseconds max_wait) {
+    waiters_.fetch_add(1);
+    bool available = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        available =
+            cv_.wait_for(lock, max_wait, [this, min_count] { return size() >= min_count; });
+    }
+    waiters_.fetch_sub(1);
+    return available;
 }
 
 void UdpDataBuffer::setOverflowCallback(std::function<void()> callback) {
@@ -66,14 +246,208 @@ void UdpDataBuffer::setOverflowCallback(std::function<void()> callback) {
     overflow_callback_ = std::move(callback);
 }
 
-bool UdpDataBuffer::isEmpty() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return buffer_.empty();
+void UdpDataBuffer::setOverflowPolicy(OverflowPolicy policy,
+                                      std::chrono::milliseconds block_timeout) {
+    overflow_policy_ = policy;
+    block_timeout_ = block_timeout;
 }
 
-bool UdpDataBuffer::isFull() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return buffer_.size() == capacity_;
+UdpDataBuffer::OverflowStats UdpDataBuffer::getOverflowStats() const {
+    OverflowStats stats;
+    stats.overflows = overflows_.load(std::memory_order_relaxed);
+    stats.dropped_datagrams = dropped_datagrams_.load(std::memory_order_relaxed);
+    stats.dropped_bytes = dropped_bytes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool UdpDataBuffer::isEmpty() const { return size() == 0; }
+
+bool UdpDataBuffer::isFull() const { return size() == capacity_; }
+
+void UdpDataBuffer::writeAt(size_t index, const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    const size_t start = index % capacity_;
+    const size_t first = std::min(size, capacity_ - start);
+    std::memcpy(storage_.get() + start, data, first);
+    if (first < size) {
+        std::memcpy(storage_.get(), data + first, size - first);
+    }
+}
+
+void UdpDataBuffer::publish(size_t write_index) {
+    // Sequentially consistent so a waiter registering concurrently either sees
+    // the new bytes in its predicate or is seen here and notified.
+    write_index_.store(write_index);
+    if (waiters_.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_all();
+    }
+}
+
+void UdpDataBuffer::releaseTo(size_t read_index) {
+    // Same pairing as publish(), for a producer blocked on free space.
+    read_index_.store(read_index);
+    if (space_waiters_.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        space_cv_.notify_all();
+    }
+}
+
+void UdpDataBuffer::pushRecord(size_t end_index) {
+    if (record_tail_ - record_head_ == record_capacity_) {
+        const size_t read_index = read_index_.load(std::memory_order_acquire);
+        while (record_head_ != record_tail_ &&
+               records_[record_head_ % record_capacity_] <= read_index) {
+            ++record_head_;
+        }
+        if (record_tail_ - record_head_ == record_capacity_) {
+            // Forgetting the oldest boundary merges two datagrams for dropping purposes.
+            ++record_head_;
+        }
+    }
+    records_[record_tail_ % record_capacity_] = end_index;
+    ++record_tail_;
+}
+
+void UdpDataBuffer::pushArrival(size_t end_index, uint64_t arrival_ns) {
+    const size_t tail = arrival_tail_.load(std::memory_order_relaxed);
+    if (tail - arrival_head_.load(std::memory_order_acquire) == arrival_capacity_) {
+        // The consumer is behind; its bytes inherit the next queued arrival time.
+        return;
+    }
+    arrivals_[tail % arrival_capacity_] = {end_index, arrival_ns};
+    arrival_tail_.store(tail + 1, std::memory_order_release);
+}
+
+size_t UdpDataBuffer::handleOverflow(const Segment* segments,
+                                     size_t count,
+                                     size_t requested,
+                                     size_t used,
+                                     bool& keep_rest) {
+    keep_rest = false;
+    if (overflow_policy_ == OverflowPolicy::Block) {
+        // Move whatever fits now and keep the rest for another attempt; only
+        // wait when not even the next segment fits.
+        size_t fitting = 0;
+        size_t fitting_bytes = 0;
+        while (fitting < count && used + fitting_bytes + segments[fitting].size <= capacity_) {
+            fitting_bytes += segments[fitting].size;
+            ++fitting;
+        }
+        if (fitting > 0) {
+            keep_rest = true;
+            return fitting;
+        }
+        if (waitForSpace(segments[0].size)) {
+            keep_rest = true;
+            return 0;
+        }
+    }
+
+    overflows_.fetch_add(1, std::memory_order_relaxed);
+
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        callback = overflow_callback_;
+    }
+    if (callback) {
+        callback();
+    }
+
+    if (overflow_policy_ == OverflowPolicy::Throw) {
+        spdlog::error("UDP buffer overflow: append={} capacity={} current={}",
+                      requested,
+                      capacity_,
+                      used);
+        throw std::overflow_error("Buffer overflow");
+    }
+
+    if (!overflowing_) {
+        overflowing_ = true;
+        spdlog::warn("UDP buffer overflow: append={} capacity={} current={}; dropping data",
+                     requested,
+                     capacity_,
+                     used);
+    }
+
+    if (overflow_policy_ == OverflowPolicy::DropOldest) {
+        used -= dropOldest(requested);
+    } else {
+        used = size();
+    }
+
+    return dropNewest(segments, count, capacity_ - std::min(used, capacity_));
+}
+
+bool UdpDataBuffer::waitForSpace(size_t requested) {
+    if (requested > capacity_) {
+        return false;
+    }
+
+    space_waiters_.fetch_add(1);
+    bool fits = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        fits = space_cv_.wait_for(lock, block_timeout_, [this, requested] {
+            return size() + requested <= capacity_;
+        });
+    }
+    space_waiters_.fetch_sub(1);
+    return fits;
+}
+
+size_t UdpDataBuffer::dropOldest(size_t requested) {
+    std::lock_guard<std::mutex> claim_lock(claim_mutex_);
+    if (claim_active_) {
+        // The consumer is reading the oldest bytes right now; keep them.
+        return 0;
+    }
+
+    const size_t read_index = read_index_.load(std::memory_order_relaxed);
+    const size_t write_index = write_index_.load(std::memory_order_relaxed);
+    const size_t target_free = std::min(requested, capacity_);
+
+    size_t new_read_index = read_index;
+    uint64_t datagrams = 0;
+    while (record_head_ != record_tail_ &&
+           capacity_ - (write_index - new_read_index) < target_free) {
+        const size_t end = records_[record_head_ % record_capacity_];
+        ++record_head_;
+        if (end <= new_read_index) {
+            continue;
+        }
+        new_read_index = end;
+        ++datagrams;
+    }
+    if (new_read_index == read_index) {
+        return 0;
+    }
+
+    dropped_datagrams_.fetch_add(datagrams, std::memory_order_relaxed);
+    dropped_bytes_.fetch_add(new_read_index - read_index, std::memory_order_relaxed);
+    releaseTo(new_read_index);
+    return new_read_index - read_index;
+}
+
+size_t UdpDataBuffer::dropNewest(const Segment* segments, size_t count, size_t free_bytes) {
+    size_t accepted = 0;
+    size_t accepted_bytes = 0;
+    while (accepted < count && accepted_bytes + segments[accepted].size <= free_bytes) {
+        accepted_bytes += segments[accepted].size;
+        ++accepted;
+    }
+
+    uint64_t dropped_bytes = 0;
+    for (size_t i = accepted; i < count; ++i) {
+        dropped_bytes += segments[i].size;
+    }
+    dropped_datagrams_.fetch_add(count - accepted, std::memory_order_relaxed);
+    dropped_bytes_.fetch_add(dropped_bytes, std::memory_order_relaxed);
+    return accepted;
 }
 
 }  // namespace nalu_event_collector
@@ -6,58 +6,335 @@
 #include "nalu_event_collector/network/udp_receiver.h"
 
 #include <arpa/inet.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
 #include <cstring>
+#include <ctime>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
 namespace nalu_event_collector {
 
+namespace {
+
+// Room for the `SO_RXQ_OVFL` drop counter and `SO_TIMESTAMPNS` arrival time
+// control messages attached to received datagrams.
+constexpr size_t kReceiveControlSize = CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(sizeof(timespec));
+
+union ReceiveControl {
+    cmsghdr header;
+    uint8_t bytes[kReceiveControlSize];
+};
+
+// Read the control messages of one datagram. The kernel attaches the
+// cumulative drop counter only after the first drop, so the return value
+// says whether @p drop_counter was updated.
+bool read_control(const msghdr& message, uint32_t& drop_counter, uint64_t& arrival_ns) {
+    bool has_drop_counter = false;
+    for (cmsghdr* entry = CMSG_FIRSTHDR(&message); entry != nullptr;
+         entry = CMSG_NXTHDR(const_cast<msghdr*>(&message), entry)) {
+        if (entry->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+        if (entry->cmsg_type == SO_RXQ_OVFL) {
+            std::memcpy(&drop_counter, CMSG_DATA(entry), sizeof(drop_counter));
+            has_drop_counter = true;
+        } else if (entry->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec arrival;
+            std::memcpy(&arrival, CMSG_DATA(entry), sizeof(arrival));
+            arrival_ns = static_cast<uint64_t>(arrival.tv_sec) * 1000000000ULL +
+                         static_cast<uint64_t>(arrival.tv_nsec);
+        }
+    }
+    return has_drop_counter;
+}
+
+}  // namespace
+
 UdpReceiver::UdpReceiver(const std::string& address,
                          uint16_t port,
                          size_t buffer_size,
                          size_t max_packet_size,
-                         int timeout_sec)
+                         int timeout_sec,
+                         size_t recv_batch_size)
     : address_(address),
-      port_(port),
-      socket_fd_(-1),
       running_(false),
-      data_buffer_(buffer_size),
       max_packet_size_(max_packet_size),
-      timeout_sec_(timeout_sec) {}
+      timeout_sec_(timeout_sec),
+      recv_batch_size_(recv_batch_size == 0 ? 1 : recv_batch_size),
+      reuse_port_(false),
+      backend_(Backend::Socket),
+      overflow_policy_(UdpDataBuffer::OverflowPolicy::DropNewest),
+      overflow_block_timeout_(100) {
+    shards_.push_back(std::make_unique<Shard>(port, buffer_size));
+    shards_.front()->data_buffer.setOverflowPolicy(overflow_policy_, overflow_block_timeout_);
+}
 
 UdpReceiver::UdpReceiver(const UdpReceiverConfig& config)
-    : UdpReceiver(config.address,
-                  config.port,
-                  config.buffer_size,
-                  config.max_packet_size,
-                  config.timeout_sec) {}
+    : address_(config.address),
+      running_(false),
+      max_packet_size_(config.max_packet_size),
+      timeout_sec_(config.timeout_sec),
+      recv_batch_size_(config.recv_batch_size == 0 ? 1 : config.recv_batch_size),
+      reuse_port_(config.socket_count > 1),
+      backend_(parseBackend(config.backend)),
+      overflow_policy_(parseOverflowPolicy(config.overflow_policy)),
+      overflow_block_timeout_(config.overflow_block_timeout_ms),
+      socket_receive_buffer_(config.socket_receive_buffer),
+      socket_receive_buffer_force_(config.socket_receive_buffer_force),
+      socket_receive_buffer_autotune_(config.socket_receive_buffer_autotune),
+      socket_receive_buffer_max_(config.socket_receive_buffer_max),
+      arrival_timestamps_(config.arrival_timestamps),
+      datagram_records_(config.arrival_timestamps || config.datagram_records),
+      demux_(parseDemux(config.demux)),
+      board_id_offset_(config.board_id_offset),
+      board_id_width_(config.board_id_width),
+      max_streams_(config.max_streams),
+      stream_buffer_size_(config.buffer_size) {
+    if (demux_ != Demux::None) {
+        if (config.use_datagram_pool) {
+            throw std::invalid_argument("UDP demultiplexing requires the byte ring; disable "
+                                        "use_datagram_pool");
+        }
+        if (demux_ == Demux::BoardId &&
+            ((board_id_width_ != 1 && board_id_width_ != 2 && board_id_width_ != 4) ||
+             board_id_offset_ + board_id_width_ > kTransportHeaderSize)) {
+            throw std::invalid_argument(
+                "Invalid board ID field: width must be 1, 2, or 4 and lie inside the 16-byte "
+                "transport header");
+        }
+        if (max_streams_ == 0) {
+            throw std::invalid_argument("UDP demultiplexing requires max_streams > 0");
+        }
+    }
+
+    af_packet_options_.interface_name = config.interface_name;
+    af_packet_options_.address = config.address;
+    af_packet_options_.block_size = config.af_packet_block_size;
+    af_packet_options_.block_count = config.af_packet_block_count;
+    af_packet_options_.block_timeout_ms = config.af_packet_block_timeout_ms;
+    io_uring_buffer_count_ = config.io_uring_buffer_count;
+
+    const std::vector<uint16_t> ports =
+        config.ports.empty() ? std::vector<uint16_t>{config.port} : config.ports;
+    const size_t sockets_per_port = std::max<size_t>(config.socket_count, 1);
+    for (uint16_t port : ports) {
+        for (size_t i = 0; i < sockets_per_port; ++i) {
+            shards_.push_back(std::make_unique<Shard>(port, config.buffer_size));
+            shards_.back()->data_buffer.setOverflowPolicy(overflow_policy_,
+                                                         overflow_block_timeout_);
+        }
+    }
+
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        shards_[i]->index = i;
+    }
+
+    if (config.sequence_width > 0) {
+        for (auto& shard : shards_) {
+            shard->sequence_tracker =
+                std::make_unique<SequenceTracker>(config.sequence_offset, config.sequence_width);
+        }
+    }
+
+    if (datagram_records_) {
+        for (auto& shard : shards_) {
+            shard->data_buffer.enableArrivalTracking();
+        }
+    }
+
+    if (demux_ != Demux::None) {
+        for (auto& shard : shards_) {
+            shard->streams = std::make_unique<std::unique_ptr<Stream>[]>(max_streams_);
+        }
+    }
+
+    if (config.use_datagram_pool) {
+        enableDatagramPool(config.datagram_pool_slots);
+    }
+
+    if (config.recorder.enabled) {
+        recorder_ = std::make_unique<DatagramRecorder>(config.recorder, shards_.size());
+    }
+}
 
 UdpReceiver::~UdpReceiver() { stop(); }
 
-void UdpReceiver::initSocket() {
-    socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
-    if (socket_fd_ < 0) {
+UdpReceiver::Backend UdpReceiver::parseBackend(const std::string& backend) {
+    if (backend == "socket") {
+        return Backend::Socket;
+    }
+    if (backend == "af_packet") {
+        return Backend::AfPacket;
+    }
+    if (backend == "io_uring") {
+        return Backend::IoUring;
+    }
+    throw std::invalid_argument("Invalid UDP receiver backend: " + backend);
+}
+
+UdpDataBuffer::OverflowPolicy UdpReceiver::parseOverflowPolicy(const std::string& policy) {
+    if (policy == "drop_newest") {
+        return UdpDataBuffer::OverflowPolicy::DropNewest;
+    }
+    if (policy == "drop_oldest") {
+        return UdpDataBuffer::OverflowPolicy::DropOldest;
+    }
+    if (policy == "block") {
+        return UdpDataBuffer::OverflowPolicy::Block;
+    }
+    throw std::invalid_argument("Invalid UDP overflow policy: " + policy);
+}
+
+UdpReceiver::Demux UdpReceiver::parseDemux(const std::string& demux) {
+    if (demux == "none") {
+        return Demux::None;
+    }
+    if (demux == "source") {
+        return Demux::Source;
+    }
+    if (demux == "board_id") {
+        return Demux::BoardId;
+    }
+    throw std::invalid_argument("Invalid UDP demux mode: " + demux);
+}
+
+void UdpReceiver::initSocket(Shard& shard) {
+    shard.socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (shard.socket_fd < 0) {
         throw std::runtime_error("Failed to create socket");
     }
 
+    if (reuse_port_) {
+        const int enable = 1;
+        if (setsockopt(shard.socket_fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+            throw std::runtime_error("Failed to enable SO_REUSEPORT");
+        }
+    }
+
+    // Size the receive queue before binding so no datagram sees the default.
+    shard.socket_drop_counter = 0;
+    shard.receive_buffer_capped = false;
+    if (socket_receive_buffer_ > 0) {
+        setReceiveBuffer(shard, socket_receive_buffer_);
+    } else {
+        int current = 0;
+        socklen_t length = sizeof(current);
+        getsockopt(shard.socket_fd, SOL_SOCKET, SO_RCVBUF, &current, &length);
+        // The kernel reports twice the requested size to account for bookkeeping.
+        shard.requested_receive_buffer = static_cast<size_t>(current) / 2;
+        shard.socket_receive_buffer.store(static_cast<size_t>(current), std::memory_order_relaxed);
+    }
+
+    const int enable_drop_counter = 1;
+    if (setsockopt(shard.socket_fd,
+                   SOL_SOCKET,
+                   SO_RXQ_OVFL,
+                   &enable_drop_counter,
+                   sizeof(enable_drop_counter)) < 0) {
+        spdlog::warn("Failed to enable SO_RXQ_OVFL on port {}; kernel drops are not counted",
+                     shard.port);
+    }
+
+    if (arrival_timestamps_) {
+        const int enable_timestamps = 1;
+        if (setsockopt(shard.socket_fd,
+                       SOL_SOCKET,
+                       SO_TIMESTAMPNS,
+                       &enable_timestamps,
+                       sizeof(enable_timestamps)) < 0) {
+            spdlog::warn("Failed to enable SO_TIMESTAMPNS on port {}; arrival times are unknown",
+                         shard.port);
+        }
+    }
+
     sockaddr_in server_addr{};
     server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port_);
+    server_addr.sin_port = htons(shard.port);
     inet_pton(AF_INET, address_.c_str(), &server_addr.sin_addr);
 
-    if (bind(socket_fd_, reinterpret_cast<sockaddr*>(&server_addr), sizeof(server_addr)) < 0) {
-        throw std::runtime_error("Failed to bind socket");
+    if (bind(shard.socket_fd, reinterpret_cast<sockaddr*>(&server_addr), sizeof(server_addr)) <
+        0) {
+        throw std::runtime_error("Failed to bind socket to port " + std::to_string(shard.port));
     }
 
     if (timeout_sec_ > 0) {
         timeval timeout{};
         timeout.tv_sec = timeout_sec_;
         timeout.tv_usec = 0;
-        setsockopt(socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(shard.socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+}
+
+void UdpReceiver::setReceiveBuffer(Shard& shard, size_t bytes) {
+    const int requested = static_cast<int>(std::min<size_t>(bytes, INT_MAX / 2));
+    bool applied = false;
+    if (socket_receive_buffer_force_) {
+        applied = setsockopt(shard.socket_fd,
+                             SOL_SOCKET,
+                             SO_RCVBUFFORCE,
+                             &requested,
+                             sizeof(requested)) == 0;
+        if (!applied) {
+            spdlog::warn("SO_RCVBUFFORCE rejected on port {} ({}); falling back to SO_RCVBUF",
+                         shard.port,
+                         std::strerror(errno));
+        }
+    }
+    if (!applied &&
+        setsockopt(shard.socket_fd, SOL_SOCKET, SO_RCVBUF, &requested, sizeof(requested)) < 0) {
+        spdlog::warn("Failed to set SO_RCVBUF on port {}: {}", shard.port, std::strerror(errno));
+    }
+
+    int effective = 0;
+    socklen_t length = sizeof(effective);
+    getsockopt(shard.socket_fd, SOL_SOCKET, SO_RCVBUF, &effective, &length);
+    shard.requested_receive_buffer = static_cast<size_t>(requested);
+    shard.socket_receive_buffer.store(static_cast<size_t>(effective), std::memory_order_relaxed);
+
+    // The kernel doubles the request; anything less means net.core.rmem_max capped it.
+    if (static_cast<size_t>(effective) < static_cast<size_t>(requested) * 2) {
+        shard.receive_buffer_capped = true;
+        spdlog::warn(
+            "Socket receive buffer on port {} capped at {} bytes (requested {}); raise "
+            "net.core.rmem_max or enable socket_receive_buffer_force",
+            shard.port,
+            effective / 2,
+            requested);
+    }
+}
+
+void UdpReceiver::noteSocketDrops(Shard& shard, uint32_t counter) {
+    // The counter is cumulative per socket and wraps at 32 bits.
+    const uint32_t dropped = counter - shard.socket_drop_counter;
+    if (dropped == 0) {
+        return;
+    }
+    shard.socket_drop_counter = counter;
+    shard.socket_drops.fetch_add(dropped, std::memory_order_relaxed);
+
+    if (!socket_receive_buffer_autotune_ || shard.receive_buffer_capped ||
+        shard.requested_receive_buffer >= socket_receive_buffer_max_) {
+        return;
     }
+    const size_t grown =
+        std::min(std::max<size_t>(shard.requested_receive_buffer * 2, 1), socket_receive_buffer_max_);
+    spdlog::info("Kernel dropped {} datagrams on port {}; growing the socket receive buffer to {} "
+                 "bytes",
+                 dropped,
+                 shard.port,
+                 grown);
+    setReceiveBuffer(shard, grown);
 }
 
 void UdpReceiver::start() {
@@ -66,8 +343,27 @@ void UdpReceiver::start() {
     }
 
     running_ = true;
-    initSocket();
-    receiver_thread_ = std::thread(&UdpReceiver::receiveLoop, this);
+    if (recorder_) {
+        recorder_->start();
+    }
+    for (auto& shard : shards_) {
+        initSocket(*shard);
+        if (backend_ == Backend::AfPacket) {
+            initAfPacketRing(*shard);
+        } else if (backend_ == Backend::IoUring) {
+            initIoUringRing(*shard);
+        }
+    }
+    for (auto& shard : shards_) {
+        Shard& target = *shard;
+        if (target.af_packet_ring) {
+            target.thread = std::thread([this, &target] { receiveLoopAfPacket(target); });
+        } else if (target.io_uring_ring) {
+            target.thread = std::thread([this, &target] { receiveLoopIoUring(target); });
+        } else {
+            target.thread = std::thread([this, &target] { runSocketLoop(target); });
+        }
+    }
 }
 
 void UdpReceiver::stop() {
@@ -76,62 +372,766 @@ void UdpReceiver::stop() {
     }
 
     running_ = false;
+    notifyData();
 
-    if (socket_fd_ >= 0) {
-        close(socket_fd_);
-        socket_fd_ = -1;
+    // Shutting the sockets down wakes any thread blocked in recvmmsg before
+    // the descriptors are closed underneath it.
+    for (auto& shard : shards_) {
+        if (shard->socket_fd >= 0) {
+            shutdown(shard->socket_fd, SHUT_RDWR);
+        }
     }
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+        if (shard->socket_fd >= 0) {
+            close(shard->socket_fd);
+            shard->socket_fd = -1;
+        }
+        if (shard->af_packet_ring) {
+            shard->af_packet_ring->close();
+        }
+        if (shard->io_uring_ring) {
+            shard->io_uring_ring->close();
+        }
+    }
+    if (recorder_) {
+        // Stopped after the receive threads so everything they staged is written.
+        recorder_->stop();
+    }
+}
+
+void UdpReceiver::initAfPacketRing(Shard& shard) {
+    // The regular socket bound in initSocket() only keeps the kernel from
+    // answering with ICMP port-unreachable; shrink it so it costs nothing.
+    const int minimal_buffer = 0;
+    setsockopt(shard.socket_fd, SOL_SOCKET, SO_RCVBUF, &minimal_buffer, sizeof(minimal_buffer));
+    shard.socket_receive_buffer.store(0, std::memory_order_relaxed);
+
+    AfPacketRing::Options options = af_packet_options_;
+    options.port = shard.port;
+    options.fanout_group = reuse_port_ ? shard.port : -1;
+    shard.af_packet_ring = std::make_unique<AfPacketRing>(options);
+    shard.af_packet_ring->open();
+}
 
-    if (receiver_thread_.joinable()) {
-        receiver_thread_.join();
+void UdpReceiver::initIoUringRing(Shard& shard) {
+    IoUringRecvRing::Options options;
+    options.buffer_count = io_uring_buffer_count_;
+    options.max_datagram_size = max_packet_size_;
+    options.receive_drop_counter = true;
+    options.receive_timestamps = arrival_timestamps_;
+    shard.io_uring_ring = std::make_unique<IoUringRecvRing>(options);
+    try {
+        shard.io_uring_ring->open(shard.socket_fd);
+    } catch (const std::system_error& error) {
+        spdlog::warn("io_uring receive unavailable on port {} ({}); using the socket backend",
+                     shard.port,
+                     error.what());
+        shard.io_uring_ring.reset();
+    }
+}
+
+void UdpReceiver::runSocketLoop(Shard& shard) {
+    if (shard.datagram_pool) {
+        receiveLoopPooled(shard);
+    } else if (recv_batch_size_ > 1) {
+        receiveLoopBatched(shard);
+    } else {
+        receiveLoop(shard);
     }
 }
 
-void UdpReceiver::receiveLoop() {
+void UdpReceiver::receiveLoop(Shard& shard) {
     try {
         auto udp_packet_buffer = std::make_unique<uint8_t[]>(max_packet_size_);
+        ReceiveControl control;
 
         while (running_) {
             sockaddr_in client_addr{};
-            socklen_t client_addr_len = sizeof(client_addr);
-            const ssize_t received_bytes =
-                recvfrom(socket_fd_,
-                         udp_packet_buffer.get(),
-                         max_packet_size_,
-                         0,
-                         reinterpret_cast<sockaddr*>(&client_addr),
-                         &client_addr_len);
+            iovec iov{udp_packet_buffer.get(), max_packet_size_};
+            msghdr message{};
+            message.msg_name = &client_addr;
+            message.msg_namelen = sizeof(client_addr);
+            message.msg_iov = &iov;
+            message.msg_iovlen = 1;
+            message.msg_control = &control;
+            message.msg_controllen = sizeof(control);
+            const ssize_t received_bytes = recvmsg(shard.socket_fd, &message, 0);
 
+            if (!running_) {
+                break;
+            }
             if (received_bytes < 0) {
-                if (!running_) {
-                    break;
+                continue;
+            }
+            uint32_t drop_counter = 0;
+            uint64_t arrival_ns = 0;
+            if (read_control(message, drop_counter, arrival_ns)) {
+                noteSocketDrops(shard, drop_counter);
+            }
+
+            const DatagramView datagram{udp_packet_buffer.get(),
+                                        static_cast<size_t>(received_bytes),
+                                        ntohl(client_addr.sin_addr.s_addr),
+                                        ntohs(client_addr.sin_port),
+                                        arrival_ns};
+            deliverBatch(shard, &datagram, 1);
+        }
+    } catch (const std::exception& error) {
+        spdlog::error("Receiver thread error: {}", error.what());
+    }
+}
+
+void UdpReceiver::receiveLoopBatched(Shard& shard) {
+    try {
+        const size_t batch_size = recv_batch_size_;
+        std::vector<uint8_t> datagram_storage(batch_size * max_packet_size_);
+        std::vector<iovec> iovecs(batch_size);
+        std::vector<mmsghdr> messages(batch_size);
+        std::vector<sockaddr_in> sources(batch_size);
+        std::vector<ReceiveControl> controls(batch_size);
+        std::vector<DatagramView> datagrams(batch_size);
+
+        for (size_t k = 0; k < batch_size; ++k) {
+            iovecs[k].iov_base = datagram_storage.data() + k * max_packet_size_;
+            iovecs[k].iov_len = max_packet_size_;
+        }
+
+        while (running_) {
+            for (size_t k = 0; k < batch_size; ++k) {
+                std::memset(&messages[k], 0, sizeof(mmsghdr));
+                messages[k].msg_hdr.msg_iov = &iovecs[k];
+                messages[k].msg_hdr.msg_iovlen = 1;
+                messages[k].msg_hdr.msg_name = &sources[k];
+                messages[k].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                messages[k].msg_hdr.msg_control = &controls[k];
+                messages[k].msg_hdr.msg_controllen = sizeof(ReceiveControl);
+            }
+
+            // MSG_WAITFORONE blocks (up to SO_RCVTIMEO) for the first datagram only
+            // and then drains whatever else is already queued on the socket.
+            const int received = recvmmsg(shard.socket_fd,
+                                          messages.data(),
+                                          static_cast<unsigned int>(batch_size),
+                                          MSG_WAITFORONE,
+                                          nullptr);
+            if (!running_) {
+                break;
+            }
+            if (received <= 0) {
+                continue;
+            }
+
+            // Later datagrams carry the more recent drop counter.
+            uint32_t drop_counter = 0;
+            bool has_drop_counter = false;
+            for (int k = 0; k < received; ++k) {
+                uint64_t arrival_ns = 0;
+                has_drop_counter |= read_control(messages[k].msg_hdr, drop_counter, arrival_ns);
+                datagrams[k] = {static_cast<const uint8_t*>(iovecs[k].iov_base),
+                                messages[k].msg_len,
+                                ntohl(sources[k].sin_addr.s_addr),
+                                ntohs(sources[k].sin_port),
+                                arrival_ns};
+            }
+            if (has_drop_counter) {
+                noteSocketDrops(shard, drop_counter);
+            }
+            deliverBatch(shard, datagrams.data(), static_cast<size_t>(received));
+        }
+    } catch (const std::exception& error) {
+        spdlog::error("Receiver thread error: {}", error.what());
+    }
+}
+
+void UdpReceiver::receiveLoopPooled(Shard& shard) {
+    DatagramPool& pool = *shard.datagram_pool;
+    const size_t batch_size = recv_batch_size_;
+    std::vector<uint32_t> held_slots;
+    std::vector<iovec> iovecs(batch_size);
+    std::vector<mmsghdr> messages(batch_size);
+    std::vector<sockaddr_in> sources(batch_size);
+    std::vector<ReceiveControl> controls(batch_size);
+    std::vector<DatagramRef> ready;
+    std::vector<uint32_t> slots(batch_size);
+    std::vector<uint8_t> scratch;
+    held_slots.reserve(batch_size);
+    ready.reserve(batch_size);
+
+    try {
+        while (running_) {
+            // Top up the slots recvmmsg may write into. Slots that received
+            // nothing or a malformed datagram stay held for the next call.
+            if (held_slots.size() < batch_size) {
+                const size_t acquired =
+                    pool.acquire(slots.data(), batch_size - held_slots.size());
+                held_slots.insert(held_slots.end(), slots.begin(), slots.begin() + acquired);
+            }
+            if (held_slots.empty()) {
+                const size_t acquired = acquireSlots(shard, slots.data(), batch_size);
+                held_slots.insert(held_slots.end(), slots.begin(), slots.begin() + acquired);
+            }
+            if (held_slots.empty()) {
+                // No slot could be freed under the policy: receive the next
+                // batch into scratch storage and drop it as the newest data.
+                if (scratch.empty()) {
+                    scratch.resize(batch_size * max_packet_size_);
+                }
+                for (size_t k = 0; k < batch_size; ++k) {
+                    iovecs[k].iov_base = scratch.data() + k * max_packet_size_;
+                    iovecs[k].iov_len = max_packet_size_;
+                    std::memset(&messages[k], 0, sizeof(mmsghdr));
+                    messages[k].msg_hdr.msg_iov = &iovecs[k];
+                    messages[k].msg_hdr.msg_iovlen = 1;
+                    messages[k].msg_hdr.msg_control = &controls[k];
+                    messages[k].msg_hdr.msg_controllen = sizeof(ReceiveControl);
+                }
+                const int discarded = recvmmsg(shard.socket_fd,
+                                               messages.data(),
+                                               static_cast<unsigned int>(batch_size),
+                                               MSG_WAITFORONE,
+                                               nullptr);
+                if (discarded > 0) {
+                    uint32_t drop_counter = 0;
+                    bool has_drop_counter = false;
+                    uint64_t discarded_bytes = 0;
+                    for (int k = 0; k < discarded; ++k) {
+                        uint64_t arrival_ns = 0;
+                        has_drop_counter |=
+                            read_control(messages[k].msg_hdr, drop_counter, arrival_ns);
+                        discarded_bytes +=
+                            std::max<size_t>(messages[k].msg_len, kTransportHeaderSize) -
+                            kTransportHeaderSize;
+                    }
+                    noteDropped(shard, static_cast<uint64_t>(discarded), discarded_bytes);
+                    if (has_drop_counter) {
+                        noteSocketDrops(shard, drop_counter);
+                    }
                 }
                 continue;
             }
 
-            if (received_bytes < 16) {
-                spdlog::warn("Malformed UDP packet: too small ({} bytes)", received_bytes);
+            const size_t slot_batch = held_slots.size();
+            for (size_t k = 0; k < slot_batch; ++k) {
+                iovecs[k].iov_base = pool.slot_data(held_slots[k]);
+                iovecs[k].iov_len = max_packet_size_;
+                std::memset(&messages[k], 0, sizeof(mmsghdr));
+                messages[k].msg_hdr.msg_iov = &iovecs[k];
+                messages[k].msg_hdr.msg_iovlen = 1;
+                messages[k].msg_hdr.msg_name = &sources[k];
+                messages[k].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                messages[k].msg_hdr.msg_control = &controls[k];
+                messages[k].msg_hdr.msg_controllen = sizeof(ReceiveControl);
+            }
+
+            const int received = recvmmsg(shard.socket_fd,
+                                          messages.data(),
+                                          static_cast<unsigned int>(slot_batch),
+                                          MSG_WAITFORONE,
+                                          nullptr);
+            if (!running_) {
+                break;
+            }
+            if (received <= 0) {
                 continue;
             }
 
-            uint16_t payload_size = 0;
-            std::memcpy(&payload_size, udp_packet_buffer.get(), sizeof(uint16_t));
-            payload_size = ntohs(payload_size);
+            ready.clear();
+            shard.accepted.clear();
+            size_t kept = 0;
+            uint64_t batch_bytes = 0;
+            uint32_t drop_counter = 0;
+            bool has_drop_counter = false;
+            for (size_t k = 0; k < slot_batch; ++k) {
+                uint16_t payload_size = 0;
+                uint64_t arrival_ns = 0;
+                const bool filled = k < static_cast<size_t>(received);
+                if (filled) {
+                    has_drop_counter |= read_control(messages[k].msg_hdr, drop_counter, arrival_ns);
+                    if (recorder_) {
+                        shard.recorded.push_back({pool.slot_data(held_slots[k]),
+                                                  messages[k].msg_len,
+                                                  ntohl(sources[k].sin_addr.s_addr),
+                                                  ntohs(sources[k].sin_port),
+                                                  arrival_ns});
+                    }
+                }
+                if (filled && validate_transport_header(pool.slot_data(held_slots[k]),
+                                                messages[k].msg_len,
+                                                payload_size)) {
+                    ready.push_back({held_slots[k],
+                                     static_cast<uint32_t>(kTransportHeaderSize),
+                                     payload_size,
+                                     arrival_ns});
+                    shard.accepted.push_back({pool.slot_data(held_slots[k]),
+                                              messages[k].msg_len,
+                                              ntohl(sources[k].sin_addr.s_addr),
+                                              ntohs(sources[k].sin_port),
+                                              arrival_ns});
+                    batch_bytes += payload_size;
+                } else {
+                    if (filled) {
+                        shard.malformed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    held_slots[kept++] = held_slots[k];
+                }
+            }
+            held_slots.resize(kept);
+            if (recorder_) {
+                recorder_->record(shard.index, shard.recorded.data(), shard.recorded.size());
+                shard.recorded.clear();
+            }
+            if (has_drop_counter) {
+                noteSocketDrops(shard, drop_counter);
+            }
+            if (shard.sequence_tracker) {
+                // Inspect the headers before publishing hands the slots to the collector.
+                shard.sequence_tracker->observe(shard.accepted.data(), shard.accepted.size());
+            }
+            pool.publish(ready.data(), ready.size());
+            notifyData();
+            shard.datagrams.fetch_add(ready.size(), std::memory_order_relaxed);
+            shard.bytes.fetch_add(batch_bytes, std::memory_order_relaxed);
+        }
+    } catch (const std::exception& error) {
+        spdlog::error("Receiver thread error: {}", error.what());
+    }
 
-            if (payload_size != static_cast<uint16_t>(received_bytes - 16)) {
-                spdlog::warn("Malformed UDP packet: expected payload size {}, received {}",
-                             payload_size,
-                             received_bytes - 16);
+    pool.recycle(held_slots.data(), held_slots.size());
+}
+
+void UdpReceiver::receiveLoopAfPacket(Shard& shard) {
+    constexpr int kPollTimeoutMs = 100;
+    AfPacketRing& ring = *shard.af_packet_ring;
+    std::vector<DatagramView> datagrams;
+
+    try {
+        while (running_) {
+            datagrams.clear();
+            if (!ring.next_block(datagrams, kPollTimeoutMs)) {
+                shard.ring_drops.store(ring.kernel_drops(), std::memory_order_relaxed);
                 continue;
             }
+            // The views point into the mapped block, so deliver before releasing it.
+            deliverBatch(shard, datagrams.data(), datagrams.size());
+            ring.release_block();
+            shard.ring_drops.store(ring.kernel_drops(), std::memory_order_relaxed);
+        }
+    } catch (const std::exception& error) {
+        spdlog::error("Receiver thread error: {}", error.what());
+    }
+}
 
-            data_buffer_.append(udp_packet_buffer.get() + 16, payload_size);
+void UdpReceiver::receiveLoopIoUring(Shard& shard) {
+    constexpr int kWaitTimeoutMs = 100;
+    IoUringRecvRing& ring = *shard.io_uring_ring;
+    std::vector<DatagramView> datagrams;
+    datagrams.reserve(recv_batch_size_);
+
+    try {
+        while (running_) {
+            datagrams.clear();
+            const bool received = ring.next_batch(datagrams, kWaitTimeoutMs);
+            if (!running_) {
+                break;
+            }
+            if (received) {
+                noteSocketDrops(shard, ring.socket_drop_counter());
+                // The views point into provided buffers, so deliver before returning them.
+                deliverBatch(shard, datagrams.data(), datagrams.size());
+            }
+            ring.release_batch();
         }
+    } catch (const std::system_error& error) {
+        spdlog::warn("io_uring receive failed on port {} ({}); using the socket backend",
+                     shard.port,
+                     error.what());
+        ring.close();
+        runSocketLoop(shard);
     } catch (const std::exception& error) {
         spdlog::error("Receiver thread error: {}", error.what());
     }
 }
 
-UdpDataBuffer& UdpReceiver::getDataBuffer() { return data_buffer_; }
+void UdpReceiver::deliverBatch(Shard& shard, const DatagramView* datagrams, size_t count) {
+    if (recorder_) {
+        recorder_->record(shard.index, datagrams, count);
+    }
+    shard.segments.clear();
+    shard.accepted.clear();
+    uint64_t batch_bytes = 0;
+    for (size_t k = 0; k < count; ++k) {
+        uint16_t payload_size = 0;
+        if (!validate_transport_header(datagrams[k].data, datagrams[k].size, payload_size)) {
+            shard.malformed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        shard.segments.push_back(
+            {datagrams[k].data + kTransportHeaderSize, payload_size, datagrams[k].arrival_ns});
+        shard.accepted.push_back(datagrams[k]);
+        batch_bytes += payload_size;
+    }
+    if (shard.segments.empty()) {
+        return;
+    }
+    if (shard.sequence_tracker) {
+        shard.sequence_tracker->observe(shard.accepted.data(), shard.accepted.size());
+    }
+
+    if (demux_ != Demux::None) {
+        deliverStreams(shard, batch_bytes);
+    } else if (shard.datagram_pool) {
+        // Backends that own their receive storage copy payloads into pool slots.
+        DatagramPool& pool = *shard.datagram_pool;
+        const size_t needed = shard.segments.size();
+        shard.slots.resize(needed);
+        size_t acquired = 0;
+        while (acquired < needed) {
+            const size_t chunk =
+                acquireSlots(shard, shard.slots.data() + acquired, needed - acquired);
+            if (chunk == 0) {
+                break;
+            }
+
+            shard.refs.clear();
+            for (size_t k = acquired; k < acquired + chunk; ++k) {
+                const auto& segment = shard.segments[k];
+                std::memcpy(pool.slot_data(shard.slots[k]), segment.data, segment.size);
+                shard.refs.push_back(
+                    {shard.slots[k], 0, static_cast<uint32_t>(segment.size), segment.arrival_ns});
+            }
+            pool.publish(shard.refs.data(), shard.refs.size());
+            acquired += chunk;
+
+            // Only the blocking policy keeps waiting for the rest of the batch.
+            if (overflow_policy_ != UdpDataBuffer::OverflowPolicy::Block) {
+                break;
+            }
+        }
+        if (acquired < needed) {
+            // The newest datagrams found no slot under the overflow policy.
+            uint64_t dropped_bytes = 0;
+            for (size_t k = acquired; k < needed; ++k) {
+                dropped_bytes += shard.segments[k].size;
+            }
+            noteDropped(shard, needed - acquired, dropped_bytes);
+            shard.segments.resize(acquired);
+            batch_bytes -= dropped_bytes;
+        }
+    } else {
+        // Overflow is handled (and counted) inside the buffer by its policy.
+        shard.data_buffer.appendBatch(shard.segments.data(), shard.segments.size());
+    }
+
+    shard.datagrams.fetch_add(shard.segments.size(), std::memory_order_relaxed);
+    shard.bytes.fetch_add(batch_bytes, std::memory_order_relaxed);
+    notifyData();
+}
+
+void UdpReceiver::deliverStreams(Shard& shard, uint64_t& batch_bytes) {
+    // Group the batch by stream first so each stream buffer publishes once.
+    shard.touched_streams.clear();
+    uint64_t unrouted = 0;
+    uint64_t unrouted_bytes = 0;
+    for (size_t k = 0; k < shard.segments.size(); ++k) {
+        Stream* stream = findStream(shard, shard.accepted[k]);
+        if (stream == nullptr) {
+            ++unrouted;
+            unrouted_bytes += shard.segments[k].size;
+            continue;
+        }
+        if (stream->segments.empty()) {
+            shard.touched_streams.push_back(stream);
+            stream->batch_bytes = 0;
+        }
+        stream->segments.push_back(shard.segments[k]);
+        stream->batch_bytes += shard.segments[k].size;
+    }
+
+    for (Stream* stream : shard.touched_streams) {
+        // Overflow is handled (and counted) inside each stream buffer by its policy.
+        stream->data_buffer.appendBatch(stream->segments.data(), stream->segments.size());
+        stream->datagrams.fetch_add(stream->segments.size(), std::memory_order_relaxed);
+        stream->bytes.fetch_add(stream->batch_bytes, std::memory_order_relaxed);
+        stream->segments.clear();
+    }
+
+    noteDropped(shard, unrouted, unrouted_bytes);
+    shard.segments.resize(shard.segments.size() - unrouted);
+    batch_bytes -= unrouted_bytes;
+}
+
+UdpReceiver::Stream* UdpReceiver::findStream(Shard& shard, const DatagramView& datagram) {
+    const uint64_t key =
+        demux_ == Demux::Source
+            ? (static_cast<uint64_t>(datagram.source_address) << 16) | datagram.source_port
+            : read_board_id(datagram.data, board_id_offset_, board_id_width_);
+
+    const auto found = shard.stream_index.find(key);
+    if (found != shard.stream_index.end()) {
+        return found->second;
+    }
+
+    const size_t count = shard.stream_count.load(std::memory_order_relaxed);
+    if (count >= max_streams_) {
+        if (!shard.stream_limit_logged) {
+            spdlog::warn("Port {} reached max_streams ({}); dropping datagrams from new senders",
+                         shard.port,
+                         max_streams_);
+            shard.stream_limit_logged = true;
+        }
+        return nullptr;
+    }
+
+    const std::string label = demux_ == Demux::Source
+                                  ? format_source(datagram.source_address, datagram.source_port)
+                                  : "board " + std::to_string(key);
+
+    auto stream = std::make_unique<Stream>(key, label, stream_buffer_size_);
+    stream->data_buffer.setOverflowPolicy(overflow_policy_, overflow_block_timeout_);
+    if (datagram_records_) {
+        stream->data_buffer.enableArrivalTracking();
+    }
+    Stream* created = stream.get();
+    shard.streams[count] = std::move(stream);
+    shard.stream_index.emplace(key, created);
+    // Publishes the fully constructed stream to readers of stream_count.
+    shard.stream_count.store(count + 1, std::memory_order_release);
+    spdlog::info("Port {}: new stream {}", shard.port, label);
+    return created;
+}
+
+size_t UdpReceiver::acquireSlots(Shard& shard, uint32_t* slots, size_t needed) {
+    DatagramPool& pool = *shard.datagram_pool;
+    size_t acquired = pool.acquire(slots, needed);
+    if (acquired == needed) {
+        return acquired;
+    }
+    pool.note_exhausted();
+
+    if (overflow_policy_ == UdpDataBuffer::OverflowPolicy::DropOldest) {
+        // Take the oldest datagrams the collector has not drained yet and reuse their slots.
+        shard.reclaimed.resize(needed - acquired);
+        const size_t reclaimed = pool.reclaim_oldest(shard.reclaimed.data(), needed - acquired);
+        uint64_t reclaimed_bytes = 0;
+        for (size_t k = 0; k < reclaimed; ++k) {
+            slots[acquired++] = shard.reclaimed[k].slot;
+            reclaimed_bytes += shard.reclaimed[k].payload_size;
+        }
+        noteDropped(shard, reclaimed, reclaimed_bytes);
+    } else if (overflow_policy_ == UdpDataBuffer::OverflowPolicy::Block) {
+        // Wait for at least one slot; callers come back for the rest.
+        const auto deadline = std::chrono::steady_clock::now() + overflow_block_timeout_;
+        while (acquired == 0 && running_ && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            acquired += pool.acquire(slots + acquired, needed - acquired);
+        }
+    }
+    return acquired;
+}
+
+void UdpReceiver::noteDropped(Shard& shard, uint64_t datagrams, uint64_t bytes) {
+    if (datagrams == 0) {
+        return;
+    }
+    shard.dropped_datagrams.fetch_add(datagrams, std::memory_order_relaxed);
+    shard.dropped_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+size_t UdpReceiver::getBufferedBytes() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard->datagram_pool ? shard->datagram_pool->pending_bytes()
+                                      : shard->data_buffer.size();
+        const size_t stream_count = shard->stream_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < stream_count; ++i) {
+            total += shard->streams[i]->data_buffer.size();
+        }
+    }
+    return total;
+}
+
+bool UdpReceiver::waitForData(size_t min_bytes, std::chrono::microseconds max_wait) {
+    min_bytes = std::max<size_t>(min_bytes, 1);
+    data_threshold_.store(min_bytes);
+    data_waiters_.fetch_add(1);
+    bool reached = false;
+    {
+        std::unique_lock<std::mutex> lock(data_mutex_);
+        reached = data_cv_.wait_for(lock, max_wait, [this, min_bytes] {
+            return !running_ || getBufferedBytes() >= min_bytes;
+        });
+    }
+    data_waiters_.fetch_sub(1);
+    return reached && running_;
+}
+
+void UdpReceiver::notifyData() {
+    // Pairs with the waiter registering before it checks the buffers, so a
+    // publish racing with a new waiter is either seen or notified.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (data_waiters_.load() == 0) {
+        return;
+    }
+    if (running_ && getBufferedBytes() < data_threshold_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    data_cv_.notify_all();
+}
+
+bool UdpReceiver::isArrivalTimestampingEnabled() const { return arrival_timestamps_; }
+
+UdpDataBuffer& UdpReceiver::getDataBuffer() { return shards_.front()->data_buffer; }
+
+UdpDataBuffer& UdpReceiver::getDataBuffer(size_t shard) { return shards_.at(shard)->data_buffer; }
+
+void UdpReceiver::enableDatagramPool(size_t slot_count) {
+    if (running_) {
+        throw std::logic_error("Cannot enable the datagram pool while the receiver is running");
+    }
+    if (demux_ != Demux::None) {
+        throw std::logic_error("The datagram pool cannot be combined with UDP demultiplexing");
+    }
+    for (auto& shard : shards_) {
+        const size_t shard_slots =
+            slot_count != 0
+                ? slot_count
+                : std::max<size_t>(shard->data_buffer.capacity() / max_packet_size_,
+                                   recv_batch_size_);
+        shard->datagram_pool = std::make_unique<DatagramPool>(shard_slots, max_packet_size_);
+    }
+}
+
+DatagramPool* UdpReceiver::getDatagramPool(size_t shard) {
+    return shards_.at(shard)->datagram_pool.get();
+}
+
+DatagramPoolStats UdpReceiver::getDatagramPoolStats() const {
+    DatagramPoolStats total;
+    for (const auto& shard : shards_) {
+        if (!shard->datagram_pool) {
+            continue;
+        }
+        const DatagramPoolStats stats = shard->datagram_pool->stats();
+        total.slot_count += stats.slot_count;
+        total.slot_size = stats.slot_size;
+        total.slots_in_use += stats.slots_in_use;
+        total.peak_slots_in_use += stats.peak_slots_in_use;
+        total.published += stats.published;
+        total.recycled += stats.recycled;
+        total.exhausted += stats.exhausted;
+    }
+    return total;
+}
+
+std::vector<UdpShardStats> UdpReceiver::getShardStats() const {
+    std::vector<UdpShardStats> result;
+    result.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        UdpShardStats stats;
+        stats.port = shard->port;
+        stats.datagrams = shard->datagrams.load(std::memory_order_relaxed);
+        stats.bytes = shard->bytes.load(std::memory_order_relaxed);
+        stats.malformed_datagrams = shard->malformed.load(std::memory_order_relaxed);
+        stats.ring_drops = shard->ring_drops.load(std::memory_order_relaxed);
+        stats.socket_drops = shard->socket_drops.load(std::memory_order_relaxed);
+        stats.socket_receive_buffer = shard->socket_receive_buffer.load(std::memory_order_relaxed);
+        const UdpDataBuffer::OverflowStats overflow = shard->data_buffer.getOverflowStats();
+        stats.dropped_datagrams =
+            shard->dropped_datagrams.load(std::memory_order_relaxed) + overflow.dropped_datagrams;
+        stats.dropped_bytes =
+            shard->dropped_bytes.load(std::memory_order_relaxed) + overflow.dropped_bytes;
+        const size_t stream_count = shard->stream_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < stream_count; ++i) {
+            const UdpDataBuffer::OverflowStats stream_overflow =
+                shard->streams[i]->data_buffer.getOverflowStats();
+            stats.dropped_datagrams += stream_overflow.dropped_datagrams;
+            stats.dropped_bytes += stream_overflow.dropped_bytes;
+        }
+        result.push_back(stats);
+    }
+    return result;
+}
+
+size_t UdpReceiver::getStreamCount(size_t shard) const {
+    return shards_.at(shard)->stream_count.load(std::memory_order_acquire);
+}
+
+UdpDataBuffer& UdpReceiver::getStreamBuffer(size_t shard, size_t stream) {
+    if (stream >= getStreamCount(shard)) {
+        throw std::out_of_range("UDP stream index out of range");
+    }
+    return shards_[shard]->streams[stream]->data_buffer;
+}
+
+const std::string& UdpReceiver::getStreamLabel(size_t shard, size_t stream) const {
+    if (stream >= getStreamCount(shard)) {
+        throw std::out_of_range("UDP stream index out of range");
+    }
+    return shards_[shard]->streams[stream]->label;
+}
+
+std::vector<UdpStreamStats> UdpReceiver::getStreamStats() const {
+    std::vector<UdpStreamStats> result;
+    for (size_t index = 0; index < shards_.size(); ++index) {
+        const Shard& shard = *shards_[index];
+        const size_t stream_count = shard.stream_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < stream_count; ++i) {
+            const Stream& stream = *shard.streams[i];
+            UdpStreamStats stats;
+            stats.shard = index;
+            stats.label = stream.label;
+            stats.key = stream.key;
+            stats.datagrams = stream.datagrams.load(std::memory_order_relaxed);
+            stats.bytes = stream.bytes.load(std::memory_order_relaxed);
+            const UdpDataBuffer::OverflowStats overflow = stream.data_buffer.getOverflowStats();
+            stats.dropped_datagrams = overflow.dropped_datagrams;
+            stats.dropped_bytes = overflow.dropped_bytes;
+            result.push_back(stats);
+        }
+    }
+    return result;
+}
+
+bool UdpReceiver::isSequenceTrackingEnabled() const {
+    return !shards_.empty() && shards_.front()->sequence_tracker != nullptr;
+}
+
+SequenceStats UdpReceiver::getSequenceStats() const {
+    SequenceStats total;
+    for (const auto& shard : shards_) {
+        if (!shard->sequence_tracker) {
+            continue;
+        }
+        const SequenceStats stats = shard->sequence_tracker->stats();
+        total.sources += stats.sources;
+        total.received += stats.received;
+        total.gaps += stats.gaps;
+        total.missing += stats.missing;
+        total.duplicates += stats.duplicates;
+        total.reordered += stats.reordered;
+        total.restarts += stats.restarts;
+    }
+    return total;
+}
+
+std::vector<SourceSequenceStats> UdpReceiver::getSourceSequenceStats() const {
+    std::vector<SourceSequenceStats> result;
+    for (const auto& shard : shards_) {
+        if (!shard->sequence_tracker) {
+            continue;
+        }
+        const std::vector<SourceSequenceStats> sources = shard->sequence_tracker->source_stats();
+        result.insert(result.end(), sources.begin(), sources.end());
+    }
+    return result;
+}
+
+DatagramRecorderStats UdpReceiver::getRecorderStats() const {
+    return recorder_ ? recorder_->stats() : DatagramRecorderStats{};
+}
 
 }  // namespace nalu_event_collector
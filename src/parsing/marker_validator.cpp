@@ -0,0 +1,175 @@
+/**
+ * @file marker_validator.cpp
+ * @brief Implements scalar and SSE2 marker validation kernels.
+ */
+
+#include "nalu_event_collector/parsing/marker_validator.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NALU_MARKER_VALIDATOR_X86 1
+#include <immintrin.h>
+#endif
+
+namespace nalu_event_collector {
+
+namespace {
+
+// Markers are compared as little-endian 32-bit words, one per marker and slot.
+constexpr size_t kWordSize = sizeof(uint32_t);
+
+uint32_t load_word(const uint8_t* data) {
+    uint32_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+#ifdef NALU_MARKER_VALIDATOR_X86
+
+// Word-compares slots [first, slots); the vector kernels use it for their tails.
+uint64_t validate_words(const uint8_t* data,
+                        size_t first,
+                        size_t slots,
+                        size_t packet_size,
+                        uint32_t start_mask,
+                        uint32_t start_value,
+                        uint32_t stop_mask,
+                        uint32_t stop_value) {
+    uint64_t good = 0;
+    for (size_t k = first; k < slots; ++k) {
+        const uint8_t* slot = data + k * packet_size;
+        if ((load_word(slot) & start_mask) == start_value &&
+            (load_word(slot + packet_size - kWordSize) & stop_mask) == stop_value) {
+            good |= uint64_t{1} << k;
+        }
+    }
+    return good;
+}
+
+// The marker words of four slots are gathered with scalar loads and compared at once.
+__attribute__((target("sse2"))) uint64_t validate_sse2(const uint8_t* data,
+                                                       size_t slots,
+                                                       size_t packet_size,
+                                                       uint32_t start_mask,
+                                                       uint32_t start_value,
+                                                       uint32_t stop_mask,
+                                                       uint32_t stop_value) {
+    const __m128i start_masks = _mm_set1_epi32(static_cast<int>(start_mask));
+    const __m128i start_values = _mm_set1_epi32(static_cast<int>(start_value));
+    const __m128i stop_masks = _mm_set1_epi32(static_cast<int>(stop_mask));
+    const __m128i stop_values = _mm_set1_epi32(static_cast<int>(stop_value));
+    const size_t stop_offset = packet_size - kWordSize;
+
+    uint64_t good = 0;
+    size_t k = 0;
+    for (; k + 4 <= slots; k += 4) {
+        const uint8_t* slot = data + k * packet_size;
+        const __m128i starts =
+            _mm_setr_epi32(static_cast<int>(load_word(slot)),
+                           static_cast<int>(load_word(slot + packet_size)),
+                           static_cast<int>(load_word(slot + 2 * packet_size)),
+                           static_cast<int>(load_word(slot + 3 * packet_size)));
+        slot += stop_offset;
+        const __m128i stops =
+            _mm_setr_epi32(static_cast<int>(load_word(slot)),
+                           static_cast<int>(load_word(slot + packet_size)),
+                           static_cast<int>(load_word(slot + 2 * packet_size)),
+                           static_cast<int>(load_word(slot + 3 * packet_size)));
+        const __m128i matches =
+            _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(starts, start_masks), start_values),
+                          _mm_cmpeq_epi32(_mm_and_si128(stops, stop_masks), stop_values));
+        good |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(matches))) << k;
+    }
+    return good | validate_words(
+                      data, k, slots, packet_size, start_mask, start_value, stop_mask, stop_value);
+}
+
+#endif  // NALU_MARKER_VALIDATOR_X86
+
+bool matches(const uint8_t* data, const std::vector<uint8_t>& marker) {
+    return std::equal(marker.begin(), marker.end(), data);
+}
+
+}  // namespace
+
+MarkerValidator::MarkerValidator(size_t packet_size,
+                                 const std::vector<uint8_t>& start_marker,
+                                 const std::vector<uint8_t>& stop_marker,
+                                 Isa max_isa)
+    : packet_size_(packet_size), start_marker_(start_marker), stop_marker_(stop_marker) {
+    const bool fits_words = packet_size_ >= kWordSize && start_marker_.size() <= kWordSize &&
+                            stop_marker_.size() <= kWordSize;
+    if (!fits_words) {
+        return;
+    }
+
+    // The start marker fills the low bytes of the slot's first word and the
+    // stop marker the high bytes of its last word.
+    for (size_t j = 0; j < start_marker_.size(); ++j) {
+        start_mask_ |= 0xFFu << (8 * j);
+        start_value_ |= static_cast<uint32_t>(start_marker_[j]) << (8 * j);
+    }
+    const size_t stop_shift = kWordSize - stop_marker_.size();
+    for (size_t j = 0; j < stop_marker_.size(); ++j) {
+        stop_mask_ |= 0xFFu << (8 * (stop_shift + j));
+        stop_value_ |= static_cast<uint32_t>(stop_marker_[j]) << (8 * (stop_shift + j));
+    }
+    isa_ = std::min(max_isa, detect_isa());
+}
+
+uint64_t MarkerValidator::validate(const uint8_t* data, size_t slots) const {
+    slots = std::min(slots, kMaxSlots);
+    switch (isa_) {
+#ifdef NALU_MARKER_VALIDATOR_X86
+        case Isa::Sse2:
+            return validate_sse2(data,
+                                 slots,
+                                 packet_size_,
+                                 start_mask_,
+                                 start_value_,
+                                 stop_mask_,
+                                 stop_value_);
+#endif
+        default:
+            break;
+    }
+
+    uint64_t good = 0;
+    const size_t stop_offset = packet_size_ - std::min(packet_size_, stop_marker_.size());
+    for (size_t k = 0; k < slots; ++k) {
+        const uint8_t* slot = data + k * packet_size_;
+        if (matches(slot + stop_offset, stop_marker_) && matches(slot, start_marker_)) {
+            good |= uint64_t{1} << k;
+        }
+    }
+    return good;
+}
+
+MarkerValidator::Isa MarkerValidator::detect_isa() {
+#ifdef NALU_MARKER_VALIDATOR_X86
+    static const Isa detected = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse2")) {
+            return Isa::Sse2;
+        }
+        return Isa::Scalar;
+    }();
+    return detected;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+const char* MarkerValidator::isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Sse2:
+            return "sse2";
+        case Isa::Scalar:
+        default:
+            return "scalar";
+    }
+}
+
+}  // namespace nalu_event_collector
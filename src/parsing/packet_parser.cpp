@@ -5,6 +5,7 @@
 
 #include "nalu_event_collector/parsing/packet_parser.h"
 
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 
@@ -12,6 +13,16 @@
 
 namespace nalu_event_collector {
 
+namespace {
+
+// Datagrams in a batch: one per mark, plus the bytes after the last mark if any.
+size_t datagram_count(const ArrivalMark* marks, size_t mark_count, size_t total) {
+    const bool tail = mark_count == 0 ? total > 0 : marks[mark_count - 1].end_offset < total;
+    return mark_count + (tail ? 1 : 0);
+}
+
+}  // namespace
+
 PacketParser::PacketParser(size_t packet_size,
                            const std::vector<uint8_t>& start_marker,
                            const std::vector<uint8_t>& stop_marker,
@@ -24,7 +35,11 @@ PacketParser::PacketParser(size_t packet_size,
                            uint8_t timing_shift,
                            bool check_packet_integrity,
                            uint16_t constructed_packet_header,
-                           uint16_t constructed_packet_footer)
+                           uint16_t constructed_packet_footer,
+                           size_t resync_confirm_packets,
+                           const std::string& decoder,
+                           size_t parse_threads,
+                           size_t parallel_min_bytes)
     : packet_size_(packet_size),
       chan_mask_(chan_mask),
       chan_shift_(chan_shift),
@@ -36,9 +51,17 @@ PacketParser::PacketParser(size_t packet_size,
       check_packet_integrity_(check_packet_integrity),
       start_marker_(start_marker),
       stop_marker_(stop_marker),
+      marker_validator_(packet_size_, start_marker_, stop_marker_),
       constructed_packet_header_(constructed_packet_header),
-      constructed_packet_footer_(constructed_packet_footer) {
+      constructed_packet_footer_(constructed_packet_footer),
+      resync_confirm_packets_(resync_confirm_packets),
+      specialize_(parse_decoder(decoder)),
+      parallel_min_bytes_(parallel_min_bytes) {
     leftovers_.reserve(packet_size_);
+    select_decoder();
+    if (parse_threads > 1) {
+        parse_pool_ = std::make_shared<ParseWorkerPool>(parse_threads);
+    }
 }
 
 PacketParser::PacketParser(const PacketParserConfig& config)
@@ -54,32 +77,77 @@ PacketParser::PacketParser(const PacketParserConfig& config)
                    config.timing_shift,
                    config.check_packet_integrity,
                    config.constructed_packet_header,
-                   config.constructed_packet_footer) {}
+                   config.constructed_packet_footer,
+                   config.resync_confirm_packets,
+                   config.decoder,
+                   config.parse_threads,
+                   config.parallel_min_bytes) {}
 
 size_t PacketParser::get_packet_size() const { return packet_size_; }
-void PacketParser::set_packet_size(size_t packet_size) { packet_size_ = packet_size; }
+void PacketParser::set_packet_size(size_t packet_size) {
+    packet_size_ = packet_size;
+    leftovers_.reserve(packet_size_);
+    marker_validator_ = MarkerValidator(packet_size_, start_marker_, stop_marker_);
+    select_decoder();
+}
 uint8_t PacketParser::get_chan_mask() const { return chan_mask_; }
-void PacketParser::set_chan_mask(uint8_t chan_mask) { chan_mask_ = chan_mask; }
+void PacketParser::set_chan_mask(uint8_t chan_mask) {
+    chan_mask_ = chan_mask;
+    select_decoder();
+}
 uint8_t PacketParser::get_chan_shift() const { return chan_shift_; }
-void PacketParser::set_chan_shift(uint8_t chan_shift) { chan_shift_ = chan_shift; }
+void PacketParser::set_chan_shift(uint8_t chan_shift) {
+    chan_shift_ = chan_shift;
+    select_decoder();
+}
 uint8_t PacketParser::get_abs_wind_mask() const { return abs_wind_mask_; }
-void PacketParser::set_abs_wind_mask(uint8_t abs_wind_mask) { abs_wind_mask_ = abs_wind_mask; }
+void PacketParser::set_abs_wind_mask(uint8_t abs_wind_mask) {
+    abs_wind_mask_ = abs_wind_mask;
+    select_decoder();
+}
 uint8_t PacketParser::get_evt_wind_mask() const { return evt_wind_mask_; }
-void PacketParser::set_evt_wind_mask(uint8_t evt_wind_mask) { evt_wind_mask_ = evt_wind_mask; }
+void PacketParser::set_evt_wind_mask(uint8_t evt_wind_mask) {
+    evt_wind_mask_ = evt_wind_mask;
+    select_decoder();
+}
 uint8_t PacketParser::get_evt_wind_shift() const { return evt_wind_shift_; }
-void PacketParser::set_evt_wind_shift(uint8_t evt_wind_shift) { evt_wind_shift_ = evt_wind_shift; }
+void PacketParser::set_evt_wind_shift(uint8_t evt_wind_shift) {
+    evt_wind_shift_ = evt_wind_shift;
+    select_decoder();
+}
 uint16_t PacketParser::get_timing_mask() const { return timing_mask_; }
-void PacketParser::set_timing_mask(uint16_t timing_mask) { timing_mask_ = timing_mask; }
+void PacketParser::set_timing_mask(uint16_t timing_mask) {
+    timing_mask_ = timing_mask;
+    select_decoder();
+}
 uint8_t PacketParser::get_timing_shift() const { return timing_shift_; }
-void PacketParser::set_timing_shift(uint8_t timing_shift) { timing_shift_ = timing_shift; }
+void PacketParser::set_timing_shift(uint8_t timing_shift) {
+    timing_shift_ = timing_shift;
+    select_decoder();
+}
 std::vector<uint8_t> PacketParser::get_start_marker() const { return start_marker_; }
-void PacketParser::set_start_marker(const std::vector<uint8_t>& start_marker) { start_marker_ = start_marker; }
+void PacketParser::set_start_marker(const std::vector<uint8_t>& start_marker) {
+    start_marker_ = start_marker;
+    marker_validator_ = MarkerValidator(packet_size_, start_marker_, stop_marker_);
+    select_decoder();
+}
 std::vector<uint8_t> PacketParser::get_stop_marker() const { return stop_marker_; }
-void PacketParser::set_stop_marker(const std::vector<uint8_t>& stop_marker) { stop_marker_ = stop_marker; }
+void PacketParser::set_stop_marker(const std::vector<uint8_t>& stop_marker) {
+    stop_marker_ = stop_marker;
+    marker_validator_ = MarkerValidator(packet_size_, start_marker_, stop_marker_);
+    select_decoder();
+}
 
 std::vector<Packet> PacketParser::process_stream(const std::vector<uint8_t>& byte_stream) {
     std::vector<Packet> packets;
-    const uint8_t* data_ptr = byte_stream.data();
+    process_stream(byte_stream.data(), byte_stream.size(), packets);
+    return packets;
+}
+
+size_t PacketParser::process_stream(const uint8_t* data_ptr,
+                                    size_t size,
+                                    std::vector<Packet>& packets) {
+    const size_t first_packet = packets.size();
     uint8_t error_code = 0;
     const size_t stop_marker_len = stop_marker_.size();
     const size_t start_marker_len = start_marker_.size();
@@ -87,40 +155,166 @@ std::vector<Packet> PacketParser::process_stream(const std::vector<uint8_t>& byt
     size_t i = 0;
 
     if (leftovers_size > 0) {
+        if (leftovers_size + size < packet_size_) {
+            // Still not a whole packet; keep accumulating.
+            leftovers_.insert(leftovers_.end(), data_ptr, data_ptr + size);
+            return 0;
+        }
         process_leftovers(packets,
                           data_ptr,
-                          byte_stream.size(),
                           leftovers_size,
                           packet_size_,
                           start_marker_len,
                           stop_marker_len);
         i = packet_size_ - leftovers_size;
+        stamp_arrivals(packets, i);
     }
 
     const size_t initial_packets = packets.size();
-    while (i + packet_size_ <= byte_stream.size()) {
+    while (!chunk_parser_ && i + packet_size_ <= size) {
         process_byte_stream_segment_with_checks(
-            packets, data_ptr, i, error_code, start_marker_len, stop_marker_len);
+            packets, data_ptr, size, i, error_code, start_marker_len, stop_marker_len);
+        stamp_arrivals(packets, i);
         if (packets.size() > initial_packets) {
             break;
         }
     }
 
-    auto process_segment = check_packet_integrity_
-                               ? &PacketParser::process_byte_stream_segment_with_checks
-                               : &PacketParser::process_byte_stream_segment_without_checks;
-
-    while (i + packet_size_ <= byte_stream.size()) {
-        (this->*process_segment)(
-            packets, data_ptr, i, error_code, start_marker_len, stop_marker_len);
+    if (parse_pool_ && arrivals_ == nullptr && i < size && size - i >= parallel_min_bytes_) {
+        process_parallel(packets, data_ptr, size, i, error_code);
+    }
+    if (check_packet_integrity_) {
+        process_validated_segments(
+            packets, data_ptr, size, i, error_code, start_marker_len, stop_marker_len);
+    }
+    if (i + packet_size_ <= size) {
+        decode_run(packets, data_ptr, i, (size - i) / packet_size_, 0);
     }
 
     leftovers_.clear();
-    if (i < byte_stream.size()) {
-        leftovers_.assign(byte_stream.begin() + i, byte_stream.end());
+    if (i < size) {
+        leftovers_.assign(data_ptr + i, data_ptr + size);
     }
+    return packets.size() - first_packet;
+}
 
-    return packets;
+size_t PacketParser::process_stream(const uint8_t* first,
+                                    size_t first_size,
+                                    const uint8_t* second,
+                                    size_t second_size,
+                                    std::vector<Packet>& packets) {
+    size_t appended = process_stream(first, first_size, packets);
+    if (second_size > 0) {
+        appended += process_stream(second, second_size, packets);
+    }
+    return appended;
+}
+
+size_t PacketParser::process_stream(const uint8_t* data,
+                                    size_t size,
+                                    const ArrivalMark* marks,
+                                    size_t mark_count,
+                                    std::vector<Packet>& packets,
+                                    std::vector<uint64_t>& arrivals) {
+    return process_stream(data, size, nullptr, 0, marks, mark_count, packets, arrivals);
+}
+
+size_t PacketParser::process_stream(const uint8_t* first,
+                                    size_t first_size,
+                                    const uint8_t* second,
+                                    size_t second_size,
+                                    const ArrivalMark* marks,
+                                    size_t mark_count,
+                                    std::vector<Packet>& packets,
+                                    std::vector<uint64_t>& arrivals) {
+    arrivals.resize(packets.size(), 0);
+    arrival_marks_ = marks;
+    arrival_mark_count_ = mark_count;
+    arrival_cursor_ = 0;
+    arrival_base_ = 0;
+    arrivals_ = &arrivals;
+    size_t appended = process_stream(first, first_size, packets);
+    if (second_size > 0) {
+        // Offsets within the second span continue where the first one ended.
+        arrival_base_ = first_size;
+        appended += process_stream(second, second_size, packets);
+    }
+    arrivals_ = nullptr;
+    arrival_marks_ = nullptr;
+    arrival_mark_count_ = 0;
+    arrival_base_ = 0;
+    return appended;
+}
+
+size_t PacketParser::process_datagrams(const uint8_t* first,
+                                       size_t first_size,
+                                       const uint8_t* second,
+                                       size_t second_size,
+                                       const ArrivalMark* marks,
+                                       size_t mark_count,
+                                       std::vector<Packet>& packets) {
+    const size_t first_packet = packets.size();
+    const size_t total = first_size + second_size;
+    if (parse_pool_ && total >= parallel_min_bytes_ && mark_count > 0 &&
+        process_datagrams_parallel(
+            packets, first, first_size, second, second_size, marks, mark_count)) {
+        return packets.size() - first_packet;
+    }
+    const size_t datagrams = datagram_count(marks, mark_count, total);
+    process_datagram_range(packets,
+                           first,
+                           first_size,
+                           second,
+                           second_size,
+                           marks,
+                           0,
+                           datagrams,
+                           mark_count,
+                           nullptr);
+    return packets.size() - first_packet;
+}
+
+size_t PacketParser::process_datagrams(const uint8_t* first,
+                                       size_t first_size,
+                                       const uint8_t* second,
+                                       size_t second_size,
+                                       const ArrivalMark* marks,
+                                       size_t mark_count,
+                                       std::vector<Packet>& packets,
+                                       std::vector<uint64_t>& arrivals) {
+    const size_t first_packet = packets.size();
+    const size_t total = first_size + second_size;
+    arrivals.resize(first_packet, 0);
+    const size_t datagrams = datagram_count(marks, mark_count, total);
+    process_datagram_range(packets,
+                           first,
+                           first_size,
+                           second,
+                           second_size,
+                           marks,
+                           0,
+                           datagrams,
+                           mark_count,
+                           &arrivals);
+    return packets.size() - first_packet;
+}
+
+void PacketParser::stamp_arrivals(const std::vector<Packet>& packets, size_t end_offset) {
+    if (chunk_parser_) {
+        packet_ends_.resize(packets.size(), PacketEnd{end_offset, stats_.resync_events});
+        return;
+    }
+    if (arrivals_ == nullptr || arrivals_->size() == packets.size()) {
+        return;
+    }
+    // A packet arrived with the datagram that carried its last byte.
+    while (arrival_cursor_ < arrival_mark_count_ &&
+           arrival_marks_[arrival_cursor_].end_offset < arrival_base_ + end_offset) {
+        ++arrival_cursor_;
+    }
+    const uint64_t arrival =
+        arrival_cursor_ < arrival_mark_count_ ? arrival_marks_[arrival_cursor_].arrival_ns : 0;
+    arrivals_->resize(packets.size(), arrival);
 }
 
 void PacketParser::process_packet(std::vector<Packet>& packets,
@@ -166,8 +360,57 @@ bool PacketParser::check_marker(const uint8_t* byte_stream,
     return true;
 }
 
+size_t PacketParser::find_resync_point(const uint8_t* byte_stream,
+                                       size_t from,
+                                       size_t size) const {
+    const size_t stop_marker_len = stop_marker_.size();
+    const size_t last_start = size - packet_size_;
+    if (start_marker_.empty()) {
+        // Nothing to search for; let the caller slide as far as whole packets reach.
+        return std::min(from, last_start + 1);
+    }
+
+    const uint8_t first_byte = start_marker_.front();
+    size_t candidate = from;
+    while (candidate <= last_start) {
+        const auto* hit = static_cast<const uint8_t*>(
+            std::memchr(byte_stream + candidate, first_byte, last_start + 1 - candidate));
+        if (hit == nullptr) {
+            break;
+        }
+        candidate = static_cast<size_t>(hit - byte_stream);
+
+        bool confirmed =
+            std::equal(start_marker_.begin(), start_marker_.end(), byte_stream + candidate);
+        // Stop markers must recur at packet strides for every buffered packet checked.
+        for (size_t n = 1; confirmed && n <= resync_confirm_packets_ + 1; ++n) {
+            const size_t end = candidate + n * packet_size_;
+            if (end > size) {
+                break;
+            }
+            confirmed = std::equal(
+                stop_marker_.begin(), stop_marker_.end(), byte_stream + end - stop_marker_len);
+        }
+        if (confirmed) {
+            return candidate;
+        }
+        ++candidate;
+    }
+
+    // No whole packet starts before the end; keep the bytes from the first
+    // possible start onward as leftovers for the next call.
+    const size_t tail = last_start + 1;
+    if (tail >= size) {
+        return size;
+    }
+    const auto* hit =
+        static_cast<const uint8_t*>(std::memchr(byte_stream + tail, first_byte, size - tail));
+    return hit != nullptr ? static_cast<size_t>(hit - byte_stream) : size;
+}
+
 void PacketParser::process_byte_stream_segment_with_checks(std::vector<Packet>& packets,
                                                            const uint8_t* byte_stream,
+                                                           size_t size,
                                                            size_t& i,
                                                            uint8_t& error_code,
                                                            size_t start_marker_len,
@@ -190,23 +433,127 @@ void PacketParser::process_byte_stream_segment_with_checks(std::vector<Packet>&
         }
     } else {
         error_code |= 0b01;
-        ++i;
+        const size_t resync_point = find_resync_point(byte_stream, i + 1, size);
+        ++stats_.resync_events;
+        stats_.resync_skipped_bytes += resync_point - i;
+        spdlog::debug("Stop marker not found; skipped {} bytes to resynchronize",
+                      resync_point - i);
+        i = resync_point;
+    }
+}
+
+void PacketParser::process_validated_segments(std::vector<Packet>& packets,
+                                              const uint8_t* byte_stream,
+                                              size_t size,
+                                              size_t& i,
+                                              uint8_t& error_code,
+                                              size_t start_marker_len,
+                                              size_t stop_marker_len) {
+    while (i + packet_size_ <= size) {
+        const size_t slots = std::min((size - i) / packet_size_, MarkerValidator::kMaxSlots);
+        const uint64_t good = marker_validator_.validate(byte_stream + i, slots);
+
+        // Decode the leading run of slots whose markers are both in place.
+        size_t run = 0;
+        while (run < slots && ((good >> run) & 1) != 0) {
+            ++run;
+        }
+        if (run > 0) {
+            decode_run(packets, byte_stream, i, run, error_code);
+            error_code = 0;
+        }
+        if (run == slots) {
+            continue;
+        }
+
+        // The next slot is damaged or misaligned: check it alone, resynchronizing
+        // if needed, until a packet is consumed, then validate in bulk again.
+        const size_t decoded = packets.size();
+        while (packets.size() == decoded && i + packet_size_ <= size) {
+            process_byte_stream_segment_with_checks(
+                packets, byte_stream, size, i, error_code, start_marker_len, stop_marker_len);
+            stamp_arrivals(packets, i);
+        }
+    }
+}
+
+template <typename Layout>
+void PacketParser::decode_run_as(std::vector<Packet>& packets,
+                                 const uint8_t* byte_stream,
+                                 size_t& i,
+                                 size_t count,
+                                 uint8_t error_code) {
+    for (size_t k = 0; k < count; ++k) {
+        Packet& packet = packets.emplace_back();
+        packet.info = error_code;
+        packet.header = constructed_packet_header_;
+        packet.parser_index = packet_index_++;
+        packet_index_ %= UINT16_MAX;
+        decode_fields<Layout>(byte_stream + i, packet);
+        packet.footer = constructed_packet_footer_;
+        error_code = 0;
+        i += Layout::packet_size;
+        stamp_arrivals(packets, i);
+    }
+}
+
+void PacketParser::decode_run(std::vector<Packet>& packets,
+                              const uint8_t* byte_stream,
+                              size_t& i,
+                              size_t count,
+                              uint8_t error_code) {
+    // Grow geometrically: validated runs are short, and an exact reserve per
+    // run would reallocate on every one of them.
+    if (packets.capacity() < packets.size() + count) {
+        packets.reserve(std::max(packets.size() + count, 2 * packets.capacity()));
+    }
+    switch (decoder_) {
+        case Decoder::Nalu74:
+            decode_run_as<Nalu74Layout>(packets, byte_stream, i, count, error_code);
+            return;
+        case Decoder::Generic:
+        default:
+            break;
+    }
+    for (size_t k = 0; k < count; ++k) {
+        process_packet(packets, byte_stream, i, error_code);
+        error_code = 0;
+        i += packet_size_;
+        stamp_arrivals(packets, i);
+    }
+}
+
+bool PacketParser::parse_decoder(const std::string& decoder) {
+    if (decoder == "auto") {
+        return true;
     }
+    if (decoder == "generic") {
+        return false;
+    }
+    throw std::invalid_argument("Invalid packet parser decoder: " + decoder +
+                                " (expected auto or generic)");
 }
 
-void PacketParser::process_byte_stream_segment_without_checks(std::vector<Packet>& packets,
-                                                              const uint8_t* byte_stream,
-                                                              size_t& i,
-                                                              uint8_t&,
-                                                              size_t,
-                                                              size_t) {
-    process_packet(packets, byte_stream, i, 0);
-    i += packet_size_;
+void PacketParser::select_decoder() {
+    // Chunk parsers copy the layout, so rebuild them on the next parallel parse.
+    chunk_parsers_.clear();
+    decoder_ = Decoder::Generic;
+    if (specialize_ && matches_layout<Nalu74Layout>(packet_size_,
+                                                    start_marker_,
+                                                    stop_marker_,
+                                                    chan_mask_,
+                                                    chan_shift_,
+                                                    abs_wind_mask_,
+                                                    evt_wind_mask_,
+                                                    evt_wind_shift_,
+                                                    timing_mask_,
+                                                    timing_shift_)) {
+        decoder_ = Decoder::Nalu74;
+    }
 }
 
 void PacketParser::process_leftovers(std::vector<Packet>& data_list,
                                      const uint8_t* byte_stream,
-                                     size_t byte_stream_len,
                                      size_t leftovers_size,
                                      size_t packet_size,
                                      size_t start_marker_len,
@@ -226,12 +573,321 @@ void PacketParser::process_leftovers(std::vector<Packet>& data_list,
     }
 
     const size_t end_marker_position = packet_size - stop_marker_len;
-    if (end_marker_position <= byte_stream_len &&
-        check_marker(combined_ptr, end_marker_position, stop_marker_.data(), stop_marker_len)) {
+    if (check_marker(combined_ptr, end_marker_position, stop_marker_.data(), stop_marker_len)) {
         process_packet(data_list, combined_ptr, 0, 0);
     }
 }
 
+size_t PacketParser::find_chunk_start(const uint8_t* byte_stream,
+                                      size_t aligned_from,
+                                      size_t target,
+                                      size_t size) const {
+    // Prefer the packet boundary the serial parse would reach if the stream
+    // stayed aligned; otherwise resynchronize from the target offset.
+    const size_t strides = (target - aligned_from + packet_size_ - 1) / packet_size_;
+    const size_t aligned = aligned_from + strides * packet_size_;
+    if (!check_packet_integrity_) {
+        return std::min(aligned, size);
+    }
+    if (aligned + packet_size_ <= size &&
+        marker_validator_.validate(byte_stream + aligned, 1) != 0) {
+        return aligned;
+    }
+    return find_resync_point(byte_stream, target, size);
+}
+
+void PacketParser::process_parallel(std::vector<Packet>& packets,
+                                    const uint8_t* byte_stream,
+                                    size_t size,
+                                    size_t& i,
+                                    uint8_t& error_code) {
+    const size_t chunks =
+        std::min(parse_pool_->size(), (size - i) / (packet_size_ * MarkerValidator::kMaxSlots));
+    if (chunks < 2) {
+        return;
+    }
+    prepare_chunk_parsers(chunks);
+
+    // Cut at evenly spaced targets, each moved forward to a packet boundary.
+    const size_t chunk_size = (size - i) / chunks;
+    chunk_bounds_.assign(1, i);
+    for (size_t k = 1; k < chunks; ++k) {
+        const size_t target = i + k * chunk_size;
+        chunk_bounds_.push_back(
+            std::max(chunk_bounds_.back(), find_chunk_start(byte_stream, i, target, size)));
+    }
+    chunk_bounds_.push_back(size);
+
+    // Capture little enough for std::function to store the task without allocating.
+    parse_pool_->run(chunks, [this, byte_stream](size_t k) {
+        PacketParser& parser = chunk_parsers_[k];
+        parser.stats_ = PacketParserStats{};
+        parser.packet_ends_.clear();
+        chunk_packets_[k].clear();
+        parser.process_stream(byte_stream + chunk_bounds_[k],
+                              chunk_bounds_[k + 1] - chunk_bounds_[k],
+                              chunk_packets_[k]);
+    });
+
+    size_t total = 0;
+    for (const auto& chunk : chunk_packets_) {
+        total += chunk.size();
+    }
+    packets.reserve(packets.size() + total);
+    if (check_packet_integrity_) {
+        stitch_chunks(packets, byte_stream, size, i, error_code);
+        return;
+    }
+
+    // Unchecked chunks start on packet strides from i and decode every slot,
+    // exactly as the serial decode_run() would, so they simply concatenate.
+    for (size_t k = 0; k < chunks; ++k) {
+        merge_chunk(packets, k);
+    }
+    i = size - chunk_parsers_.back().leftovers_.size();
+    chunk_parsers_.back().leftovers_.clear();
+}
+
+void PacketParser::stitch_chunks(std::vector<Packet>& packets,
+                                 const uint8_t* byte_stream,
+                                 size_t size,
+                                 size_t& i,
+                                 uint8_t& error_code) {
+    const size_t start_marker_len = start_marker_.size();
+    const size_t stop_marker_len = stop_marker_.size();
+    // A chunk parser cannot look past its end, so only packets that end this far
+    // before it were decided as the serial parse decides them.
+    const size_t lookahead = (resync_confirm_packets_ + 2) * packet_size_;
+    const size_t chunks = chunk_parsers_.size();
+
+    for (size_t k = 0; k < chunks; ++k) {
+        PacketParser& parser = chunk_parsers_[k];
+        parser.leftovers_.clear();
+        const size_t base = chunk_bounds_[k];
+        const std::vector<PacketEnd>& ends = parser.packet_ends_;
+        const size_t reliable_end =
+            k + 1 < chunks ? std::max(chunk_bounds_[k + 1], base + lookahead) - lookahead : size;
+        const size_t reliable = static_cast<size_t>(
+            std::upper_bound(ends.begin(),
+                             ends.end(),
+                             reliable_end,
+                             [base](size_t limit, const PacketEnd& end) {
+                                 return limit < base + end.end_offset;
+                             }) -
+            ends.begin());
+
+        // Continue the serial parse until it reaches a packet the chunk decoded
+        // from a clean start marker; from there both parses agree.
+        size_t join = reliable;
+        while (i + packet_size_ <= size) {
+            const auto next = std::lower_bound(
+                ends.begin(),
+                ends.begin() + reliable,
+                i + packet_size_,
+                [base](const PacketEnd& end, size_t offset) {
+                    return base + end.end_offset < offset;
+                });
+            if (next == ends.begin() + reliable) {
+                break;
+            }
+            if (base + next->end_offset == i + packet_size_ &&
+                check_marker(byte_stream, i, start_marker_.data(), start_marker_len)) {
+                join = static_cast<size_t>(next - ends.begin());
+                break;
+            }
+            process_byte_stream_segment_with_checks(
+                packets, byte_stream, size, i, error_code, start_marker_len, stop_marker_len);
+        }
+        if (join == reliable) {
+            continue;
+        }
+
+        chunk_packets_[k][join].info = error_code;
+        const size_t last = reliable - 1;
+        stats_.resync_events += ends[last].resync_events - ends[join].resync_events;
+        stats_.resync_skipped_bytes +=
+            ends[last].end_offset - ends[join].end_offset - (last - join) * packet_size_;
+        append_chunk_packets(packets, k, join, reliable);
+
+        // Resume after the last kept packet; a bad start marker stays flagged.
+        i = base + ends[last].end_offset;
+        const bool clean_start = check_marker(
+            byte_stream, i - packet_size_, start_marker_.data(), start_marker_len);
+        error_code = clean_start ? 0 : packets.back().info;
+    }
+
+    while (i + packet_size_ <= size) {
+        process_byte_stream_segment_with_checks(
+            packets, byte_stream, size, i, error_code, start_marker_len, stop_marker_len);
+    }
+}
+
+void PacketParser::prepare_chunk_parsers(size_t chunks) {
+    if (chunk_parsers_.size() == chunks) {
+        return;
+    }
+    PacketParser chunk_parser(*this);
+    chunk_parser.chunk_parser_ = true;
+    chunk_parser.parse_pool_.reset();
+    chunk_parser.chunk_parsers_.clear();
+    chunk_parser.chunk_packets_.clear();
+    chunk_parser.leftovers_.clear();
+    chunk_parsers_.assign(chunks, chunk_parser);
+    chunk_packets_.resize(chunks);
+}
+
+void PacketParser::merge_chunk(std::vector<Packet>& packets, size_t k) {
+    const PacketParser& parser = chunk_parsers_[k];
+    stats_.resync_events += parser.stats_.resync_events;
+    stats_.resync_skipped_bytes += parser.stats_.resync_skipped_bytes;
+    append_chunk_packets(packets, k, 0, chunk_packets_[k].size());
+}
+
+void PacketParser::append_chunk_packets(std::vector<Packet>& packets,
+                                        size_t k,
+                                        size_t begin,
+                                        size_t end) {
+    for (size_t n = begin; n < end; ++n) {
+        chunk_packets_[k][n].parser_index = packet_index_++;
+        packet_index_ %= UINT16_MAX;
+    }
+    packets.insert(packets.end(),
+                   chunk_packets_[k].begin() + static_cast<std::ptrdiff_t>(begin),
+                   chunk_packets_[k].begin() + static_cast<std::ptrdiff_t>(end));
+}
+
+void PacketParser::process_datagram(std::vector<Packet>& packets,
+                                    const uint8_t* data,
+                                    size_t size) {
+    const size_t start_marker_len = start_marker_.size();
+    const size_t stop_marker_len = stop_marker_.size();
+    uint8_t error_code = 0;
+    size_t i = 0;
+
+    // Check the first packet, as process_stream() does at the start of every batch.
+    const size_t initial_packets = packets.size();
+    while (i + packet_size_ <= size) {
+        process_byte_stream_segment_with_checks(
+            packets, data, size, i, error_code, start_marker_len, stop_marker_len);
+        if (packets.size() > initial_packets) {
+            break;
+        }
+    }
+
+    if (check_packet_integrity_) {
+        process_validated_segments(
+            packets, data, size, i, error_code, start_marker_len, stop_marker_len);
+    }
+    if (i + packet_size_ <= size) {
+        decode_run(packets, data, i, (size - i) / packet_size_, 0);
+    }
+
+    // Nothing follows a datagram's tail, so bytes short of a packet are lost.
+    stats_.resync_skipped_bytes += size - i;
+}
+
+void PacketParser::process_datagram_range(std::vector<Packet>& packets,
+                                          const uint8_t* first,
+                                          size_t first_size,
+                                          const uint8_t* second,
+                                          size_t second_size,
+                                          const ArrivalMark* marks,
+                                          size_t begin_datagram,
+                                          size_t end_datagram,
+                                          size_t mark_count,
+                                          std::vector<uint64_t>* arrivals) {
+    const size_t total = first_size + second_size;
+    for (size_t d = begin_datagram; d < end_datagram; ++d) {
+        const size_t begin = d == 0 ? 0 : marks[d - 1].end_offset;
+        const size_t end = d < mark_count ? std::min(marks[d].end_offset, total) : total;
+        if (end <= begin) {
+            continue;
+        }
+
+        const uint8_t* data = nullptr;
+        if (end <= first_size) {
+            data = first + begin;
+        } else if (begin >= first_size) {
+            data = second + (begin - first_size);
+        } else {
+            // The datagram wraps around the end of the ring; join its halves.
+            datagram_scratch_.assign(first + begin, first + first_size);
+            datagram_scratch_.insert(datagram_scratch_.end(), second, second + end - first_size);
+            data = datagram_scratch_.data();
+        }
+        process_datagram(packets, data, end - begin);
+        if (arrivals != nullptr) {
+            arrivals->resize(packets.size(), d < mark_count ? marks[d].arrival_ns : 0);
+        }
+    }
+}
+
+bool PacketParser::process_datagrams_parallel(std::vector<Packet>& packets,
+                                              const uint8_t* first,
+                                              size_t first_size,
+                                              const uint8_t* second,
+                                              size_t second_size,
+                                              const ArrivalMark* marks,
+                                              size_t mark_count) {
+    const size_t total = first_size + second_size;
+    const size_t chunks =
+        std::min(parse_pool_->size(), total / (packet_size_ * MarkerValidator::kMaxSlots));
+    if (chunks < 2 || mark_count < chunks) {
+        return false;
+    }
+    prepare_chunk_parsers(chunks);
+
+    // Give every chunk a run of whole datagrams of roughly equal byte size;
+    // the last chunk also takes any bytes after the final mark.
+    const size_t datagrams = datagram_count(marks, mark_count, total);
+    chunk_bounds_.assign(1, 0);
+    size_t d = 0;
+    for (size_t k = 1; k < chunks; ++k) {
+        const size_t target = k * (total / chunks);
+        while (d < mark_count && marks[d].end_offset < target) {
+            ++d;
+        }
+        chunk_bounds_.push_back(std::max(chunk_bounds_.back(), std::min(d + 1, mark_count)));
+    }
+    chunk_bounds_.push_back(datagrams);
+
+    // Capture the batch by reference so std::function stores the task without allocating.
+    const struct {
+        const uint8_t* first;
+        size_t first_size;
+        const uint8_t* second;
+        size_t second_size;
+        const ArrivalMark* marks;
+        size_t mark_count;
+    } batch{first, first_size, second, second_size, marks, mark_count};
+    parse_pool_->run(chunks, [this, &batch](size_t k) {
+        PacketParser& parser = chunk_parsers_[k];
+        parser.stats_ = PacketParserStats{};
+        parser.packet_ends_.clear();
+        chunk_packets_[k].clear();
+        parser.process_datagram_range(chunk_packets_[k],
+                                      batch.first,
+                                      batch.first_size,
+                                      batch.second,
+                                      batch.second_size,
+                                      batch.marks,
+                                      chunk_bounds_[k],
+                                      chunk_bounds_[k + 1],
+                                      batch.mark_count,
+                                      nullptr);
+    });
+
+    size_t appended = 0;
+    for (const auto& chunk : chunk_packets_) {
+        appended += chunk.size();
+    }
+    packets.reserve(packets.size() + appended);
+    for (size_t k = 0; k < chunks; ++k) {
+        merge_chunk(packets, k);
+    }
+    return true;
+}
+
 std::vector<uint8_t> PacketParser::hexStringToBytes(const std::string& hex) {
     std::vector<uint8_t> bytes;
     for (size_t i = 0; i < hex.length(); i += 2) {
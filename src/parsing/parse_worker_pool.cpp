@@ -0,0 +1,88 @@
+/**
+ * @file parse_worker_pool.cpp
+ * @brief Implements the parse worker pool.
+ */
+
+#include "nalu_event_collector/parsing/parse_worker_pool.h"
+
+namespace nalu_event_collector {
+
+ParseWorkerPool::ParseWorkerPool(size_t threads) {
+    for (size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back(&ParseWorkerPool::worker_loop, this);
+    }
+}
+
+ParseWorkerPool::~ParseWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ParseWorkerPool::run(size_t tasks, const std::function<void(size_t)>& task) {
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        task_count_ = tasks;
+        next_task_.store(0, std::memory_order_relaxed);
+        busy_workers_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    work_cv_.notify_all();
+
+    run_tasks();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return busy_workers_ == 0; });
+    task_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void ParseWorkerPool::worker_loop() {
+    uint64_t seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+
+        run_tasks();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_workers_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void ParseWorkerPool::run_tasks() {
+    while (true) {
+        const size_t index = next_task_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= task_count_) {
+            return;
+        }
+        try {
+            (*task_)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
+
+}  // namespace nalu_event_collector
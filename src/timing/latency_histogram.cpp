@@ -0,0 +1,66 @@
+/**
+ * @file latency_histogram.cpp
+ * @brief Implements log-linear latency bucketing and percentile lookup.
+ */
+
+#include "nalu_event_collector/timing/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace nalu_event_collector {
+
+void LatencyHistogram::record(uint64_t latency_ns) {
+    ++buckets_[bucket_index(latency_ns)];
+    ++count_;
+    max_ = std::max(max_, latency_ns);
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const auto rank = std::max<uint64_t>(
+        static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count_))), 1);
+    uint64_t seen = 0;
+    for (size_t index = 0; index < kBucketCount; ++index) {
+        seen += buckets_[index];
+        if (seen >= rank) {
+            return std::min(bucket_upper_bound(index), max_);
+        }
+    }
+    return max_;
+}
+
+void LatencyHistogram::reset() {
+    buckets_.fill(0);
+    count_ = 0;
+    max_ = 0;
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t value) {
+    if (value < kSubBuckets) {
+        return static_cast<size_t>(value);
+    }
+    // Bucket group g >= 1 covers [2^(g+3), 2^(g+4)) split into 16 equal steps.
+    const auto top_bit = static_cast<size_t>(63 - __builtin_clzll(value));
+    const size_t group = top_bit - kSubBucketBits + 1;
+    const size_t sub_bucket =
+        static_cast<size_t>(value >> (top_bit - kSubBucketBits)) & (kSubBuckets - 1);
+    return group * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+    const size_t group = index / kSubBuckets;
+    const size_t sub_bucket = index % kSubBuckets;
+    if (group == 0) {
+        return sub_bucket;
+    }
+    const size_t shift = group - 1;
+    const uint64_t lower = static_cast<uint64_t>(kSubBuckets + sub_bucket) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+}  // namespace nalu_event_collector